@@ -15,7 +15,7 @@ envvars="PATH"
 envvars="$envvars PYTHONHOME PYTHONPATH"
 envvars="$envvars COVISE_PATH COVISEDIR ARCHSUFFIX COCONFIG COCONFIG_DEBUG"
 envvars="$envvars COVCONFIG COVCONFIG_HOST COVCONFIG_CLUSTER COVCONFIG_DEBUG COVCONFIG_IGNORE_ERRORS"
-envvars="$envvars VISTLE_KEY VISTLE_SHM_SIZE VISTLE_SHM_PER_RANK VISTLE_AFFINITY"
+envvars="$envvars VISTLE_KEY VISTLE_SHM_SIZE VISTLE_SHM_SEGMENT_SIZE VISTLE_SHM_DIRECTORY_SIZE VISTLE_SHM_DEDUP VISTLE_SHM_FIRST_TOUCH VISTLE_SHM_HUGEPAGES VISTLE_SHM_NUMA VISTLE_SHM_BUDGET VISTLE_SHM_SPILL_DIR VISTLE_COMPACT_INDICES VISTLE_SHM_PER_RANK VISTLE_AFFINITY"
 envvars="$envvars VISTLE_ROOT VISTLE_BUILDTYPE VISTLE_STARTUP_DELAY"
 envvars="$envvars VISKORES_LOG_LEVEL VISKORES_DEVICE VISKORES_DEVICE_INSTANCE VISKORES_NUM_THREADS"
 
@@ -0,0 +1,33 @@
+#include "parallel.h"
+
+#include <vistle/util/taskpool.h>
+
+#include <algorithm>
+
+namespace vistle {
+namespace parallel {
+
+namespace {
+
+// allow for some imbalance between chunks
+const Index ChunksPerThread = 4;
+
+} // namespace
+
+Index numChunks(Index n, Index grain)
+{
+    if (n == 0)
+        return 0;
+    if (grain == 0)
+        grain = 1;
+    const Index maxChunks = Index(TaskPool::the().concurrency()) * ChunksPerThread;
+    return std::min(maxChunks, (n + grain - 1) / grain);
+}
+
+void forChunks(Index nchunks, const std::function<void(Index)> &func)
+{
+    TaskPool::the().forChunks(nchunks, [&func](size_t c) { func(Index(c)); });
+}
+
+} // namespace parallel
+} // namespace vistle
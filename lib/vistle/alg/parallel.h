@@ -0,0 +1,140 @@
+#ifndef VISTLE_ALG_PARALLEL_H
+#define VISTLE_ALG_PARALLEL_H
+
+#include "export.h"
+#include <vistle/core/index.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace vistle {
+
+//! parallel algorithms for processing the elements of a single block
+/*! Work is split into chunks which are processed by the calling thread and helpers running on the task pool that
+ *  also executes block tasks (see vistle::TaskPool). If all workers of the pool are busy with other blocks, the calling
+ *  thread processes all chunks itself, so that block-level and intra-block parallelism do not oversubscribe cores.
+ *  Chunks are always delimited in the same way for the same number of elements, and results of reductions and scans
+ *  are combined in chunk order, so that results do not depend on scheduling.
+ */
+namespace parallel {
+
+//! ranges with fewer elements are processed by the calling thread only
+const Index DefaultGrain = 4096;
+
+// the number of threads used for calls from the calling thread is limited by vistle::TaskPool::ThreadLimit
+
+//! number of chunks for splitting n elements
+V_ALGEXPORT Index numChunks(Index n, Index grain = DefaultGrain);
+//! first element of chunk c out of nchunks for splitting n elements
+inline Index chunkBegin(Index n, Index nchunks, Index c)
+{
+    return Index(uint64_t(n) * c / nchunks);
+}
+
+//! call func(c) for all chunks c in [0, nchunks), rethrows first exception thrown by func
+V_ALGEXPORT void forChunks(Index nchunks, const std::function<void(Index)> &func);
+
+} // namespace parallel
+
+//! call func(begin, end) for consecutive ranges covering [0, n)
+template<class Func>
+void parallel_for_ranges(Index n, Func &&func, Index grain = parallel::DefaultGrain)
+{
+    const Index nchunks = parallel::numChunks(n, grain);
+    parallel::forChunks(nchunks, [n, nchunks, &func](Index c) {
+        func(parallel::chunkBegin(n, nchunks, c), parallel::chunkBegin(n, nchunks, c + 1));
+    });
+}
+
+//! call func(i) for all i in [0, n)
+template<class Func>
+void parallel_for(Index n, Func &&func, Index grain = parallel::DefaultGrain)
+{
+    parallel_for_ranges(
+        n,
+        [&func](Index begin, Index end) {
+            for (Index i = begin; i < end; ++i)
+                func(i);
+        },
+        grain);
+}
+
+//! combine(...combine(combine(init, map(0)), map(1))..., map(n-1)), combine has to be associative
+template<typename T, class Map, class Combine>
+T parallel_reduce(Index n, T init, Map &&map, Combine &&combine, Index grain = parallel::DefaultGrain)
+{
+    const Index nchunks = parallel::numChunks(n, grain);
+    if (nchunks == 0)
+        return init;
+    std::vector<T> partial(nchunks);
+    parallel::forChunks(nchunks, [n, nchunks, &partial, &map, &combine](Index c) {
+        const Index begin = parallel::chunkBegin(n, nchunks, c), end = parallel::chunkBegin(n, nchunks, c + 1);
+        T acc = map(begin);
+        for (Index i = begin + 1; i < end; ++i)
+            acc = combine(acc, map(i));
+        partial[c] = acc;
+    });
+    for (const auto &p: partial)
+        init = combine(init, p);
+    return init;
+}
+
+//! store sum of count(j) for j < i in offsets[i] for all i in [0, n) and return sum over all elements
+/*! offsets may have n+1 elements, then the sum over all elements is also stored in offsets[n] */
+template<typename T, class Count>
+T parallel_exclusive_scan(Index n, Count &&count, T *offsets, bool storeTotal = false,
+                          Index grain = parallel::DefaultGrain)
+{
+    const Index nchunks = parallel::numChunks(n, grain);
+    std::vector<T> partial(nchunks + 1);
+    parallel::forChunks(nchunks, [n, nchunks, &partial, &count](Index c) {
+        const Index begin = parallel::chunkBegin(n, nchunks, c), end = parallel::chunkBegin(n, nchunks, c + 1);
+        T sum = T();
+        for (Index i = begin; i < end; ++i)
+            sum += count(i);
+        partial[c + 1] = sum;
+    });
+    for (Index c = 0; c < nchunks; ++c)
+        partial[c + 1] += partial[c];
+    parallel::forChunks(nchunks, [n, nchunks, &partial, &count, offsets](Index c) {
+        const Index begin = parallel::chunkBegin(n, nchunks, c), end = parallel::chunkBegin(n, nchunks, c + 1);
+        T sum = partial[c];
+        for (Index i = begin; i < end; ++i) {
+            offsets[i] = sum;
+            sum += count(i);
+        }
+    });
+    const T total = partial[nchunks];
+    if (storeTotal)
+        offsets[n] = total;
+    return total;
+}
+
+//! append all i in [0, n) for which select(i) is true to selected, in ascending order, and return their number
+template<typename I, class Select>
+Index parallel_compact(Index n, Select &&select, std::vector<I> &selected, Index grain = parallel::DefaultGrain)
+{
+    const Index nchunks = parallel::numChunks(n, grain);
+    std::vector<std::vector<I>> partial(nchunks);
+    parallel::forChunks(nchunks, [n, nchunks, &partial, &select](Index c) {
+        const Index begin = parallel::chunkBegin(n, nchunks, c), end = parallel::chunkBegin(n, nchunks, c + 1);
+        auto &part = partial[c];
+        for (Index i = begin; i < end; ++i) {
+            if (select(i))
+                part.push_back(I(i));
+        }
+    });
+
+    std::vector<size_t> offset(nchunks + 1, selected.size());
+    for (Index c = 0; c < nchunks; ++c)
+        offset[c + 1] = offset[c] + partial[c].size();
+    selected.resize(offset[nchunks]);
+    parallel::forChunks(nchunks, [&partial, &offset, &selected](Index c) {
+        std::copy(partial[c].begin(), partial[c].end(), selected.begin() + offset[c]);
+    });
+    return Index(offset[nchunks] - offset[0]);
+}
+
+} // namespace vistle
+#endif
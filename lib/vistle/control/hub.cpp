@@ -1928,10 +1928,19 @@ bool Hub::hubReady()
             session.addIntParameter("archive_compression_speed", "speed parameter of compression algorithm", -1);
 
         session.setParameterRange(archiveCompressionSpeed, Integer(-1), Integer(100));
+        session.addIntParameter("archive_compression_adaptive",
+                                "choose archive compression per transfer based on measured link throughput", false,
+                                Parameter::Boolean);
 
         auto compressionMode = session.addIntParameter(CompressionSettings::p_mode, "compression mode for data fields",
                                                        cs.mode, Parameter::Choice);
         session.V_ENUM_SET_CHOICES(compressionMode, FieldCompressionMode);
+        auto integerCompressionMode =
+            session.addIntParameter(CompressionSettings::p_integerMode,
+                                    "compression mode for integer arrays (e.g. connectivity), overrides "
+                                    "field_compression if not Uncompressed",
+                                    cs.integerMode, Parameter::Choice);
+        session.V_ENUM_SET_CHOICES(integerCompressionMode, FieldCompressionMode);
 
         session.setCurrentParameterGroup("zfp");
         auto zfpMode = session.addIntParameter(CompressionSettings::p_zfpMode, "mode for zfp compression", cs.zfpMode,
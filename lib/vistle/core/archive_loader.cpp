@@ -4,9 +4,14 @@
 #include "shm_array_impl.h"
 #include "object.h"
 
+#include <vistle/util/taskpool.h>
+
 #include <boost/mpl/for_each.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <mutex>
 
 namespace vistle {
 
@@ -17,35 +22,58 @@ DeepArchiveFetcher::DeepArchiveFetcher(const std::map<std::string, buffer> &obje
 : m_objects(objects), m_arrays(arrays), m_compression(compressions), m_rawSize(sizes)
 {}
 
-void DeepArchiveFetcher::requestArray(const std::string &arname, int localType, int remoteType,
-                                      const ArrayCompletionHandler &completeCallback)
+const buffer *DeepArchiveFetcher::arrayData(const std::string &arname, buffer &raw) const
 {
-    //std::cerr << "DeepArchiveFetcher: trying array " << arname << std::endl;
     auto it = m_arrays.find(arname);
     if (it == m_arrays.end()) {
         std::cerr << "DeepArchiveFetcher: did not find array " << arname << std::endl;
-        return;
+        return nullptr;
     }
     message::CompressionMode comp = message::CompressionNone;
     auto itc = m_compression.find(arname);
     if (itc != m_compression.end()) {
         comp = itc->second;
     }
+    if (comp == message::CompressionNone)
+        return &it->second;
+
     size_t size = 0;
     auto its = m_rawSize.find(arname);
     if (its != m_rawSize.end()) {
         size = its->second;
     }
-    buffer raw;
-    if (comp != message::CompressionNone) {
-        try {
-            raw = message::decompressPayload(comp, it->second.size(), size, it->second.data());
-        } catch (const std::exception &ex) {
-            std::cerr << "DeepArchiveFetcher: failed to decompress array " << arname << ": " << ex.what() << std::endl;
+    try {
+        raw = message::decompressPayload(comp, it->second.size(), size, it->second.data());
+    } catch (const std::exception &ex) {
+        std::cerr << "DeepArchiveFetcher: failed to decompress array " << arname << ": " << ex.what() << std::endl;
+        return nullptr;
+    }
+    return &raw;
+}
+
+void DeepArchiveFetcher::requestArray(const std::string &arname, int localType, int remoteType,
+                                      const ArrayCompletionHandler &completeCallback)
+{
+    //std::cerr << "DeepArchiveFetcher: trying array " << arname << std::endl;
+    auto itp = m_prefetched.find(arname);
+    if (itp != m_prefetched.end()) {
+        auto pre = itp->second;
+        m_prefetched.erase(itp);
+        if (pre.type == unsigned(localType)) {
+            m_ownedArrays.emplace(pre.owner);
+            completeCallback(translateArrayName(arname));
             return;
         }
+        // has to be converted to another type: discard and load again
+        pre.owner.reset();
+        m_transArray.erase(arname);
     }
-    vecistreambuf<buffer> vb(comp == message::CompressionNone ? it->second : raw);
+
+    buffer raw;
+    auto data = arrayData(arname, raw);
+    if (!data)
+        return;
+    vecistreambuf<buffer> vb(*data);
     try {
         iarchive ar(vb);
         ar.setFetcher(shared_from_this());
@@ -65,6 +93,59 @@ void DeepArchiveFetcher::requestArray(const std::string &arname, int localType,
     }
 }
 
+void DeepArchiveFetcher::prefetchArray(const std::string &arname)
+{
+    buffer raw;
+    auto data = arrayData(arname, raw);
+    if (!data)
+        return;
+
+    try {
+        // arrays are loaded with the type they were saved with, requestArray takes care of conversions
+        std::string name;
+        uint32_t type = 0;
+        vecistreambuf<buffer> pb(*data);
+        iarchive peek(pb);
+        peek &name;
+        peek &type;
+
+        vecistreambuf<buffer> vb(*data);
+        iarchive ar(vb);
+        ar.setFetcher(shared_from_this());
+        ArrayLoader loader(arname, type, ar);
+        if (loader.load()) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_prefetched[arname] = PrefetchedArray{type, loader.owner()};
+        }
+    } catch (std::exception &ex) {
+        std::cerr << "DeepArchiveFetcher: exception " << ex.what() << " while prefetching array " << arname
+                  << std::endl;
+    }
+}
+
+namespace {
+
+// decompressing and loading smaller arrays concurrently does not pay off, they are loaded on demand
+const size_t MinPrefetchSize = 64 << 10;
+
+} // namespace
+
+void DeepArchiveFetcher::prefetchArrays()
+{
+    std::vector<std::string> names;
+    for (const auto &a: m_arrays) {
+        if (a.second.size() < MinPrefetchSize)
+            continue;
+        if (m_prefetchAttempted.emplace(a.first).second)
+            names.push_back(a.first);
+    }
+    if (names.size() < 2)
+        return;
+
+    // arrays are processed by the calling thread and by helpers running on the task pool shared with block tasks
+    TaskPool::the().forChunks(names.size(), [this, &names](size_t i) { prefetchArray(names[i]); });
+}
+
 void DeepArchiveFetcher::requestObject(const std::string &arname, const ObjectCompletionHandler &completeCallback)
 {
     //std::cerr << "DeepArchiveFetcher: trying object " << arname << std::endl;
@@ -114,6 +195,7 @@ std::string DeepArchiveFetcher::translateObjectName(const std::string &name) con
     if (!m_rename)
         return name;
 
+    std::lock_guard<std::mutex> guard(m_mutex);
     auto it = m_transObject.find(name);
     if (it == m_transObject.end())
         return std::string();
@@ -126,6 +208,7 @@ std::string DeepArchiveFetcher::translateArrayName(const std::string &name) cons
     if (!m_rename)
         return name;
 
+    std::lock_guard<std::mutex> guard(m_mutex);
     auto it = m_transArray.find(name);
     if (it == m_transArray.end())
         return std::string();
@@ -137,6 +220,7 @@ void DeepArchiveFetcher::registerObjectNameTranslation(const std::string &arname
 {
     if (!m_rename)
         return;
+    std::lock_guard<std::mutex> guard(m_mutex);
     auto p = m_transObject.emplace(arname, name);
 
     if (p.second) {
@@ -149,6 +233,7 @@ void DeepArchiveFetcher::registerArrayNameTranslation(const std::string &arname,
     if (!m_rename)
         return;
 
+    std::lock_guard<std::mutex> guard(m_mutex);
     auto p = m_transArray.emplace(arname, name);
     if (p.second) {
         //std::cerr << "yas_iarchive: array name translation for " << arname << " was already registered" << std::endl;
@@ -183,6 +268,7 @@ void DeepArchiveFetcher::setArrayTranslations(const std::map<std::string, std::s
 void DeepArchiveFetcher::releaseArrays()
 {
     m_ownedArrays.clear();
+    m_prefetched.clear();
 }
 
 std::ostream &operator<<(std::ostream &s, const DeepArchiveFetcher &daf)
@@ -270,6 +356,62 @@ bool ArrayLoader::load()
     return m_ok;
 }
 
+namespace {
+
+struct RawArrayConstructor {
+    RawArrayConstructor(const RawArrayEntry &ent): m_ent(ent) {}
+
+    template<typename T>
+    void operator()(T)
+    {
+        if (shm_array<T, typename shm<T>::allocator>::typeId() != m_ent.type)
+            return;
+
+        if (m_ent.bytes != m_ent.size * sizeof(T)) {
+            std::cerr << "RawArrayAllocator: size mismatch for " << m_ent.name << std::endl;
+            return;
+        }
+        if (Shm::the().getArrayFromName<T>(m_ent.name)) {
+            // e.g. sender and receiver share shared memory
+            return;
+        }
+        auto arr = ShmVector<T>((shm_name_t)m_ent.name);
+        if (!arr.valid())
+            arr.construct();
+        arr->setExact(m_ent.exact);
+        arr->resize(m_ent.size);
+        if (m_ent.dim[0] * m_ent.dim[1] * m_ent.dim[2] == m_ent.size)
+            arr->setDimensionHint(m_ent.dim[0], m_ent.dim[1], m_ent.dim[2]);
+        else
+            arr->clearDimensionHint();
+        // elements are received later on, but bounds have been determined by the sender
+        if (m_ent.bounds.size() == 2 * sizeof(T)) {
+            T bounds[2];
+            memcpy(bounds, m_ent.bounds.data(), sizeof(bounds));
+            arr->set_bounds(bounds[0], bounds[1]);
+        } else {
+            arr->invalidate_bounds();
+        }
+        m_data = reinterpret_cast<char *>(arr->data());
+        m_owner.reset(new Unreffer<T>(arr));
+    }
+
+    const RawArrayEntry &m_ent;
+    char *m_data = nullptr;
+    std::shared_ptr<ArrayLoader::ArrayOwner> m_owner;
+};
+
+} // namespace
+
+char *RawArrayAllocator::allocate(const RawArrayEntry &ent)
+{
+    RawArrayConstructor ctor(ent);
+    boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<RawArrayConstructor>(ctor));
+    if (ctor.m_owner)
+        m_ownedArrays.push_back(ctor.m_owner);
+    return ctor.m_data;
+}
+
 const std::string &ArrayLoader::name() const
 {
     return m_name;
@@ -11,7 +11,9 @@
 #include <set>
 #include <map>
 #include <string>
+#include <vector>
 #include <memory>
+#include <mutex>
 #include <ostream>
 
 namespace vistle {
@@ -41,6 +43,17 @@ struct V_COREEXPORT ArrayLoader {
     const vistle::iarchive &m_ar;
 };
 
+// Provides shared memory arrays for receiving the elements of arrays transferred without serialization in place.
+// The arrays are kept alive until the allocator is destroyed, i.e. until the objects referencing them have been loaded.
+class V_COREEXPORT RawArrayAllocator {
+public:
+    // storage for the elements of ent, nullptr if an array with this name already exists or if ent cannot be handled
+    char *allocate(const RawArrayEntry &ent);
+
+private:
+    std::vector<std::shared_ptr<ArrayLoader::ArrayOwner>> m_ownedArrays;
+};
+
 class DeepArchiveFetcher;
 
 V_COREEXPORT std::ostream &operator<<(std::ostream &os, const DeepArchiveFetcher &daf);
@@ -69,10 +82,22 @@ public:
     void setObjectTranslations(const std::map<std::string, std::string> &objs);
     void setArrayTranslations(const std::map<std::string, std::string> &arrs);
 
+    // load large arrays not yet requested concurrently on the task pool, so that decompression is not serialized
+    // while loading objects
+    void prefetchArrays();
     void releaseArrays();
 
 private:
+    struct PrefetchedArray {
+        unsigned type = 0;
+        std::shared_ptr<ArrayLoader::ArrayOwner> owner;
+    };
+
+    const buffer *arrayData(const std::string &arname, buffer &raw) const;
+    void prefetchArray(const std::string &arname);
+
     bool m_rename = false;
+    mutable std::mutex m_mutex; // protects name translations and prefetched arrays while prefetching
     std::map<std::string, std::string> m_transObject, m_transArray;
 
     const std::map<std::string, buffer> &m_objects;
@@ -81,6 +106,8 @@ private:
     const std::map<std::string, size_t> &m_rawSize;
 
     std::set<std::shared_ptr<ArrayLoader::ArrayOwner>> m_ownedArrays;
+    std::map<std::string, PrefetchedArray> m_prefetched;
+    std::set<std::string> m_prefetchAttempted;
 };
 
 } // namespace vistle
@@ -5,6 +5,11 @@
 #include "object.h"
 #include "archives_impl.h"
 
+#include <vistle/util/taskpool.h>
+
+#include <algorithm>
+#include <cassert>
+
 namespace vistle {
 
 template<typename T>
@@ -35,6 +40,86 @@ void ArraySaver::operator()(T)
     m_ok = true;
 }
 
+namespace {
+
+struct ArraySizer {
+    ArraySizer(const std::string &name, int type, const void *array): m_name(name), m_type(type), m_array(array) {}
+
+    template<typename T>
+    void operator()(T)
+    {
+        if (shm_array<T, typename shm<T>::allocator>::typeId() != m_type)
+            return;
+
+        ShmVector<T> arr;
+        if (m_array) {
+            arr = *reinterpret_cast<const ShmVector<T> *>(m_array);
+        } else {
+            arr = Shm::the().getArrayFromName<T>(m_name);
+        }
+        if (arr)
+            m_bytes = arr->size() * sizeof(T);
+    }
+
+    const std::string &m_name;
+    unsigned m_type;
+    const void *m_array = nullptr;
+    size_t m_bytes = 0;
+};
+
+// arrays at least this large are serialized and compressed concurrently
+const size_t MinParallelSize = 64 << 10;
+
+size_t maxPendingArrays()
+{
+    return std::max(TaskPool::the().concurrency(), 1u);
+}
+
+struct RawArrayCollector {
+    RawArrayCollector(const std::string &name, int type, const void *array)
+    : m_name(name), m_type(type), m_array(array)
+    {}
+
+    template<typename T>
+    void operator()(T)
+    {
+        if (shm_array<T, typename shm<T>::allocator>::typeId() != m_type)
+            return;
+
+        ShmVector<T> arr;
+        if (m_array) {
+            arr = *reinterpret_cast<const ShmVector<T> *>(m_array);
+        } else {
+            arr = Shm::the().getArrayFromName<T>(m_name);
+        }
+        if (!arr) {
+            std::cerr << "RawArrayCollector: did not find data array " << m_name << std::endl;
+            return;
+        }
+        m_entry.name = m_name;
+        m_entry.type = m_type;
+        m_entry.size = arr->size();
+        m_entry.bytes = arr->size() * sizeof(T);
+        m_entry.exact = arr->exact();
+        for (int d = 0; d < 3; ++d)
+            m_entry.dim[d] = arr->dimensionHint(d);
+        if (arr->bounds_valid()) {
+            const T bounds[2] = {arr->min(), arr->max()};
+            m_entry.bounds.assign(reinterpret_cast<const char *>(bounds), sizeof(bounds));
+        }
+        m_entry.data = reinterpret_cast<char *>(arr->data());
+        m_ref = std::make_shared<ShmVector<T>>(arr);
+    }
+
+    const std::string &m_name;
+    unsigned m_type;
+    const void *m_array = nullptr;
+    RawArrayEntry m_entry;
+    std::shared_ptr<void> m_ref;
+};
+
+} // namespace
+
 bool ArraySaver::save()
 {
     boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<ArraySaver>(*this));
@@ -49,6 +134,52 @@ void DeepArchiveSaver::saveArray(const std::string &name, int type, const void *
     if (isArraySaved(name))
         return;
 
+    if (m_raw && m_compressionSettings.mode == Uncompressed) {
+        RawArrayCollector coll(name, type, array);
+        boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<RawArrayCollector>(coll));
+        if (coll.m_ref) {
+            m_rawArrays.emplace(name, RawArray{coll.m_entry, coll.m_ref});
+        } else {
+            std::cerr << "DeepArchiveSaver: failed to collect array " << name << std::endl;
+        }
+        return;
+    }
+
+    if (compressConcurrently()) {
+        RawArrayCollector coll(name, type, array);
+        boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<RawArrayCollector>(coll));
+        if (coll.m_ref && coll.m_entry.bytes >= MinParallelSize) {
+            while (m_pendingOrder.size() >= maxPendingArrays()) {
+                completeArray(m_pendingOrder.front());
+            }
+            // arrays do not reference other objects or arrays, so the worker does not need this saver
+            auto settings = m_compressionSettings;
+            auto ref = coll.m_ref;
+            auto pending = std::make_shared<PendingArray>();
+            pending->serialize = [name, type, settings, ref]() -> buffer {
+                vecostreambuf<buffer> vb;
+                oarchive ar(vb);
+                ar.setCompressionSettings(settings);
+                ArraySaver as(name, type, ar, ref.get());
+                if (!as.save())
+                    return buffer();
+                return std::move(vb.get_vector());
+            };
+            TaskPool::the().submit([pending]() {
+                if (pending->started.exchange(true))
+                    return;
+                try {
+                    pending->result.set_value(pending->serialize());
+                } catch (...) {
+                    pending->result.set_exception(std::current_exception());
+                }
+            });
+            m_pendingArrays.emplace(name, std::move(pending));
+            m_pendingOrder.push_back(name);
+            return;
+        }
+    }
+
     vecostreambuf<buffer> vb;
     oarchive ar(vb);
     ar.setCompressionSettings(m_compressionSettings);
@@ -72,8 +203,41 @@ void vistle::DeepArchiveSaver::saveObject(const std::string &name, Object::const
     m_objects.emplace(name, std::move(vb.get_vector()));
 }
 
+bool DeepArchiveSaver::compressConcurrently() const
+{
+    // BigWhoop parallelizes compression of each array on its own
+    const auto &cs = m_compressionSettings;
+    if (cs.mode == BigWhoop)
+        return false;
+    return cs.mode != Uncompressed || cs.integerMode != Uncompressed;
+}
+
+void DeepArchiveSaver::completeArray(std::string name)
+{
+    auto it = m_pendingArrays.find(name);
+    assert(it != m_pendingArrays.end());
+    auto pending = it->second;
+    m_pendingArrays.erase(it);
+    m_pendingOrder.erase(std::find(m_pendingOrder.begin(), m_pendingOrder.end(), name));
+    // do not wait for a task that might be queued behind the caller on a busy pool
+    auto buf = pending->started.exchange(true) ? pending->result.get_future().get() : pending->serialize();
+    if (buf.empty()) {
+        std::cerr << "DeepArchiveSaver: failed to save array " << name << std::endl;
+        return;
+    }
+    m_arrays.emplace(name, std::move(buf));
+}
+
+void DeepArchiveSaver::completePendingArrays()
+{
+    while (!m_pendingOrder.empty()) {
+        completeArray(m_pendingOrder.front());
+    }
+}
+
 SubArchiveDirectory DeepArchiveSaver::getDirectory()
 {
+    completePendingArrays();
     SubArchiveDirectory dir;
     dir.reserve(m_objects.size() + m_arrays.size());
     for (auto &obj: m_objects) {
@@ -85,8 +249,19 @@ SubArchiveDirectory DeepArchiveSaver::getDirectory()
     return dir;
 }
 
+RawArrayDirectory DeepArchiveSaver::getRawDirectory()
+{
+    RawArrayDirectory dir;
+    dir.reserve(m_rawArrays.size());
+    for (auto &arr: m_rawArrays) {
+        dir.push_back(arr.second.entry);
+    }
+    return dir;
+}
+
 void DeepArchiveSaver::flushDirectory()
 {
+    completePendingArrays();
     for (const auto &obj: m_objects) {
         m_archivedObjects.emplace(obj.first);
     }
@@ -95,6 +270,10 @@ void DeepArchiveSaver::flushDirectory()
         m_archivedArrays.emplace(arr.first);
     }
     m_arrays.clear();
+    for (const auto &arr: m_rawArrays) {
+        m_archivedArrays.emplace(arr.first);
+    }
+    m_rawArrays.clear();
 }
 
 bool DeepArchiveSaver::isObjectSaved(const std::string &name) const
@@ -111,6 +290,10 @@ bool DeepArchiveSaver::isArraySaved(const std::string &name) const
 {
     if (m_arrays.find(name) != m_arrays.end())
         return true;
+    if (m_rawArrays.find(name) != m_rawArrays.end())
+        return true;
+    if (m_pendingArrays.find(name) != m_pendingArrays.end())
+        return true;
     if (m_archivedArrays.find(name) != m_archivedArrays.end())
         return true;
 
@@ -130,6 +313,10 @@ std::set<std::string> DeepArchiveSaver::savedArrays() const
     auto arrs = m_archivedArrays;
     for (const auto &a: m_arrays)
         arrs.emplace(a.first);
+    for (const auto &a: m_rawArrays)
+        arrs.emplace(a.first);
+    for (const auto &a: m_pendingArrays)
+        arrs.emplace(a.first);
     return arrs;
 }
 
@@ -148,4 +335,45 @@ void DeepArchiveSaver::setCompressionSettings(const CompressionSettings &setting
     m_compressionSettings = settings;
 }
 
+void DeepArchiveSaver::setRawArrays(bool raw)
+{
+    m_raw = raw;
+}
+
+void ArrayMemoryCounter::saveArray(const std::string &name, int type, const void *array)
+{
+    if (!m_arrays.insert(name).second)
+        return;
+
+    ArraySizer sizer(name, type, array);
+    boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<ArraySizer>(sizer));
+    m_bytes += sizer.m_bytes;
+}
+
+void ArrayMemoryCounter::saveObject(const std::string &name, Object::const_ptr obj)
+{
+    if (!m_objects.insert(name).second)
+        return;
+
+    // arrays and referenced objects are handed to this saver, only meta data is serialized
+    vecostreambuf<buffer> vb;
+    oarchive ar(vb);
+    ar.setSaver(shared_from_this());
+    obj->saveObject(ar);
+}
+
+size_t ArrayMemoryCounter::bytes() const
+{
+    return m_bytes;
+}
+
+size_t ArrayMemoryCounter::count(Object::const_ptr obj)
+{
+    if (!obj)
+        return 0;
+    auto counter = std::make_shared<ArrayMemoryCounter>();
+    counter->saveObject(obj->getName(), obj);
+    return counter->bytes();
+}
+
 } // namespace vistle
@@ -9,6 +9,10 @@
 
 #include <set>
 #include <map>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
 #include <string>
 #include <memory>
 #include <iostream>
@@ -51,14 +55,54 @@ public:
 
     void setCompressionSettings(const CompressionSettings &settings);
 
+    // do not serialize uncompressed arrays, but collect them for transferring their elements in place
+    void setRawArrays(bool raw);
+    RawArrayDirectory getRawDirectory();
+
 private:
+    struct RawArray {
+        RawArrayEntry entry;
+        std::shared_ptr<void> ref; // keeps array alive while it is being sent
+    };
+    // array serialized by a task on the task pool, or by the saver itself if the task has not yet been started
+    struct PendingArray {
+        std::function<buffer()> serialize;
+        std::atomic<bool> started{false};
+        std::promise<buffer> result;
+    };
+
+    bool compressConcurrently() const;
+    void completeArray(std::string name); // by value, as name may refer to an element of m_pendingOrder
+    void completePendingArrays();
+
     CompressionSettings m_compressionSettings;
+    bool m_raw = false;
     std::map<std::string, buffer> m_objects;
     std::map<std::string, buffer> m_arrays;
+    std::map<std::string, RawArray> m_rawArrays;
+    // large arrays are serialized and compressed by worker threads, results are sorted into m_arrays by name
+    std::map<std::string, std::shared_ptr<PendingArray>> m_pendingArrays;
+    std::deque<std::string> m_pendingOrder;
     std::set<std::string> m_archivedObjects;
     std::set<std::string> m_archivedArrays;
 };
 
+// Computes the memory occupied by the arrays of an object and of the objects referenced by it,
+// arrays shared between several objects are counted only once.
+class V_COREEXPORT ArrayMemoryCounter: public Saver, public std::enable_shared_from_this<ArrayMemoryCounter> {
+public:
+    void saveArray(const std::string &name, int type, const void *array) override;
+    void saveObject(const std::string &name, obj_const_ptr obj) override;
+
+    size_t bytes() const;
+
+    static size_t count(obj_const_ptr obj);
+
+private:
+    size_t m_bytes = 0;
+    std::set<std::string> m_objects;
+    std::set<std::string> m_arrays;
+};
 
 } // namespace vistle
 #endif
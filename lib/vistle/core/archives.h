@@ -107,6 +107,34 @@ struct SubArchiveDirectoryEntry {
 };
 typedef std::vector<SubArchiveDirectoryEntry> SubArchiveDirectory;
 
+// array transferred without serialization, its elements are sent directly from and received directly into shared memory
+struct RawArrayEntry {
+    std::string name;
+    uint32_t type = 0;
+    uint64_t size = 0; // number of elements
+    uint64_t bytes = 0;
+    bool exact = true;
+    uint64_t dim[3] = {0, 1, 1}; // dimension hint
+    std::string bounds; // raw minimum and maximum element, empty if bounds are not valid
+    char *data = nullptr;
+
+    ARCHIVE_ACCESS
+    template<class Archive>
+    void serialize(Archive &ar)
+    {
+        ar &name;
+        ar &type;
+        ar &size;
+        ar &bytes;
+        ar &exact;
+        ar &dim[0];
+        ar &dim[1];
+        ar &dim[2];
+        ar &bounds;
+    }
+};
+typedef std::vector<RawArrayEntry> RawArrayDirectory;
+
 class V_COREEXPORT Saver {
 public:
     virtual ~Saver();
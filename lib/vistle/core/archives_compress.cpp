@@ -14,6 +14,11 @@
 #include "archives.h"
 #include "archives_compress.h"
 
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
 //#define COMP_DEBUG
 
 namespace vistle {
@@ -142,6 +147,188 @@ template bool compressZfp<zfp_type_float>(buffer &compressed, const void *src, c
 template bool compressZfp<zfp_type_double>(buffer &compressed, const void *src, const Index dim[3], Index typeSize,
                                            const ZfpParameters &param);
 
+namespace {
+
+// number of values sharing a common bit width, a block always occupies a multiple of 32 bits
+const size_t DeltaPackBlock = 128;
+
+template<typename U>
+inline U zigzag(U delta)
+{
+    typedef typename std::make_signed<U>::type S;
+    return U(U(delta << 1) ^ U(S(delta) >> (sizeof(U) * 8 - 1)));
+}
+
+template<typename U>
+inline U unzigzag(U z)
+{
+    return U(U(z >> 1) ^ U(-U(z & 1)));
+}
+
+struct BitWriter {
+    char *p;
+    uint64_t acc = 0;
+    unsigned filled = 0;
+
+    explicit BitWriter(char *p): p(p) {}
+
+    // bits <= 32
+    void put(uint64_t v, unsigned bits)
+    {
+        acc |= v << filled;
+        filled += bits;
+        if (filled >= 32) {
+            uint32_t word = uint32_t(acc);
+            memcpy(p, &word, sizeof(word));
+            p += sizeof(word);
+            acc >>= 32;
+            filled -= 32;
+        }
+    }
+};
+
+struct BitReader {
+    const char *p;
+    uint64_t acc = 0;
+    unsigned filled = 0;
+
+    explicit BitReader(const char *p): p(p) {}
+
+    // bits <= 32
+    uint64_t get(unsigned bits)
+    {
+        if (filled < bits) {
+            uint32_t word;
+            memcpy(&word, p, sizeof(word));
+            p += sizeof(word);
+            acc |= uint64_t(word) << filled;
+            filled += 32;
+        }
+        uint64_t v = acc & ((uint64_t(1) << bits) - 1);
+        acc >>= bits;
+        filled -= bits;
+        return v;
+    }
+};
+
+} // namespace
+
+template<typename T>
+bool compressDeltaPack(buffer &compressed, const T *src, size_t n)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    const size_t rawSize = n * sizeof(T);
+    compressed.clear();
+    compressed.reserve(rawSize / 2 + sizeof(uint64_t));
+    uint64_t count = n;
+    compressed.resize(sizeof(count));
+    memcpy(compressed.data(), &count, sizeof(count));
+
+    U prev = 0;
+    uint64_t z[DeltaPackBlock];
+    for (size_t b = 0; b < n; b += DeltaPackBlock) {
+        const size_t m = std::min(DeltaPackBlock, n - b);
+        uint64_t bits = 0;
+        for (size_t i = 0; i < m; ++i) {
+            U cur = U(src[b + i]);
+            z[i] = zigzag<U>(U(cur - prev));
+            prev = cur;
+            bits |= z[i];
+        }
+        for (size_t i = m; i < DeltaPackBlock; ++i)
+            z[i] = 0;
+
+        const unsigned width = std::bit_width(bits);
+        size_t pos = compressed.size();
+        if (pos + 1 + DeltaPackBlock / 8 * width >= rawSize + sizeof(count)) {
+#ifdef COMP_DEBUG
+            std::cerr << "compressDeltaPack: not compressible" << std::endl;
+#endif
+            return false;
+        }
+        compressed.resize(pos + 1 + DeltaPackBlock / 8 * width);
+        compressed[pos] = char(width);
+        BitWriter w(compressed.data() + pos + 1);
+        if (width > 32) {
+            for (size_t i = 0; i < DeltaPackBlock; ++i) {
+                w.put(z[i] & 0xffffffffu, 32);
+                w.put(z[i] >> 32, width - 32);
+            }
+        } else if (width > 0) {
+            for (size_t i = 0; i < DeltaPackBlock; ++i)
+                w.put(z[i], width);
+        }
+        assert(w.filled == 0);
+        assert(w.p == compressed.data() + compressed.size());
+    }
+
+#ifdef COMP_DEBUG
+    std::cerr << "compressDeltaPack: compressed " << n << " elements, size " << rawSize << " to " << compressed.size()
+              << " bytes" << std::endl;
+#endif
+    return true;
+}
+
+template<typename T>
+bool decompressDeltaPack(T *dest, size_t n, const buffer &compressed)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    uint64_t count = 0;
+    if (compressed.size() < sizeof(count)) {
+        std::cerr << "decompressDeltaPack: truncated header" << std::endl;
+        return false;
+    }
+    memcpy(&count, compressed.data(), sizeof(count));
+    if (count != n) {
+        std::cerr << "decompressDeltaPack: size mismatch: " << count << " != " << n << std::endl;
+        return false;
+    }
+
+    const char *p = compressed.data() + sizeof(count);
+    const char *end = compressed.data() + compressed.size();
+    U prev = 0;
+    for (size_t b = 0; b < n; b += DeltaPackBlock) {
+        const size_t m = std::min(DeltaPackBlock, n - b);
+        if (p >= end) {
+            std::cerr << "decompressDeltaPack: truncated data" << std::endl;
+            return false;
+        }
+        const unsigned width = uint8_t(*p++);
+        if (width > sizeof(U) * 8 || end - p < ptrdiff_t(DeltaPackBlock / 8 * width)) {
+            std::cerr << "decompressDeltaPack: corrupt block" << std::endl;
+            return false;
+        }
+        BitReader r(p);
+        for (size_t i = 0; i < m; ++i) {
+            uint64_t z = 0;
+            if (width > 32) {
+                z = r.get(32);
+                z |= r.get(width - 32) << 32;
+            } else if (width > 0) {
+                z = r.get(width);
+            }
+            prev = U(prev + unzigzag<U>(U(z)));
+            dest[b + i] = T(prev);
+        }
+        p += DeltaPackBlock / 8 * width;
+    }
+    return true;
+}
+
+#define V_DELTAPACK_TEMPLATES(T) \
+    template bool compressDeltaPack<T>(buffer & compressed, const T *src, size_t n); \
+    template bool decompressDeltaPack<T>(T * dest, size_t n, const buffer &compressed);
+V_DELTAPACK_TEMPLATES(char)
+V_DELTAPACK_TEMPLATES(signed char)
+V_DELTAPACK_TEMPLATES(unsigned char)
+V_DELTAPACK_TEMPLATES(int32_t)
+V_DELTAPACK_TEMPLATES(uint32_t)
+V_DELTAPACK_TEMPLATES(int64_t)
+V_DELTAPACK_TEMPLATES(uint64_t)
+#undef V_DELTAPACK_TEMPLATES
+
 } // namespace detail
 
 } // namespace vistle
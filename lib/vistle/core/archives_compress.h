@@ -3,6 +3,9 @@
 
 #include <zfp.h>
 
+#include <cstdint>
+#include <cstdlib>
+
 #include <vistle/util/buffer.h>
 #include "archives_config.h"
 
@@ -68,6 +71,25 @@ extern template bool V_COREEXPORT compressZfp<zfp_type_float>(buffer &compressed
 extern template bool V_COREEXPORT compressZfp<zfp_type_double>(buffer &compressed, const void *src, const Index dim[3],
                                                                const Index typeSize, const ZfpParameters &param);
 
+//! lossless compression of integer arrays, e.g. connectivity:
+//! differences of consecutive elements are zigzag encoded and bit-packed in blocks with a common bit width
+template<typename T>
+bool compressDeltaPack(buffer &compressed, const T *src, size_t n);
+template<typename T>
+bool decompressDeltaPack(T *dest, size_t n, const buffer &compressed);
+
+#define V_DELTAPACK_TEMPLATES(T) \
+    extern template bool V_COREEXPORT compressDeltaPack<T>(buffer & compressed, const T *src, size_t n); \
+    extern template bool V_COREEXPORT decompressDeltaPack<T>(T * dest, size_t n, const buffer &compressed);
+V_DELTAPACK_TEMPLATES(char)
+V_DELTAPACK_TEMPLATES(signed char)
+V_DELTAPACK_TEMPLATES(unsigned char)
+V_DELTAPACK_TEMPLATES(int32_t)
+V_DELTAPACK_TEMPLATES(uint32_t)
+V_DELTAPACK_TEMPLATES(int64_t)
+V_DELTAPACK_TEMPLATES(uint64_t)
+#undef V_DELTAPACK_TEMPLATES
+
 } // namespace detail
 } // namespace vistle
 #endif
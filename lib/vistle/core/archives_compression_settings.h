@@ -8,7 +8,7 @@
 
 namespace vistle {
 
-DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionMode, (Uncompressed)(Predict)(Zfp)(SZ)(BigWhoop))
+DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionMode, (Uncompressed)(Predict)(Zfp)(SZ)(BigWhoop)(DeltaPack))
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionZfpMode, (ZfpFixedRate)(ZfpPrecision)(ZfpAccuracy))
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionSzAlgo, (SzInterpLorenzo)(SzInterp)(SzLorenzoReg))
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionSzError, (SzRel)(SzAbs)(SzAbsAndRel)(SzAbsOrRel)(SzPsnr)(SzL2))
@@ -16,6 +16,9 @@ DEFINE_ENUM_WITH_STRING_CONVERSIONS(FieldCompressionSzError, (SzRel)(SzAbs)(SzAb
 struct CompressionSettings {
     static constexpr const char *p_mode = "field_compression";
     FieldCompressionMode mode = Uncompressed;
+    // applied to integer arrays (e.g. connectivity) instead of mode, if not Uncompressed
+    static constexpr const char *p_integerMode = "integer_compression";
+    FieldCompressionMode integerMode = Uncompressed;
 
     static constexpr const char *p_zfpMode = "zfp_mode";
     FieldCompressionZfpMode zfpMode = ZfpFixedRate;
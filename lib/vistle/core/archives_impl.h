@@ -22,6 +22,7 @@
 #include <vector>
 #include <algorithm>
 #include <span>
+#include <type_traits>
 
 #include <vistle/util/enum.h>
 #include <vistle/util/buffer.h>
@@ -52,15 +53,21 @@ class yas_iarchive;
 
 namespace detail {
 
+template<typename T>
 inline CompressionSettings getCompressionSettings(const CompressionSettings &cs, bool requireExact)
 {
     CompressionSettings settings = cs;
+    if (std::is_integral<T>::value && cs.integerMode != Uncompressed) {
+        settings.mode = cs.integerMode;
+    }
     if (requireExact) {
-        switch (cs.mode) {
+        switch (settings.mode) {
         case Uncompressed:
             break;
         case Predict:
             break;
+        case DeltaPack:
+            break;
         default:
             settings.mode = Uncompressed;
             break;
@@ -288,8 +295,18 @@ void archive_helper<yas_tag>::ArrayWrapper<T>::load(Archive &ar)
     bool compZfp = compressMode == Zfp;
     bool compSz3 = compressMode == SZ;
     bool compBigWhoop = compressMode == BigWhoop;
+    bool compDeltaPack = compressMode == DeltaPack;
 
-    if (compPredict) {
+    if (compDeltaPack) {
+        buffer compressed;
+        ar &compressed;
+        if constexpr (std::is_integral<T>::value) {
+            if (!decompressDeltaPack<T>(m_begin, size(), compressed))
+                std::cerr << "DeltaPack decompression failed" << std::endl;
+        } else {
+            std::cerr << "DeltaPack decompression not supported for non-integral type" << std::endl;
+        }
+    } else if (compPredict) {
         yas::detail::concepts::array::load<yas_flags>(ar, *this);
         if (size() > 0) {
             std::transform(m_begin + 1, m_end, m_begin, m_begin + 1, DecompressStream<T>());
@@ -328,15 +345,30 @@ template<class T>
 template<class Archive>
 void archive_helper<yas_tag>::ArrayWrapper<T>::save(Archive &ar) const
 {
-    auto cs = getCompressionSettings(ar.compressionSettings(), m_exact);
+    auto cs = getCompressionSettings<T>(ar.compressionSettings(), m_exact);
     bool compPredict = PredictTransform<T>::use && (cs.mode == Predict);
     bool compSz3 = cs.mode == SZ;
     bool compZfp = cs.mode == Zfp;
     bool compBigWhoop = cs.mode == BigWhoop;
-    bool compress = compPredict || compZfp || compSz3 || compBigWhoop;
-    uint8_t compressMode(cs.mode);
+    bool compDeltaPack = std::is_integral<T>::value && cs.mode == DeltaPack;
+    bool compress = compPredict || compZfp || compSz3 || compBigWhoop || compDeltaPack;
+    uint8_t compressMode(compress ? cs.mode : Uncompressed);
     //std::cerr << "ar.compressed()=" << compress << std::endl;COMP_DEBUG
-    if (compPredict) {
+    if (compDeltaPack) {
+        buffer compressed;
+        bool ok = false;
+        if constexpr (std::is_integral<T>::value) {
+            ok = compressDeltaPack<T>(compressed, m_begin, size());
+        }
+        if (ok) {
+            ar &compressMode;
+            ar &compressed;
+        } else {
+            compDeltaPack = false;
+            compress = false;
+            compressMode = Uncompressed;
+        }
+    } else if (compPredict) {
         ar &compressMode;
         std::vector<T> diff;
         diff.reserve(size());
@@ -422,6 +454,9 @@ using detail::decompressSz3;
 
 using detail::compressBigWhoop;
 using detail::decompressBigWhoop;
+
+using detail::compressDeltaPack;
+using detail::decompressDeltaPack;
 } // namespace vistle
 #endif
 
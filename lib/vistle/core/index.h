@@ -27,6 +27,10 @@ typedef SIndex32 SIndex;
 const Index InvalidIndex = InvalidIndex32;
 #endif
 
+// attribute of objects storing their connectivity with Index32 indices although Index is wider:
+// only archives of objects carrying it contain the compact lists, so that other archives keep their layout
+constexpr const char CompactIndicesAttribute[] = "_compact_indices";
+
 #define V_INDEX_CHECK(t) \
     static_assert(sizeof(t) == sizeof(S##t)); \
     static_assert(std::is_signed<S##t>::value); \
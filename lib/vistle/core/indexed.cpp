@@ -9,6 +9,19 @@
 
 namespace vistle {
 
+namespace {
+
+template<typename To, typename From>
+ShmVector<To> convertIndices(const From *data, size_t size)
+{
+    ShmVector<To> result;
+    result.construct(size);
+    std::copy(data, data + size, result->begin());
+    return result;
+}
+
+} // namespace
+
 Indexed::Indexed(const size_t numElements, const size_t numCorners, const size_t numVertices, const Meta &meta)
 : Indexed::Base(static_cast<Data *>(NULL))
 {
@@ -27,37 +40,53 @@ bool Indexed::isEmpty() const
 
 bool Indexed::checkImpl(std::ostream &os, bool quick) const
 {
-    VALIDATE_INDEX(d()->cl->size());
-    VALIDATE_INDEX(d()->el->size());
+    if (hasCompactIndices()) {
+        VALIDATE(d()->el->size() == 0 && d()->cl->size() == 0);
+        VALIDATE_INDEX(d()->cl32->size());
+        VALIDATE_INDEX(d()->el32->size());
+        VALIDATE(d()->el32->check(os));
+        VALIDATE(d()->cl32->check(os));
+        VALIDATE(d()->el32->size() > 0);
+    } else {
+        VALIDATE_INDEX(d()->cl->size());
+        VALIDATE_INDEX(d()->el->size());
+        VALIDATE(d()->el->check(os));
+        VALIDATE(d()->cl->check(os));
+        VALIDATE(d()->el->size() > 0);
+    }
     VALIDATE_INDEX(d()->ghost->size());
-
-
-    VALIDATE(d()->el->check(os));
-    VALIDATE(d()->cl->check(os));
     VALIDATE(d()->ghost->check(os));
 
-    VALIDATE(d()->el->size() > 0);
-    VALIDATE(el()[0] == 0);
     VALIDATE(d()->ghost->size() == 0 || d()->ghost->size() == getNumElements());
 
-    VALIDATE(el()[getNumElements()] <= getNumCorners());
-    if (getNumElements() > 0) {
-        VALIDATE(el()[getNumElements() - 1] <= getNumCorners());
-    }
-
-    if (getNumCorners() > 0) {
-        VALIDATE(cl()[0] < getNumVertices());
-        VALIDATE(cl()[getNumCorners() - 1] < getNumVertices());
-    }
+    const Index numElem = getNumElements(), numCorners = getNumCorners(), numVert = getNumVertices();
+    const bool indicesOk = withIndices([numElem, numCorners, numVert](const auto *el, const auto *cl) {
+        if (el[0] != 0 || el[numElem] > numCorners)
+            return false;
+        if (numElem > 0 && el[numElem - 1] > numCorners)
+            return false;
+        if (numCorners > 0 && (cl[0] >= numVert || cl[numCorners - 1] >= numVert))
+            return false;
+        return true;
+    });
+    VALIDATE(indicesOk);
 
     if (quick)
         return true;
 
 
-    VALIDATE_RANGE_P(d()->cl, 0, getSize() - 1);
-    VALIDATE_MONOTONIC_P(d()->el);
-    if (d()->cl->size() > 0) {
-        VALIDATE_RANGE_P(d()->el, 0, d()->cl->size());
+    if (hasCompactIndices()) {
+        VALIDATE_RANGE_P(d()->cl32, 0, getSize() - 1);
+        VALIDATE_MONOTONIC_P(d()->el32);
+        if (d()->cl32->size() > 0) {
+            VALIDATE_RANGE_P(d()->el32, 0, d()->cl32->size());
+        }
+    } else {
+        VALIDATE_RANGE_P(d()->cl, 0, getSize() - 1);
+        VALIDATE_MONOTONIC_P(d()->el);
+        if (d()->cl->size() > 0) {
+            VALIDATE_RANGE_P(d()->el, 0, d()->cl->size());
+        }
     }
 
     if (hasCelltree()) {
@@ -113,7 +142,7 @@ Indexed::Celltree::const_ptr Indexed::getCelltree() const
     Data::mutex_lock_type lock(d()->attachment_mutex);
     if (!hasAttachment("celltree")) {
         refresh();
-        createCelltree(getNumElements(), el().data(), cl().data());
+        withIndices([this](const auto *el, const auto *cl) { createCelltree(getNumElements(), el, cl); });
     }
 
     m_celltree = Celltree::as(getAttachment("celltree"));
@@ -121,7 +150,8 @@ Indexed::Celltree::const_ptr Indexed::getCelltree() const
     return m_celltree;
 }
 
-void Indexed::createCelltree(Index nelem, const Index *el, const Index *cl) const
+template<typename I>
+void Indexed::createCelltree(Index nelem, const I *el, const I *cl) const
 {
     if (hasCelltree())
         return;
@@ -201,57 +231,57 @@ void Indexed::createVertexOwnerList() const
     Index numcoord = getNumVertices();
 
     VertexOwnerList::ptr vol(new VertexOwnerList(numcoord));
-    const auto *cl = this->cl().data();
-    const auto *el = this->el().data();
-    auto vertexList = vol->vertexList().data();
-
-    std::fill(vol->vertexList().begin(), vol->vertexList().end(), 0);
-    std::vector<Index> used_vertex_list(numcoord, InvalidIndex);
-    auto uvl = used_vertex_list.data();
-
-    // Calculation of the number of cells that contain a certain vertex:
-    // temporarily stored in vertexList
-    for (Index i = 0; i < numelem; i++) {
-        const Index begin = el[i], end = el[i + 1];
-        for (Index j = begin; j < end; ++j) {
-            const Index v = cl[j];
-            if (uvl[v] != j) {
-                vertexList[v]++;
-                uvl[v] = j;
+    withIndices([&vol, numelem, numcoord](const auto *el, const auto *cl) {
+        auto vertexList = vol->vertexList().data();
+
+        std::fill(vol->vertexList().begin(), vol->vertexList().end(), 0);
+        std::vector<Index> used_vertex_list(numcoord, InvalidIndex);
+        auto uvl = used_vertex_list.data();
+
+        // Calculation of the number of cells that contain a certain vertex:
+        // temporarily stored in vertexList
+        for (Index i = 0; i < numelem; i++) {
+            const Index begin = el[i], end = el[i + 1];
+            for (Index j = begin; j < end; ++j) {
+                const Index v = cl[j];
+                if (uvl[v] != j) {
+                    vertexList[v]++;
+                    uvl[v] = j;
+                }
             }
         }
-    }
 
-    // create the vertexList: prefix sum
-    // vertexList will index into cellList
-    std::vector<Index> outputIndex(numcoord);
-    auto outIdx = outputIndex.data();
-    {
-        Index numEnt = 0;
-        for (Index i = 0; i < numcoord; i++) {
-            Index n = numEnt;
-            numEnt += vertexList[i];
-            vertexList[i] = n;
-            outIdx[i] = n;
+        // create the vertexList: prefix sum
+        // vertexList will index into cellList
+        std::vector<Index> outputIndex(numcoord);
+        auto outIdx = outputIndex.data();
+        {
+            Index numEnt = 0;
+            for (Index i = 0; i < numcoord; i++) {
+                Index n = numEnt;
+                numEnt += vertexList[i];
+                vertexList[i] = n;
+                outIdx[i] = n;
+            }
+            vertexList[numcoord] = numEnt;
+            vol->cellList().resize(numEnt);
         }
-        vertexList[numcoord] = numEnt;
-        vol->cellList().resize(numEnt);
-    }
 
-    //fill the cellList
-    std::fill(used_vertex_list.begin(), used_vertex_list.end(), InvalidIndex);
-    auto cellList = vol->cellList().data();
-    for (Index i = 0; i < numelem; i++) {
-        const Index begin = el[i], end = el[i + 1];
-        for (Index j = begin; j < end; ++j) {
-            const Index v = cl[j];
-            if (uvl[v] != j) {
-                uvl[v] = j;
-                cellList[outIdx[v]] = i;
-                outIdx[v]++;
+        //fill the cellList
+        std::fill(used_vertex_list.begin(), used_vertex_list.end(), InvalidIndex);
+        auto cellList = vol->cellList().data();
+        for (Index i = 0; i < numelem; i++) {
+            const Index begin = el[i], end = el[i + 1];
+            for (Index j = begin; j < end; ++j) {
+                const Index v = cl[j];
+                if (uvl[v] != j) {
+                    uvl[v] = j;
+                    cellList[outIdx[v]] = i;
+                    outIdx[v]++;
+                }
             }
         }
-    }
+    });
 
     addAttachment("vertexownerlist", vol);
 }
@@ -260,11 +290,19 @@ void Indexed::print(std::ostream &os, bool verbose) const
 {
     Base::print(os);
 
-    os << " cl:";
-    d()->cl.print(os, verbose);
+    if (hasCompactIndices()) {
+        os << " cl32:";
+        d()->cl32.print(os, verbose);
 
-    os << " el:";
-    d()->el.print(os, verbose);
+        os << " el32:";
+        d()->el32.print(os, verbose);
+    } else {
+        os << " cl:";
+        d()->cl.print(os, verbose);
+
+        os << " el:";
+        d()->el.print(os, verbose);
+    }
 
     os << " ghost:";
     d()->ghost.print(os, verbose);
@@ -275,8 +313,6 @@ Indexed::NeighborFinder::NeighborFinder(const Indexed *indexed): indexed(indexed
     auto ol = indexed->getVertexOwnerList();
     numElem = indexed->getNumElements();
     numVert = indexed->getNumCorners();
-    el = indexed->el();
-    cl = indexed->cl();
     vl = ol->vertexList();
     vol = ol->cellList();
 }
@@ -291,25 +327,27 @@ Index Indexed::NeighborFinder::getNeighborElement(Index elem, Index v1, Index v2
 
     const Index *elems = &vol[vl[v1]];
     Index nelem = vl[v1 + 1] - vl[v1];
-    for (Index j = 0; j < nelem; ++j) {
-        Index e = elems[j];
-        if (e == elem)
-            continue;
-        bool f2 = false, f3 = false;
-        for (Index i = el[e]; i < el[e + 1]; ++i) {
-            const Index v = cl[i];
-            if (v == v2) {
-                f2 = true;
-                if (f3)
-                    return e;
-            } else if (v == v3) {
-                f3 = true;
-                if (f2)
-                    return e;
+    return indexed->withIndices([elem, v2, v3, elems, nelem](const auto *el, const auto *cl) -> Index {
+        for (Index j = 0; j < nelem; ++j) {
+            Index e = elems[j];
+            if (e == elem)
+                continue;
+            bool f2 = false, f3 = false;
+            for (Index i = el[e]; i < el[e + 1]; ++i) {
+                const Index v = cl[i];
+                if (v == v2) {
+                    f2 = true;
+                    if (f3)
+                        return e;
+                } else if (v == v3) {
+                    f3 = true;
+                    if (f2)
+                        return e;
+                }
             }
         }
-    }
-    return InvalidIndex;
+        return InvalidIndex;
+    });
 }
 
 std::vector<Index> Indexed::NeighborFinder::getContainingElements(Index vert) const
@@ -378,40 +416,36 @@ bool Indexed::validateCelltree() const
 
 std::pair<Vector3, Vector3> Indexed::elementBounds(Index elem) const
 {
-    const Index *el = this->el().data();
-    const Index *cl = nullptr;
-    if (getNumCorners() > 0)
-        cl = this->cl().data();
-    const Index begin = el[elem], end = el[elem + 1];
+    const bool haveCl = getNumCorners() > 0;
     const Scalar *x[3] = {this->x().data(), this->y().data(), this->z().data()};
-
-    const Scalar smax = std::numeric_limits<Scalar>::max();
-    Vector3 min(smax, smax, smax), max(-smax, -smax, -smax);
-    for (Index i = begin; i < end; ++i) {
-        Index v = i;
-        if (cl)
-            v = cl[i];
-        for (int c = 0; c < 3; ++c) {
-            min[c] = std::min(min[c], x[c][v]);
-            max[c] = std::max(max[c], x[c][v]);
+    return withIndices([elem, haveCl, &x](const auto *el, const auto *cl) {
+        const Index begin = el[elem], end = el[elem + 1];
+        const Scalar smax = std::numeric_limits<Scalar>::max();
+        Vector3 min(smax, smax, smax), max(-smax, -smax, -smax);
+        for (Index i = begin; i < end; ++i) {
+            Index v = i;
+            if (haveCl)
+                v = cl[i];
+            for (int c = 0; c < 3; ++c) {
+                min[c] = std::min(min[c], x[c][v]);
+                max[c] = std::max(max[c], x[c][v]);
+            }
         }
-    }
-    return std::make_pair(min, max);
+        return std::make_pair(min, max);
+    });
 }
 
 Index Indexed::cellNumVertices(Index elem) const
 {
-    const Index *el = this->el().data();
-    const Index begin = el[elem], end = el[elem + 1];
-    return end - begin;
+    return withIndices([elem](const auto *el, const auto *cl) -> Index { return el[elem + 1] - el[elem]; });
 }
 
 std::vector<Index> Indexed::cellVertices(Index elem) const
 {
-    const Index *el = this->el().data();
-    const Index *cl = this->cl().data();
-    const Index begin = el[elem], end = el[elem + 1];
-    return std::vector<Index>(&cl[begin], &cl[end]);
+    return withIndices([elem](const auto *el, const auto *cl) {
+        const Index begin = el[elem], end = el[elem + 1];
+        return std::vector<Index>(&cl[begin], &cl[end]);
+    });
 }
 
 Index Indexed::cellNumFaces(Index elem) const
@@ -444,16 +478,95 @@ void Indexed::refreshImpl() const
         m_el = d->el;
         m_cl = d->cl;
         m_ghost = d->ghost;
+        m_el32 = d->el32;
+        m_cl32 = d->cl32;
     } else {
         m_el = nullptr;
         m_cl = nullptr;
         m_ghost = nullptr;
+        m_el32 = nullptr;
+        m_cl32 = nullptr;
     }
-    m_numEl = (d && d->el.valid()) ? d->el->size() - 1 : 0;
-    m_numCl = (d && d->cl.valid()) ? d->cl->size() : 0;
+    const bool compact = d && d->el32.valid() && d->el32->size() > 0;
+    if (compact && !m_elWide.empty() && m_wideSource == d->el32.name().str() + d->cl32.name().str()) {
+        // keep process-local copies, as they might still be in use
+        m_el = m_elWide;
+        m_cl = m_clWide;
+        m_widen = false;
+    } else {
+        m_widen = compact;
+    }
+    m_numEl = compact ? d->el32->size() - 1 : (d && d->el.valid()) ? d->el->size() - 1 : 0;
+    m_numCl = compact ? d->cl32->size() : (d && d->cl.valid()) ? d->cl->size() : 0;
     m_celltree = nullptr;
 }
 
+void Indexed::widenIndices() const
+{
+    std::lock_guard<std::mutex> guard(m_widenMutex);
+    if (!m_widen)
+        return;
+
+    m_elWide.assign(m_el32.data(), m_el32.data() + m_el32.size());
+    m_clWide.assign(m_cl32.data(), m_cl32.data() + m_cl32.size());
+    m_wideSource = d()->el32.name().str() + d()->cl32.name().str();
+    m_el = m_elWide;
+    m_cl = m_clWide;
+    m_widen = false;
+}
+
+void Indexed::throwCompact() const
+{
+    throw vistle::exception("Indexed: indices of " + getName() +
+                            " are stored with 32 bit, call expandIndices() before modifying them");
+}
+
+bool Indexed::compactIndices()
+{
+    if (sizeof(Index) <= sizeof(Index32))
+        return false;
+    if (hasCompactIndices())
+        return true;
+    if (getNumCorners() >= InvalidIndex32 || getNumVertices() >= InvalidIndex32)
+        return false;
+
+    d()->el32 = convertIndices<Index32>(d()->el->data(), d()->el->size());
+    d()->cl32 = convertIndices<Index32>(d()->cl->data(), d()->cl->size());
+    d()->el = ShmVector<Index>();
+    d()->el.construct(0);
+    d()->cl = ShmVector<Index>();
+    d()->cl.construct(0);
+    d()->setAttributeList(CompactIndicesAttribute, {});
+
+    refreshImpl();
+    return true;
+}
+
+void Indexed::expandIndices()
+{
+    if (!hasCompactIndices())
+        return;
+
+    d()->el = convertIndices<Index>(d()->el32->data(), d()->el32->size());
+    d()->cl = convertIndices<Index>(d()->cl32->data(), d()->cl32->size());
+    d()->el32 = ShmVector<Index32>();
+    d()->el32.construct(0);
+    d()->cl32 = ShmVector<Index32>();
+    d()->cl32.construct(0);
+
+    refreshImpl();
+}
+
+bool Indexed::hasCompactIndices() const
+{
+    return d()->el32.valid() && d()->el32->size() > 0;
+}
+
+unsigned Indexed::indexWidth() const
+{
+    return hasCompactIndices() ? sizeof(Index32) * 8 : sizeof(Index) * 8;
+}
+
 void Indexed::Data::initData()
 {}
 
@@ -466,11 +579,13 @@ Indexed::Data::Data(const size_t numElements, const size_t numCorners, const siz
     el.construct(numElements + 1);
     cl.construct(numCorners);
     ghost.construct(0);
+    el32.construct(0);
+    cl32.construct(0);
     (*el)[0] = 0;
 }
 
 Indexed::Data::Data(const Indexed::Data &o, const std::string &name)
-: Indexed::Base::Data(o, name), el(o.el), cl(o.cl), ghost(o.ghost)
+: Indexed::Base::Data(o, name), el(o.el), cl(o.cl), ghost(o.ghost), el32(o.el32), cl32(o.cl32)
 {
     initData();
 }
@@ -487,6 +602,8 @@ Indexed::Data *Indexed::Data::create(const std::string &objId, Type id, const si
 
 Index Indexed::getNumElements()
 {
+    if (hasCompactIndices())
+        return d()->el32->size() - 1;
     return d()->el->size() - 1;
 }
 
@@ -497,6 +614,15 @@ Index Indexed::getNumElements() const
 
 void Indexed::resetElements()
 {
+    if (hasCompactIndices()) {
+        // only the connectivity list is kept
+        d()->cl = convertIndices<Index>(d()->cl32->data(), d()->cl32->size());
+        d()->el32 = ShmVector<Index32>();
+        d()->el32.construct(0);
+        d()->cl32 = ShmVector<Index32>();
+        d()->cl32.construct(0);
+    }
+
     d()->el = ShmVector<Index>();
     d()->el.construct(1);
     (*d()->el)[0] = 0;
@@ -507,8 +633,30 @@ void Indexed::resetElements()
     refreshImpl();
 }
 
+void Indexed::updateInternals()
+{
+    if (Shm::compactIndices())
+        compactIndices();
+
+    bool deduplicated = d()->el.deduplicate();
+    if (d()->cl.deduplicate())
+        deduplicated = true;
+    if (d()->el32.deduplicate())
+        deduplicated = true;
+    if (d()->cl32.deduplicate())
+        deduplicated = true;
+    if (d()->ghost.deduplicate())
+        deduplicated = true;
+    if (deduplicated)
+        refreshImpl();
+
+    Base::updateInternals();
+}
+
 Index Indexed::getNumCorners()
 {
+    if (hasCompactIndices())
+        return d()->cl32->size();
     return d()->cl->size();
 }
 
@@ -519,6 +667,15 @@ Index Indexed::getNumCorners() const
 
 void Indexed::resetCorners()
 {
+    if (hasCompactIndices()) {
+        // only the element list is kept
+        d()->el = convertIndices<Index>(d()->el32->data(), d()->el32->size());
+        d()->el32 = ShmVector<Index32>();
+        d()->el32.construct(0);
+        d()->cl32 = ShmVector<Index32>();
+        d()->cl32.construct(0);
+    }
+
     d()->cl = ShmVector<Index>();
     d()->cl.construct();
 
@@ -1,6 +1,9 @@
 #ifndef VISTLE_CORE_INDEXED_H
 #define VISTLE_CORE_INDEXED_H
 
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "scalar.h"
 #include "shm.h"
@@ -24,16 +27,59 @@ public:
     Index getNumElements() override;
     Index getNumElements() const override;
     virtual void resetElements();
+    void updateInternals() override;
     Index getNumCorners();
     Index getNumCorners() const;
     void resetCorners();
 
-    typename shm<Index>::array &el() { return *d()->el; }
-    typename shm<Index>::array &cl() { return *d()->cl; }
+    // modifiable element and connectivity lists, throw if they are stored with 32 bit indices:
+    // call expandIndices() before modifying a compacted object
+    typename shm<Index>::array &el()
+    {
+        if (hasCompactIndices())
+            throwCompact();
+        return *d()->el;
+    }
+    typename shm<Index>::array &cl()
+    {
+        if (hasCompactIndices())
+            throwCompact();
+        return *d()->cl;
+    }
     typename shm<Byte>::array &ghost() { return *d()->ghost; }
-    const ShmArrayProxy<Index> &el() const { return m_el; }
-    const ShmArrayProxy<Index> &cl() const { return m_cl; }
+    // element and connectivity lists with indices of type Index,
+    // if they are stored with 32 bit indices, a copy on the heap of this process is created on first access,
+    // prefer withIndices() for avoiding it
+    const ShmArrayProxy<Index> &el() const
+    {
+        if (m_widen)
+            widenIndices();
+        return m_el;
+    }
+    const ShmArrayProxy<Index> &cl() const
+    {
+        if (m_widen)
+            widenIndices();
+        return m_cl;
+    }
     const ShmArrayProxy<Byte> &ghost() const { return m_ghost; }
+
+    // store element and connectivity lists with 32 bit indices, if Index is wider and all indices fit
+    bool compactIndices();
+    // store element and connectivity lists with indices of type Index again
+    void expandIndices();
+    bool hasCompactIndices() const;
+    // no. of bits of the indices in the stored element and connectivity lists
+    unsigned indexWidth() const;
+    // call func(const I *el, const I *cl) with the element and connectivity lists as stored,
+    // where I is either Index32 or Index
+    template<class Func>
+    auto withIndices(Func &&func) const
+    {
+        if (m_el32.size() > 0)
+            return func(m_el32.data(), m_cl32.data());
+        return func(m_el.data(), m_cl.data());
+    }
     void setGhost(Index index, bool isGhost);
     bool isGhost(Index index) const;
 
@@ -60,7 +106,6 @@ public:
         NeighborFinder(const Indexed *indexed);
         const Indexed *indexed;
         Index numElem, numVert;
-        const Index *el, *cl;
         const Index *vl, *vol;
     };
     const NeighborFinder &getNeighborFinder() const;
@@ -76,17 +121,28 @@ private:
     mutable ShmArrayProxy<Index> m_el;
     mutable ShmArrayProxy<Index> m_cl;
     mutable ShmArrayProxy<Byte> m_ghost;
+    mutable ShmArrayProxy<Index32> m_el32;
+    mutable ShmArrayProxy<Index32> m_cl32;
+    mutable std::atomic<bool> m_widen{false}; // el/cl have to be created from m_el32/m_cl32
+    mutable std::mutex m_widenMutex;
+    mutable std::vector<Index> m_elWide, m_clWide;
+    mutable std::string m_wideSource; // names of compact arrays that m_elWide and m_clWide have been created from
     mutable Celltree::const_ptr m_celltree;
     mutable VertexOwnerList::const_ptr m_vertexOwnerList;
     mutable std::unique_ptr<const NeighborFinder> m_neighborfinder;
 
+    void widenIndices() const;
+    [[noreturn]] void throwCompact() const;
     void createVertexOwnerList() const;
-    void createCelltree(Index nelem, const Index *el, const Index *cl) const;
+    template<typename I>
+    void createCelltree(Index nelem, const I *el, const I *cl) const;
 
     V_DATA_BEGIN(Indexed);
     ShmVector<Index> el; //< element list: index into connectivity list - last element: sentinel
     ShmVector<Index> cl; //< connectivity list: index into coordinates
     ShmVector<Byte> ghost; //< ghost bit list: indicate if cell is ghost bit
+    ShmVector<Index32> el32; //< compact element list, replaces el if not empty
+    ShmVector<Index32> cl32; //< compact connectivity list, replaces cl if not empty
 
     Data(const size_t numElements = 0, const size_t numCorners = 0, const size_t numVertices = 0, Type id = UNKNOWN,
          const std::string &name = "", const Meta &meta = Meta());
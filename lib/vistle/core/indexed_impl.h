@@ -10,6 +10,11 @@ void Indexed::Data::serialize(Archive &ar)
     ar &V_NAME(ar, "element_list", el);
     ar &V_NAME(ar, "connection_list", cl);
     ar &V_NAME(ar, "ghost_list", ghost);
+    // attributes have already been restored by the base class
+    if (hasAttribute(CompactIndicesAttribute)) {
+        ar &V_NAME(ar, "compact_element_list", el32);
+        ar &V_NAME(ar, "compact_connection_list", cl32);
+    }
 }
 
 } // namespace vistle
@@ -87,6 +87,7 @@ DEFINE_ENUM_WITH_STRING_CONVERSIONS(
     (REMOVECOLORMAP)
     (CONFIGUREPARAMETER)
     (CHANGEPORTFLAGS)
+    (TRANSFERSTATISTICS)
     (NumMessageTypes) // keep last
 )
 V_ENUM_OUTPUT_OP(Type, ::vistle::message)
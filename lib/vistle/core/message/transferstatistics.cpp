@@ -0,0 +1,31 @@
+#include "transferstatistics.h"
+
+#include "../messagepayloadtemplates.h"
+
+namespace vistle {
+namespace message {
+
+template V_COREEXPORT buffer addPayload<TransferStatistics::Payload>(Message &message,
+                                                                     const TransferStatistics::Payload &payload);
+template V_COREEXPORT TransferStatistics::Payload getPayload(const buffer &data);
+
+void TransferStatistics::Entry::add(const Entry &other)
+{
+    transfers += other.transfers;
+    rawBytes += other.rawBytes;
+    compressedBytes += other.compressedBytes;
+    compressTime += other.compressTime;
+    decompressTime += other.decompressTime;
+    waitTime += other.waitTime;
+    wireTime += other.wireTime;
+}
+
+TransferStatistics::Payload::Payload() = default;
+
+TransferStatistics::Payload::Payload(const std::vector<Entry> &entries): entries(entries)
+{}
+
+TransferStatistics::TransferStatistics() = default;
+
+} // namespace message
+} // namespace vistle
@@ -0,0 +1,70 @@
+#ifndef VISTLE_CORE_MESSAGE_TRANSFERSTATISTICS_H
+#define VISTLE_CORE_MESSAGE_TRANSFERSTATISTICS_H
+
+#include "../message.h"
+
+#include <string>
+#include <vector>
+
+namespace vistle {
+namespace message {
+
+//! accumulated timing and volume of object and array transfers received from remote hubs by a cluster manager rank
+class V_COREEXPORT TransferStatistics: public MessageBase<TransferStatistics, TRANSFERSTATISTICS> {
+public:
+    //! totals for data added to one output port and transferred with one compression mode
+    struct V_COREEXPORT Entry {
+        int module = Id::Invalid; //!< module that added the data to its output port
+        std::string port;
+        int compression = CompressionNone;
+        uint64_t transfers = 0;
+        uint64_t rawBytes = 0;
+        uint64_t compressedBytes = 0;
+        double compressTime = 0.; //!< seconds spent compressing by sender
+        double decompressTime = 0.; //!< seconds spent decompressing by receiver
+        double waitTime = 0.; //!< seconds spent by sender between receiving a request and compressing
+        double wireTime = 0.; //!< seconds from request to reception, excluding the time spent by sender
+
+        void add(const Entry &other);
+
+        ARCHIVE_ACCESS
+        template<class Archive>
+        void serialize(Archive &ar)
+        {
+            ar &module;
+            ar &port;
+            ar &compression;
+            ar &transfers;
+            ar &rawBytes;
+            ar &compressedBytes;
+            ar &compressTime;
+            ar &decompressTime;
+            ar &waitTime;
+            ar &wireTime;
+        }
+    };
+
+    struct V_COREEXPORT Payload {
+        Payload();
+        Payload(const std::vector<Entry> &entries);
+
+        std::vector<Entry> entries;
+
+        ARCHIVE_ACCESS
+        template<class Archive>
+        void serialize(Archive &ar)
+        {
+            ar &entries;
+        }
+    };
+
+    TransferStatistics();
+};
+
+extern template V_COREEXPORT buffer addPayload<TransferStatistics::Payload>(Message &message,
+                                                                            const TransferStatistics::Payload &payload);
+extern template V_COREEXPORT TransferStatistics::Payload getPayload(const buffer &data);
+
+} // namespace message
+} // namespace vistle
+#endif
@@ -58,6 +58,7 @@ void Router::initRoutingTable()
     rt[REDUCEPOLICY] = DestLocalManager | Track;
     rt[EXECUTIONPROGRESS] = DestManager | HandleOnRank0;
     rt[DATATRANSFERSTATE] = Special;
+    rt[TRANSFERSTATISTICS] = Track | DestUi | DestMasterHub;
 
     rt[ADDOBJECT] = DestManager | HandleOnNode;
     rt[ADDOBJECTCOMPLETED] = DestManager | HandleOnNode;
@@ -1038,6 +1038,24 @@ bool AddObject::isUnblocking() const
     return m_unblock;
 }
 
+void AddObject::setFused()
+{
+    m_fused = true;
+    if (m_handleValid) {
+        // sender keeps the object alive until it has been handed over
+        if (Shm::isAttached() && Shm::the().name() == std::string(m_shmname.data())) {
+            if (auto o = Shm::the().getObjectFromHandle(handle))
+                o->unref();
+        }
+        m_handleValid = false;
+    }
+}
+
+bool AddObject::isFused() const
+{
+    return m_fused;
+}
+
 
 AddObjectCompleted::AddObjectCompleted(const AddObject &msg): m_name(msg.objectName()), m_orgDestId(msg.destId())
 {
@@ -1979,6 +1997,51 @@ int RequestObject::arrayType() const
     return m_arrayType;
 }
 
+void RequestObject::setAcceptReference(bool accept)
+{
+    m_acceptReference = accept;
+}
+
+bool RequestObject::acceptReference() const
+{
+    return m_acceptReference;
+}
+
+void RequestObject::setLinkBandwidth(double bandwidth)
+{
+    m_linkBandwidth = bandwidth;
+}
+
+double RequestObject::linkBandwidth() const
+{
+    return m_linkBandwidth;
+}
+
+void RequestObject::setAcceptShmPayload(bool accept)
+{
+    m_acceptShmPayload = accept;
+}
+
+bool RequestObject::acceptShmPayload() const
+{
+    return m_acceptShmPayload;
+}
+
+void RequestObject::setArrayCache(uint64_t capacity, uint64_t epoch)
+{
+    m_arrayCacheCapacity = capacity;
+    m_arrayCacheEpoch = epoch;
+}
+
+uint64_t RequestObject::arrayCacheCapacity() const
+{
+    return m_arrayCacheCapacity;
+}
+
+uint64_t RequestObject::arrayCacheEpoch() const
+{
+    return m_arrayCacheEpoch;
+}
 
 SendObject::SendObject(const RequestObject &request, Object::const_ptr obj, size_t payloadSize)
 : m_array(false)
@@ -2052,6 +2115,93 @@ bool SendObject::isArray() const
     return m_array;
 }
 
+void SendObject::setContentHash(const ContentHash &hash)
+{
+    m_contentHash = hash;
+}
+
+const SendObject::ContentHash &SendObject::contentHash() const
+{
+    return m_contentHash;
+}
+
+void SendObject::setReference(bool ref)
+{
+    m_reference = ref;
+}
+
+bool SendObject::isReference() const
+{
+    return m_reference;
+}
+
+void SendObject::setPreparationTime(double seconds)
+{
+    m_preparationTime = seconds;
+}
+
+double SendObject::preparationTime() const
+{
+    return m_preparationTime;
+}
+
+void SendObject::setCompressionTime(double seconds)
+{
+    m_compressionTime = seconds;
+}
+
+double SendObject::compressionTime() const
+{
+    return m_compressionTime;
+}
+
+void SendObject::setChunk(uint64_t offset, uint64_t totalSize)
+{
+    m_chunkOffset = offset;
+    m_totalPayloadSize = totalSize;
+}
+
+bool SendObject::isChunk() const
+{
+    return m_totalPayloadSize > 0;
+}
+
+uint64_t SendObject::chunkOffset() const
+{
+    return m_chunkOffset;
+}
+
+uint64_t SendObject::totalPayloadSize() const
+{
+    return m_totalPayloadSize;
+}
+
+void SendObject::setPushed(bool pushed)
+{
+    m_pushed = pushed;
+}
+
+bool SendObject::isPushed() const
+{
+    return m_pushed;
+}
+
+void SendObject::setShmPayload(const std::string &name, uint64_t size)
+{
+    m_shmPayloadName = name;
+    m_shmPayloadSize = size;
+}
+
+const char *SendObject::shmPayloadName() const
+{
+    return m_shmPayloadName;
+}
+
+uint64_t SendObject::shmPayloadSize() const
+{
+    return m_shmPayloadSize;
+}
+
 FileQuery::FileQuery(int moduleId, const std::string &path, Command command, size_t payloadsize)
 : m_command(command), m_moduleId(moduleId)
 {
@@ -2122,6 +2272,28 @@ size_t DataTransferState::numTransferring() const
     return m_numTransferring;
 }
 
+void DataTransferState::setCompression(CompressionMode mode, int speed, double bandwidth)
+{
+    m_compressionMode = mode;
+    m_compressionSpeed = speed;
+    m_bandwidth = bandwidth;
+}
+
+CompressionMode DataTransferState::compressionMode() const
+{
+    return static_cast<CompressionMode>(m_compressionMode);
+}
+
+int DataTransferState::compressionSpeed() const
+{
+    return m_compressionSpeed;
+}
+
+double DataTransferState::bandwidth() const
+{
+    return m_bandwidth;
+}
+
 std::ostream &operator<<(std::ostream &s, const Message &m)
 {
     using namespace vistle::message;
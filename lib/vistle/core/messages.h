@@ -109,6 +109,7 @@ public:
         std::vector<std::string> rankNames;
         std::vector<std::vector<std::string>> rankAddresses;
         std::vector<uint16_t> rankDataPorts;
+        std::vector<std::string> rankShmNamespaces; // ranks may share POSIX shared memory, if these and host names match
 
         ARCHIVE_ACCESS
         template<class Archive>
@@ -118,6 +119,7 @@ public:
             ar &rankNames;
             ar &rankAddresses;
             ar &rankDataPorts;
+            ar &rankShmNamespaces;
         }
     };
 
@@ -515,6 +517,9 @@ public:
     bool isBlocker() const;
     void setUnblocking();
     bool isUnblocking() const;
+    //! object is handed over directly between modules of a fused chain, drops reference to object held by message
+    void setFused();
+    bool isFused() const;
 
 private:
     Meta m_meta;
@@ -527,6 +532,7 @@ private:
     mutable bool m_handleValid = false;
     bool m_blocker = false;
     bool m_unblock = false;
+    bool m_fused = false;
 };
 
 class V_COREEXPORT AddObjectCompleted: public MessageBase<AddObjectCompleted, ADDOBJECTCOMPLETED> {
@@ -1052,12 +1058,31 @@ public:
     const char *referrer() const;
     bool isArray() const;
     int arrayType() const;
+    //! whether sender may answer with a reference to an array with identical contents it already holds
+    void setAcceptReference(bool accept);
+    bool acceptReference() const;
+    //! throughput in bytes/s achieved by recent transfers from the requested hub, 0 if unknown
+    void setLinkBandwidth(double bandwidth);
+    double linkBandwidth() const;
+    //! whether sender may place a large payload into a shared memory object, as it runs on the same host
+    void setAcceptShmPayload(bool accept);
+    bool acceptShmPayload() const;
+    //! capacity in bytes of the requesting rank's cache of arrays received with a content hash, 0 if disabled
+    /*! the epoch identifies the cache's contents, it changes if they have been lost */
+    void setArrayCache(uint64_t capacity, uint64_t epoch);
+    uint64_t arrayCacheCapacity() const;
+    uint64_t arrayCacheEpoch() const;
 
 private:
     shm_name_t m_objectId;
     shm_name_t m_referrer;
     bool m_array;
+    bool m_acceptReference = true;
+    bool m_acceptShmPayload = false;
     int m_arrayType;
+    double m_linkBandwidth = 0.;
+    uint64_t m_arrayCacheCapacity = 0;
+    uint64_t m_arrayCacheEpoch = 0;
 };
 
 //! header for data object transmission
@@ -1073,8 +1098,43 @@ public:
     Meta objectMeta() const;
     bool isArray() const;
 
+    typedef std::array<uint8_t, 32> ContentHash;
+    //! hash of the contents of an array, all zero if not computed
+    void setContentHash(const ContentHash &hash);
+    const ContentHash &contentHash() const;
+    //! no payload is sent, receiver should use its array with identical content hash
+    void setReference(bool ref);
+    bool isReference() const;
+    //! seconds spent by sender between receiving the request and sending the payload
+    void setPreparationTime(double seconds);
+    double preparationTime() const;
+    //! seconds spent by sender on compressing the payload, part of preparation time
+    void setCompressionTime(double seconds);
+    double compressionTime() const;
+    //! payload is a part starting at offset of a payload of totalSize bytes striped across several connections
+    void setChunk(uint64_t offset, uint64_t totalSize);
+    bool isChunk() const;
+    uint64_t chunkOffset() const;
+    uint64_t totalPayloadSize() const;
+    //! sent without a request, ahead of the receiver asking for it
+    void setPushed(bool pushed);
+    bool isPushed() const;
+    //! payload of size bytes has been placed into shared memory object name instead of being sent along
+    void setShmPayload(const std::string &name, uint64_t size);
+    const char *shmPayloadName() const;
+    uint64_t shmPayloadSize() const;
+
 private:
     bool m_array;
+    bool m_reference = false;
+    bool m_pushed = false;
+    ContentHash m_contentHash{};
+    double m_preparationTime = 0.;
+    double m_compressionTime = 0.;
+    uint64_t m_chunkOffset = 0;
+    uint64_t m_totalPayloadSize = 0;
+    shm_name_t m_shmPayloadName;
+    uint64_t m_shmPayloadSize = 0;
     shm_name_t m_objectId;
     shm_name_t m_referrer;
     int m_objectType;
@@ -1128,8 +1188,18 @@ public:
     DataTransferState(size_t numTransferring);
     size_t numTransferring() const;
 
+    //! most recent choice of adaptive payload compression
+    void setCompression(CompressionMode mode, int speed, double bandwidth);
+    CompressionMode compressionMode() const;
+    int compressionSpeed() const;
+    //! estimated link throughput in bytes/s that the choice was based on, 0 if not adaptive
+    double bandwidth() const;
+
 private:
     size_t m_numTransferring;
+    int m_compressionMode = CompressionNone;
+    int m_compressionSpeed = 0;
+    double m_bandwidth = 0.;
 };
 
 //! wrap a COVISE message sent by COVER
@@ -1181,4 +1251,5 @@ private:
 #pragma pack(pop)
 
 #include "message/setname.h"
+#include "message/transferstatistics.h"
 #endif
@@ -11,6 +11,19 @@
 
 namespace vistle {
 
+namespace {
+
+template<typename To, typename From>
+ShmVector<To> convertIndices(const From *data, size_t size)
+{
+    ShmVector<To> result;
+    result.construct(size);
+    std::copy(data, data + size, result->begin());
+    return result;
+}
+
+} // namespace
+
 template<int N>
 V_OBJECT_IMPL_LOAD(Ngons<N>)
 template<int N>
@@ -30,15 +43,88 @@ void Ngons<N>::refreshImpl() const
     if (d) {
         m_cl = d->cl;
         m_ghost = d->ghost;
-
+        m_cl32 = d->cl32;
     } else {
         m_cl = nullptr;
         m_ghost = nullptr;
+        m_cl32 = nullptr;
+    }
+    const bool compact = d && d->cl32.valid() && d->cl32->size() > 0;
+    if (compact && !m_clWide.empty() && m_wideSource == d->cl32.name().str()) {
+        // keep process-local copy, as it might still be in use
+        m_cl = m_clWide;
+        m_widen = false;
+    } else {
+        m_widen = compact;
     }
-    m_numCorners = (d && d->cl.valid()) ? d->cl->size() : 0;
+    m_numCorners = compact ? d->cl32->size() : (d && d->cl.valid()) ? d->cl->size() : 0;
     m_celltree = nullptr;
 }
 
+template<int N>
+void Ngons<N>::widenIndices() const
+{
+    std::lock_guard<std::mutex> guard(m_widenMutex);
+    if (!m_widen)
+        return;
+
+    m_clWide.assign(m_cl32.data(), m_cl32.data() + m_cl32.size());
+    m_wideSource = d()->cl32.name().str();
+    m_cl = m_clWide;
+    m_widen = false;
+}
+
+template<int N>
+void Ngons<N>::throwCompact() const
+{
+    throw vistle::exception("Ngons: indices of " + getName() +
+                            " are stored with 32 bit, call expandIndices() before modifying them");
+}
+
+template<int N>
+bool Ngons<N>::compactIndices()
+{
+    if (sizeof(Index) <= sizeof(Index32))
+        return false;
+    if (hasCompactIndices())
+        return true;
+    if (getNumCorners() == 0 || getNumVertices() >= InvalidIndex32)
+        return false;
+
+    d()->cl32 = convertIndices<Index32>(d()->cl->data(), d()->cl->size());
+    d()->cl = ShmVector<Index>();
+    d()->cl.construct(0);
+    d()->setAttributeList(CompactIndicesAttribute, {});
+
+    refreshImpl();
+    return true;
+}
+
+template<int N>
+void Ngons<N>::expandIndices()
+{
+    if (!hasCompactIndices())
+        return;
+
+    d()->cl = convertIndices<Index>(d()->cl32->data(), d()->cl32->size());
+    d()->cl32 = ShmVector<Index32>();
+    d()->cl32.construct(0);
+
+    refreshImpl();
+}
+
+template<int N>
+bool Ngons<N>::hasCompactIndices() const
+{
+    return d()->cl32.valid() && d()->cl32->size() > 0;
+}
+
+template<int N>
+unsigned Ngons<N>::indexWidth() const
+{
+    return hasCompactIndices() ? sizeof(Index32) * 8 : sizeof(Index) * 8;
+}
+
 template<int N>
 bool Ngons<N>::isEmpty()
 {
@@ -54,15 +140,24 @@ bool Ngons<N>::isEmpty() const
 template<int N>
 bool Ngons<N>::checkImpl(std::ostream &os, bool quick) const
 {
-    VALIDATE_INDEX(d()->cl->size());
+    if (hasCompactIndices()) {
+        VALIDATE(d()->cl->size() == 0);
+        VALIDATE_INDEX(d()->cl32->size());
+        VALIDATE(d()->cl32->check(os));
+    } else {
+        VALIDATE_INDEX(d()->cl->size());
+        VALIDATE(d()->cl->check(os));
+    }
     VALIDATE_INDEX(d()->ghost->size());
 
-    VALIDATE(d()->cl->check(os));
     VALIDATE(d()->ghost->check(os));
     VALIDATE(d()->ghost->size() == 0 || d()->ghost->size() == getNumElements());
     if (getNumCorners() > 0) {
-        VALIDATE(cl()[0] < getNumVertices());
-        VALIDATE(cl()[getNumCorners() - 1] < getNumVertices());
+        const Index numCorners = getNumCorners(), numVert = getNumVertices();
+        const bool indicesOk = withIndices([numCorners, numVert](const auto *cl) {
+            return cl[0] < numVert && cl[numCorners - 1] < numVert;
+        });
+        VALIDATE(indicesOk);
         VALIDATE(getNumCorners() % N == 0);
     } else {
         VALIDATE(getNumCoords() % N == 0);
@@ -72,7 +167,11 @@ bool Ngons<N>::checkImpl(std::ostream &os, bool quick) const
         return true;
 
     if (getNumCorners() > 0) {
-        VALIDATE_RANGE(cl(), 0, getNumVertices() - 1);
+        if (hasCompactIndices()) {
+            VALIDATE_RANGE_P(d()->cl32, 0, getNumVertices() - 1);
+        } else {
+            VALIDATE_RANGE_P(d()->cl, 0, getNumVertices() - 1);
+        }
     }
 
     if (hasCelltree()) {
@@ -85,42 +184,39 @@ bool Ngons<N>::checkImpl(std::ostream &os, bool quick) const
 template<int N>
 std::pair<Vector3, Vector3> Ngons<N>::elementBounds(Index elem) const
 {
-    const Index *cl = nullptr;
-    if (getNumCorners() > 0)
-        cl = this->cl().data();
     const Index begin = elem * N, end = begin + N;
     const Scalar *x[3] = {this->x().data(), this->y().data(), this->z().data()};
-
-    const Scalar smax = std::numeric_limits<Scalar>::max();
-    Vector3 min(smax, smax, smax), max(-smax, -smax, -smax);
-    for (Index i = begin; i < end; ++i) {
-        Index v = i;
-        if (cl)
-            v = cl[i];
-        for (int c = 0; c < 3; ++c) {
-            min[c] = std::min(min[c], x[c][v]);
-            max[c] = std::max(max[c], x[c][v]);
+    return withIndices([begin, end, &x](const auto *cl) {
+        const Scalar smax = std::numeric_limits<Scalar>::max();
+        Vector3 min(smax, smax, smax), max(-smax, -smax, -smax);
+        for (Index i = begin; i < end; ++i) {
+            Index v = i;
+            if (cl)
+                v = cl[i];
+            for (int c = 0; c < 3; ++c) {
+                min[c] = std::min(min[c], x[c][v]);
+                max[c] = std::max(max[c], x[c][v]);
+            }
         }
-    }
-    return std::make_pair(min, max);
+        return std::make_pair(min, max);
+    });
 }
 
 template<int N>
 std::vector<Index> Ngons<N>::cellVertices(Index elem) const
 {
-    std::vector<Index> result;
-    result.reserve(N);
-    const Index *cl = nullptr;
-    if (getNumCorners() > 0)
-        cl = this->cl().data();
     const Index begin = elem * N, end = begin + N;
-    for (Index i = begin; i < end; ++i) {
-        Index v = i;
-        if (cl)
-            v = cl[i];
-        result.emplace_back(v);
-    }
-    return result;
+    return withIndices([begin, end](const auto *cl) {
+        std::vector<Index> result;
+        result.reserve(N);
+        for (Index i = begin; i < end; ++i) {
+            Index v = i;
+            if (cl)
+                v = cl[i];
+            result.emplace_back(v);
+        }
+        return result;
+    });
 }
 
 template<int N>
@@ -159,10 +255,7 @@ Ngons<N>::Celltree::const_ptr Ngons<N>::getCelltree() const
     typename Data::mutex_lock_type lock(d()->attachment_mutex);
     if (!hasAttachment("celltree")) {
         refresh();
-        const Index *corners = nullptr;
-        if (getNumCorners() > 0)
-            corners = cl().data();
-        createCelltree(getNumElements(), corners);
+        withIndices([this](const auto *cl) { createCelltree(getNumElements(), cl); });
     }
 
     m_celltree = Celltree::as(getAttachment("celltree"));
@@ -171,7 +264,8 @@ Ngons<N>::Celltree::const_ptr Ngons<N>::getCelltree() const
 }
 
 template<int N>
-void Ngons<N>::createCelltree(Index nelem, const Index *cl) const
+template<typename I>
+void Ngons<N>::createCelltree(Index nelem, const I *cl) const
 {
     if (hasCelltree())
         return;
@@ -273,7 +367,8 @@ void Ngons<N>::Data::initData()
 {}
 
 template<int N>
-Ngons<N>::Data::Data(const Ngons::Data &o, const std::string &n): Ngons::Base::Data(o, n), cl(o.cl), ghost(o.ghost)
+Ngons<N>::Data::Data(const Ngons::Data &o, const std::string &n)
+: Ngons::Base::Data(o, n), cl(o.cl), ghost(o.ghost), cl32(o.cl32)
 {
     initData();
 }
@@ -286,6 +381,7 @@ Ngons<N>::Data::Data(const size_t numCorners, const size_t numCoords, const std:
     initData();
     cl.construct(numCorners);
     ghost.construct(0);
+    cl32.construct(0);
 }
 
 
@@ -314,6 +410,8 @@ Index Ngons<N>::getNumElements() const
 template<int N>
 Index Ngons<N>::getNumCorners()
 {
+    if (hasCompactIndices())
+        return d()->cl32->size();
     return d()->cl->size();
 }
 
@@ -326,6 +424,9 @@ Index Ngons<N>::getNumCorners() const
 template<int N>
 void Ngons<N>::resetCorners()
 {
+    d()->cl32 = ShmVector<Index32>();
+    d()->cl32.construct(0);
+
     d()->cl = ShmVector<Index>();
     d()->cl.construct();
 
@@ -335,6 +436,23 @@ void Ngons<N>::resetCorners()
     refreshImpl();
 }
 
+template<int N>
+void Ngons<N>::updateInternals()
+{
+    if (Shm::compactIndices())
+        compactIndices();
+
+    bool deduplicated = d()->cl.deduplicate();
+    if (d()->cl32.deduplicate())
+        deduplicated = true;
+    if (d()->ghost.deduplicate())
+        deduplicated = true;
+    if (deduplicated)
+        refreshImpl();
+
+    Base::updateInternals();
+}
+
 template<int N>
 Ngons<N>::Ngons(Data *data): Ngons::Base(data)
 {
@@ -1,6 +1,10 @@
 #ifndef VISTLE_CORE_NGONS_H
 #define VISTLE_CORE_NGONS_H
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "shm.h"
 #include "coords.h"
 #include "geometry.h"
@@ -24,9 +28,42 @@ public:
     Index getNumCorners();
     Index getNumCorners() const;
     void resetCorners();
-
-    shm<Index>::array &cl() { return *d()->cl; }
-    const ShmArrayProxy<Index> &cl() const { return m_cl; }
+    void updateInternals() override;
+
+    // modifiable connectivity list, throws if it is stored with 32 bit indices:
+    // call expandIndices() before modifying a compacted object
+    shm<Index>::array &cl()
+    {
+        if (hasCompactIndices())
+            throwCompact();
+        return *d()->cl;
+    }
+    // connectivity list with indices of type Index,
+    // if it is stored with 32 bit indices, a copy on the heap of this process is created on first access,
+    // prefer withIndices() for avoiding it
+    const ShmArrayProxy<Index> &cl() const
+    {
+        if (m_widen)
+            widenIndices();
+        return m_cl;
+    }
+
+    // store connectivity list with 32 bit indices, if Index is wider and all indices fit
+    bool compactIndices();
+    // store connectivity list with indices of type Index again
+    void expandIndices();
+    bool hasCompactIndices() const;
+    // no. of bits of the indices in the stored connectivity list
+    unsigned indexWidth() const;
+    // call func(const I *cl) with the connectivity list as stored, where I is either Index32 or Index,
+    // cl is nullptr if there is no connectivity list
+    template<class Func>
+    auto withIndices(Func &&func) const
+    {
+        if (m_cl32.size() > 0)
+            return func(m_cl32.data());
+        return func(m_numCorners > 0 ? m_cl.data() : static_cast<const Index *>(nullptr));
+    }
 
     const ShmArrayProxy<Byte> &ghost() const { return m_ghost; }
     void setGhost(Index index, bool isGhost);
@@ -44,16 +81,26 @@ public:
     Vector3 cellCenter(Index elem) const override;
 
 private:
-    void createCelltree(Index nelem, const Index *cl) const;
+    template<typename I>
+    void createCelltree(Index nelem, const I *cl) const;
+
+    void widenIndices() const;
+    [[noreturn]] void throwCompact() const;
 
     mutable ShmArrayProxy<Index> m_cl;
     mutable ShmArrayProxy<Byte> m_ghost;
+    mutable ShmArrayProxy<Index32> m_cl32;
+    mutable std::atomic<bool> m_widen{false}; // m_cl has to be created from m_cl32
+    mutable std::mutex m_widenMutex;
+    mutable std::vector<Index> m_clWide;
+    mutable std::string m_wideSource; // name of compact array that m_clWide has been created from
     mutable Index m_numCorners = 0;
     mutable Celltree::const_ptr m_celltree;
 
     V_DATA_BEGIN(Ngons);
     ShmVector<Index> cl;
     ShmVector<Byte> ghost; //< ghost bit list: indicate if cell is ghost bit
+    ShmVector<Index32> cl32; //< compact connectivity list, replaces cl if not empty
 
     Data(const size_t numCorners = 0, const size_t numCoords = 0, const std::string &name = "",
          const Meta &meta = Meta());
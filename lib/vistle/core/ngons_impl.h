@@ -10,14 +10,22 @@ void Ngons<N>::Data::serialize(Archive &ar)
     ar &V_NAME(ar, "base_coords", serialize_base<Base::Data>(ar, *this));
     ar &V_NAME(ar, "connection_list", cl);
     ar &V_NAME(ar, "ghost_list", ghost);
+    // attributes have already been restored by the base class
+    if (hasAttribute(CompactIndicesAttribute))
+        ar &V_NAME(ar, "compact_connection_list", cl32);
 }
 
 template<int N>
 void Ngons<N>::print(std::ostream &os, bool verbose) const
 {
     Base::print(os, verbose);
-    os << " cl:";
-    d()->cl.print(os, verbose);
+    if (hasCompactIndices()) {
+        os << " cl32:";
+        d()->cl32.print(os, verbose);
+    } else {
+        os << " cl:";
+        d()->cl.print(os, verbose);
+    }
     os << " ghost:";
     d()->ghost.print(os, verbose);
 }
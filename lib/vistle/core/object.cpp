@@ -5,6 +5,7 @@
 
 #include "shm.h"
 #include "vector.h"
+#include "index.h"
 #include <cassert>
 
 #include "archives.h"
@@ -679,7 +680,14 @@ void Object::copyAttributes(Object::const_ptr src, bool replace)
     if (!src)
         return;
 
+    // how indices are stored is a property of this object's data, it must not be taken over from src
+    const bool compact = hasAttribute(CompactIndicesAttribute);
     d()->copyAttributes(src->d(), replace);
+    if (compact) {
+        d()->setAttributeList(CompactIndicesAttribute, {});
+    } else {
+        d()->attributes.erase(Data::Key(CompactIndicesAttribute, Shm::the().allocator()));
+    }
 }
 
 bool Object::hasAttribute(const std::string &key) const
@@ -482,6 +482,14 @@ std::shared_ptr<Parameter> ParameterManager::findParameter(const std::string &na
     return it->second.param;
 }
 
+std::vector<std::string> ParameterManager::getParameterNames() const
+{
+    std::vector<std::string> names;
+    for (const auto &p: m_parameters)
+        names.push_back(p.first);
+    return names;
+}
+
 
 StringParameter *ParameterManager::addStringParameter(const std::string &name, const std::string &description,
                                                       const std::string &value, Parameter::Presentation p)
@@ -103,6 +103,7 @@ public:
     virtual bool removeParameter(const std::string &name);
 
     std::shared_ptr<Parameter> findParameter(const std::string &name) const;
+    std::vector<std::string> getParameterNames() const;
 
     void init();
     void quit();
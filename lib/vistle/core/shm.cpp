@@ -3,12 +3,14 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 //#include <iomanip>
 //#include <boost/mpl/vector.hpp>
 #include <boost/mpl/for_each.hpp>
 //#include <boost/mpl/transform.hpp>
 
 #include <climits>
+#include <algorithm>
 #ifdef _WIN32
 #define RUNNING_ON_VALGRIND 0
 #else
@@ -23,10 +25,18 @@
 #include "shm_reference.h"
 #include "object.h"
 #include "shm_reference_impl.h"
+#include "shm_fill.h"
+
+#include <vistle/util/affinity.h>
 
 #include "celltree.h"
 //#include "archives_config.h"
 
+#ifndef NO_SHMEM
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#endif
+
 namespace interprocess = boost::interprocess;
 
 namespace vistle {
@@ -52,8 +62,33 @@ size_t memorySize<8>()
 }
 
 Shm *Shm::s_singleton = nullptr;
+bool Shm::s_compactIndices = false;
+size_t Shm::s_budget = 0;
 #ifndef NO_SHMEM
 bool Shm::s_perRank = false;
+size_t Shm::s_segmentSize = 0;
+bool Shm::s_hugePages = false;
+
+namespace {
+const unsigned HandleSegmentShift = 48;
+const shm_handle_t HandleOffsetMask = (shm_handle_t(1) << HandleSegmentShift) - 1;
+// arrays of at least this size are allocated from additional segments in segmented mode
+const size_t SegmentThreshold = size_t(1) << 20;
+// default number of slots in the directory of named objects and arrays
+const size_t DirectorySize = size_t(1) << 18;
+} // namespace
+
+// bookkeeping for additional segments, stored in the first segment
+struct ShmSegmentTable {
+    interprocess::interprocess_mutex mutex; // protects creation of segments
+    uint64_t segmentSize = 0; // size of additional segments, 0: not segmented
+    std::atomic<uint32_t> numSegments = 1; // including the first segment
+    std::atomic<uint32_t> lastUsed = 0; // segment allocated from most recently
+    bool hugePages = false; // back segments with transparent huge pages
+    std::atomic<int32_t> numaNode = -1; // bind segments to this NUMA node, if not negative
+
+    ShmSegmentTable(uint64_t segmentSize, bool hugePages): segmentSize(segmentSize), hugePages(hugePages) {}
+};
 #endif
 #ifdef SHMDEBUG
 #ifdef NO_SHMEM
@@ -85,6 +120,11 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
 , m_shm(nullptr)
 #endif
 {
+#ifndef NO_SHMEM
+    for (auto &seg: m_segments)
+        seg = nullptr;
+#endif
+
 #ifdef SHMDEBUG
     if (size > 0) {
         std::cerr << "SHMDEBUG: won't remove shm " << name() << std::endl;
@@ -92,11 +132,28 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
     }
 #endif
 
+    if (const char *compact = getenv("VISTLE_COMPACT_INDICES")) {
+        s_compactIndices = atoi(compact) != 0;
+    }
+    if (const char *budget = getenv("VISTLE_SHM_BUDGET")) {
+        s_budget = atol(budget);
+    }
+    if (const char *touch = getenv("VISTLE_SHM_FIRST_TOUCH")) {
+        ShmFill::setFirstTouch(atoi(touch) != 0);
+    }
+
 #ifdef NO_SHMEM
     (void)size;
     m_allocator = new void_allocator();
     m_objectDictionaryMutex = new std::recursive_mutex;
 #else
+    if (const char *arena = getenv("VISTLE_SHM_ARENA")) {
+        ShmArena::setEnabled(atoi(arena) != 0);
+    }
+    if (const char *dedup = getenv("VISTLE_SHM_DEDUP")) {
+        ShmContentIndex::setEnabled(atoi(dedup) != 0);
+    }
+
     if (size > 0) {
         m_shm = new managed_shm(interprocess::open_or_create, name().c_str(), size);
     } else {
@@ -108,6 +165,25 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
     m_objectDictionaryMutex =
         m_shm->find_or_construct<interprocess::interprocess_recursive_mutex>("shm_dictionary_mutex")();
 
+    m_segments[0] = m_shm;
+    if (size > 0) {
+        m_segmentTable = m_shm->find_or_construct<ShmSegmentTable>("shm_segments")(s_segmentSize, s_hugePages);
+        size_t dirsize = DirectorySize;
+        if (const char *env = getenv("VISTLE_SHM_DIRECTORY_SIZE")) {
+            dirsize = atol(env);
+        }
+        m_directory = m_shm->find_or_construct<ShmDirectory>("shm_directory")(dirsize, m_shm->get_segment_manager());
+        m_contentIndex = m_shm->find_or_construct<ShmContentIndex>("shm_content_index")(m_shm->get_segment_manager());
+    } else {
+        m_segmentTable = m_shm->find<ShmSegmentTable>("shm_segments").first;
+        assert(m_segmentTable && "shared memory does not contain segment table");
+        m_directory = m_shm->find<ShmDirectory>("shm_directory").first;
+        assert(m_directory && "shared memory does not contain object directory");
+        m_contentIndex = m_shm->find<ShmContentIndex>("shm_content_index").first;
+        assert(m_contentIndex && "shared memory does not contain content index");
+    }
+    applyPlacement(m_shm);
+
 #ifdef SHMDEBUG
     s_shmdebugMutex = m_shm->find_or_construct<interprocess::interprocess_recursive_mutex>("shmdebug_mutex")();
     s_shmdebug =
@@ -119,9 +195,20 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
 Shm::~Shm()
 {
 #ifndef NO_SHMEM
+    ShmArena::invalidate();
+    unsigned numSeg = m_segmentTable ? m_segmentTable->numSegments.load() : 1;
+    for (unsigned i = 1; i < MaxSegments; ++i) {
+        delete m_segments[i].exchange(nullptr);
+    }
     if (m_remove) {
+        for (unsigned i = 1; i < numSeg; ++i) {
+            interprocess::shared_memory_object::remove(segmentName(i).c_str());
+        }
         interprocess::shared_memory_object::remove(name().c_str());
-        std::cerr << "removed shm " << name() << std::endl;
+        std::cerr << "removed shm " << name();
+        if (numSeg > 1)
+            std::cerr << " and " << numSeg - 1 << " additional segments";
+        std::cerr << std::endl;
     }
     delete m_shm;
 #endif
@@ -300,6 +387,33 @@ Shm &Shm::the()
     return *s_singleton;
 }
 
+bool Shm::compactIndices()
+{
+    return s_compactIndices;
+}
+
+size_t Shm::budget()
+{
+    return s_budget;
+}
+
+size_t Shm::usedMemory() const
+{
+#ifndef NO_SHMEM
+    size_t used = 0;
+    unsigned numSeg = numSegments();
+    for (unsigned i = 0; i < numSeg; ++i) {
+        managed_shm *seg = m_segments[i].load(std::memory_order_acquire);
+        if (!seg)
+            seg = mapSegment(i);
+        used += seg->get_size() - seg->get_free_memory();
+    }
+    return used;
+#else
+    return 0;
+#endif
+}
+
 bool Shm::perRank()
 {
 #ifndef NO_SHMEM
@@ -323,9 +437,86 @@ void Shm::setExternalSuffix(const std::string &suffix)
 bool Shm::remove(const std::string &name, const int id, const int rank, bool perRank)
 {
     std::string n = shmSegName(name, rank, perRank);
+#ifndef NO_SHMEM
+    // also remove additional segments left over from a previous session
+    for (unsigned i = 1; i < MaxSegments; ++i) {
+        if (!interprocess::shared_memory_object::remove(shmSegName(name + "_s" + std::to_string(i), rank, perRank).c_str()))
+            break;
+    }
+#endif
     return interprocess::shared_memory_object::remove(n.c_str());
 }
 
+void Shm::setHugePages(bool enable)
+{
+#ifndef NO_SHMEM
+    s_hugePages = enable;
+#else
+    (void)enable;
+#endif
+}
+
+bool Shm::bindToNumaNode(int node)
+{
+#ifndef NO_SHMEM
+    if (node < 0)
+        return false;
+    m_segmentTable->numaNode = node;
+    bool ok = true;
+    for (unsigned i = 0; i < MaxSegments; ++i) {
+        if (auto seg = m_segments[i].load())
+            ok &= bind_memory_to_numa_node(seg->get_address(), seg->get_size(), node);
+    }
+    return ok;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+std::string Shm::placement() const
+{
+    std::stringstream str;
+#ifndef NO_SHMEM
+    str << "huge pages: " << (m_segmentTable->hugePages ? "transparent" : "off") << " (shmem_enabled "
+        << shmem_huge_pages_mode() << "), NUMA node: ";
+    int node = m_segmentTable->numaNode;
+    if (node >= 0)
+        str << node;
+    else
+        str << "not bound";
+    size_t used = m_shm->get_size() - m_shm->get_free_memory();
+    str << ", " << memory_placement(m_shm->get_address(), used);
+#else
+    str << "no shared memory";
+#endif
+    return str.str();
+}
+
+#ifndef NO_SHMEM
+void Shm::applyPlacement(managed_shm *seg) const
+{
+    if (m_segmentTable->hugePages)
+        advise_huge_pages(seg->get_address(), seg->get_size());
+    int node = m_segmentTable->numaNode;
+    if (node >= 0)
+        bind_memory_to_numa_node(seg->get_address(), seg->get_size(), node);
+}
+#endif
+
+void Shm::setSegmentSize(size_t size)
+{
+#ifndef NO_SHMEM
+    if (sizeof(shm_handle_t) < 8) {
+        std::cerr << "Shm: segmented mode requires 64 bit handles" << std::endl;
+        return;
+    }
+    s_segmentSize = size;
+#else
+    (void)size;
+#endif
+}
+
 bool Shm::record(const std::string &segname)
 {
     // store name of shared memory segment for possible clean up
@@ -347,6 +538,15 @@ Shm &Shm::create(const std::string &name, const int id, const int rank, bool per
     if (!s_singleton) {
         record(name);
         size_t memsize = memorySize<sizeof(void *)>();
+#ifndef NO_SHMEM
+        if (const char *segsize = getenv("VISTLE_SHM_SEGMENT_SIZE")) {
+            setSegmentSize(atol(segsize));
+        }
+        if (s_segmentSize > 0) {
+            // only objects and small arrays go to the first segment
+            memsize = s_segmentSize;
+        }
+#endif
         if (const char *shmsize = getenv("VISTLE_SHM_SIZE")) {
             memsize = atol(shmsize);
         }
@@ -487,6 +687,18 @@ void Shm::markAsRemoved(const std::string &name)
 #endif
 }
 
+#ifndef NO_SHMEM
+ShmDirectory &Shm::directory() const
+{
+    return *m_directory;
+}
+
+ShmContentIndex &Shm::contentIndex() const
+{
+    return *m_contentIndex;
+}
+#endif
+
 void Shm::addObject(const std::string &name, const shm_handle_t &handle)
 {
 #ifdef SHMDEBUG
@@ -506,18 +718,27 @@ void Shm::addArray(const std::string &name, const ShmData *array)
 #endif
 }
 
+#ifndef NO_SHMEM
+shm_handle_t Shm::handleFromAddress(const void *p) const
+{
+    const unsigned numSeg = numSegments();
+    for (unsigned i = 0; i < numSeg; ++i) {
+        auto seg = m_segments[i].load(std::memory_order_acquire);
+        if (!seg)
+            continue;
+        if (seg->belongs_to_segment(p))
+            return makeHandle(i, seg->get_handle_from_address(p));
+    }
+    return 0;
+}
+#endif
+
 shm_handle_t Shm::getHandleFromObject(Object::const_ptr object) const
 {
 #ifdef NO_SHMEM
     return object->d();
 #else
-    try {
-        return m_shm->get_handle_from_address(object->d());
-
-    } catch (interprocess::interprocess_exception &) {
-    }
-
-    return 0;
+    return getHandleFromObject(object.get());
 #endif
 }
 
@@ -527,7 +748,7 @@ shm_handle_t Shm::getHandleFromObject(const Object *object) const
     return object->d();
 #else
     try {
-        return m_shm->get_handle_from_address(object->d());
+        return handleFromAddress(object->d());
 
     } catch (interprocess::interprocess_exception &) {
     }
@@ -542,7 +763,7 @@ shm_handle_t Shm::getHandleFromArray(const ShmData *array) const
     return const_cast<ShmData *>(array);
 #else
     try {
-        return m_shm->get_handle_from_address(array);
+        return handleFromAddress(array);
 
     } catch (interprocess::interprocess_exception &) {
     }
@@ -551,6 +772,197 @@ shm_handle_t Shm::getHandleFromArray(const ShmData *array) const
 #endif
 }
 
+shm_handle_t Shm::makeHandle(unsigned segment, shm_handle_t offset)
+{
+#ifdef NO_SHMEM
+    assert(segment == 0);
+    return offset;
+#else
+    assert((offset & ~HandleOffsetMask) == 0);
+    return (shm_handle_t(segment) << HandleSegmentShift) | offset;
+#endif
+}
+
+unsigned Shm::handleSegment(const shm_handle_t &handle)
+{
+#ifdef NO_SHMEM
+    return 0;
+#else
+    return unsigned(handle >> HandleSegmentShift);
+#endif
+}
+
+shm_handle_t Shm::handleOffset(const shm_handle_t &handle)
+{
+#ifdef NO_SHMEM
+    return handle;
+#else
+    return handle & HandleOffsetMask;
+#endif
+}
+
+void *Shm::getAddressFromHandle(const shm_handle_t &handle) const
+{
+#ifdef NO_SHMEM
+    return handle;
+#else
+    const unsigned seg = handleSegment(handle);
+    if (seg >= numSegments()) {
+        std::cerr << "Shm::getAddressFromHandle: invalid segment in handle " << handle << std::endl;
+        return nullptr;
+    }
+    return segmentAddress(seg, handleOffset(handle));
+#endif
+}
+
+bool Shm::segmented() const
+{
+    return segmentSize() > 0;
+}
+
+size_t Shm::segmentSize() const
+{
+#ifdef NO_SHMEM
+    return 0;
+#else
+    return m_segmentTable->segmentSize;
+#endif
+}
+
+unsigned Shm::numSegments() const
+{
+#ifdef NO_SHMEM
+    return 1;
+#else
+    return m_segmentTable->numSegments;
+#endif
+}
+
+#ifndef NO_SHMEM
+std::string Shm::segmentName(unsigned segment) const
+{
+    if (segment == 0)
+        return name();
+    return shmSegName(instanceName() + "_s" + std::to_string(segment), m_rank, perRank());
+}
+
+managed_shm *Shm::mapSegment(unsigned segment) const
+{
+    assert(segment < MaxSegments);
+    std::lock_guard<std::mutex> guard(m_segmentMutex);
+    if (auto seg = m_segments[segment].load())
+        return seg;
+    assert(segment < numSegments());
+    auto seg = new managed_shm(interprocess::open_only, segmentName(segment).c_str());
+    applyPlacement(seg);
+    m_segments[segment] = seg;
+    return seg;
+}
+
+void *Shm::allocateInSegment(size_t bytes, unsigned &segment, shm_handle_t &offset)
+{
+    if (!segmented())
+        return nullptr;
+
+    auto tryAllocate = [this, bytes, &segment, &offset](unsigned seg) -> void * {
+        managed_shm *s = m_segments[seg].load(std::memory_order_acquire);
+        if (!s)
+            s = mapSegment(seg);
+        void *p = s->allocate_aligned(bytes, ShmArrayAlignment, std::nothrow);
+        if (p) {
+            segment = seg;
+            offset = s->get_handle_from_address(p);
+            m_segmentTable->lastUsed = seg;
+        }
+        return p;
+    };
+
+    // try most recently used segment first, then all others
+    unsigned numSeg = numSegments();
+    unsigned last = m_segmentTable->lastUsed;
+    if (last > 0 && last < numSeg) {
+        if (void *p = tryAllocate(last))
+            return p;
+    }
+    for (unsigned seg = numSeg - 1; seg > 0; --seg) {
+        if (seg == last)
+            continue;
+        if (void *p = tryAllocate(seg))
+            return p;
+    }
+
+    interprocess::scoped_lock<interprocess::interprocess_mutex> lock(m_segmentTable->mutex);
+    // another process might have created a segment in the meantime
+    for (unsigned seg = numSeg; seg < numSegments(); ++seg) {
+        if (void *p = tryAllocate(seg))
+            return p;
+    }
+
+    unsigned seg = numSegments();
+    if (seg >= MaxSegments) {
+        std::cerr << "Shm: cannot create more than " << MaxSegments << " segments" << std::endl;
+        return nullptr;
+    }
+    size_t size = std::max(size_t(m_segmentTable->segmentSize), bytes + bytes / 8 + 65536);
+    std::string segname = segmentName(seg);
+    managed_shm *s = nullptr;
+    try {
+        interprocess::shared_memory_object::remove(segname.c_str());
+        s = new managed_shm(interprocess::create_only, segname.c_str(), size);
+        applyPlacement(s);
+    } catch (interprocess::interprocess_exception &ex) {
+        std::cerr << "Shm: failed to create segment " << segname << " of size " << size << ": " << ex.what()
+                  << std::endl;
+        return nullptr;
+    }
+    record(instanceName() + "_s" + std::to_string(seg));
+    {
+        std::lock_guard<std::mutex> guard(m_segmentMutex);
+        m_segments[seg] = s;
+    }
+    m_segmentTable->numSegments = seg + 1;
+    return tryAllocate(seg);
+}
+
+void Shm::deallocateInSegment(unsigned segment, shm_handle_t offset)
+{
+    assert(segment > 0);
+    assert(segment < numSegments());
+    managed_shm *s = m_segments[segment].load(std::memory_order_acquire);
+    if (!s)
+        s = mapSegment(segment);
+    s->deallocate(s->get_address_from_handle(offset));
+}
+
+bool ShmSegments::enabled()
+{
+    return Shm::isAttached() && Shm::the().segmented();
+}
+
+size_t ShmSegments::threshold()
+{
+    return SegmentThreshold;
+}
+
+void *ShmSegments::allocate(size_t bytes, uint32_t &segment, shm_handle_t &offset)
+{
+    unsigned seg = 0;
+    void *p = Shm::the().allocateInSegment(bytes, seg, offset);
+    segment = seg;
+    return p;
+}
+
+void ShmSegments::deallocate(uint32_t segment, shm_handle_t offset)
+{
+    Shm::the().deallocateInSegment(segment, offset);
+}
+
+void *ShmSegments::address(uint32_t segment, shm_handle_t offset)
+{
+    return Shm::the().segmentAddress(segment, offset);
+}
+#endif
+
 Object::const_ptr Shm::getObjectFromHandle(const shm_handle_t &handle) const
 {
     Object::const_ptr ret;
@@ -581,7 +993,9 @@ ObjectData *Shm::getObjectDataFromHandle(const shm_handle_t &handle) const
     return od;
 #else
     try {
-        Object::Data *od = static_cast<Object::Data *>(m_shm->get_address_from_handle(handle));
+        Object::Data *od = static_cast<Object::Data *>(getAddressFromHandle(handle));
+        if (!od)
+            return nullptr;
         assert(od->shmtype == ShmData::OBJECT);
         return od;
     } catch (interprocess::interprocess_exception &) {
@@ -37,6 +37,10 @@
 #include "shmname.h"
 #include "shmdata.h"
 #include "shm_config.h"
+#ifndef NO_SHMEM
+#include "shm_directory.h"
+#include "shm_dedup.h"
+#endif
 
 #if defined(BOOST_INTERPROCESS_POSIX_BARRIERS) && defined(BOOST_INTERPROCESS_POSIX_PROCESS_SHARED)
 #define SHMBARRIER
@@ -75,6 +79,9 @@ class Object;
 struct ObjectData;
 template<class T, class allocator>
 class shm_array;
+#ifndef NO_SHMEM
+struct ShmSegmentTable;
+#endif
 
 #ifdef SHMDEBUG
 struct ShmDebugInfo {
@@ -100,6 +107,11 @@ struct shm {
     typedef std::basic_string<T> string;
     typedef std::vector<T> vector;
     typedef array *array_ptr;
+#else
+    typedef boost::interprocess::basic_string<T, std::char_traits<T>, allocator> string;
+    typedef boost::interprocess::vector<T, allocator> vector;
+    typedef boost::interprocess::offset_ptr<array> array_ptr;
+#endif
     struct Constructor {
         std::string name;
 
@@ -112,13 +124,6 @@ struct shm {
     {
         return Constructor(name);
     }
-#else
-    typedef boost::interprocess::basic_string<T, std::char_traits<T>, allocator> string;
-    typedef boost::interprocess::vector<T, allocator> vector;
-    typedef boost::interprocess::offset_ptr<array> array_ptr;
-    static typename managed_shm::segment_manager::template construct_proxy<T>::type construct(const std::string &name);
-
-#endif
     template<class Func>
     static void atomic_func(Func &f);
     static T *find(const std::string &name);
@@ -145,8 +150,18 @@ public:
     static Shm &create(const std::string &shmname, int moduleID, int rank, bool perRank);
     static Shm &attach(const std::string &shmname, int moduleID, int rank, bool perRank);
     static bool isAttached();
+    // place large arrays into additional segments of this size, which are created when required
+    // (has to be called before create, VISTLE_SHM_SEGMENT_SIZE has the same effect)
+    static void setSegmentSize(size_t size);
+    // back shared memory with transparent huge pages (has to be called before create)
+    static void setHugePages(bool enable);
     //let external applications create a unique shm array by attaching a suffix Vistle's shm names
     static void setExternalSuffix(const std::string &suffix);
+    // whether connectivity of objects should be stored with 32 bit indices on publication, if Index is wider
+    // (VISTLE_COMPACT_INDICES)
+    static bool compactIndices();
+    // bytes of shared memory that should not be exceeded on this node, 0 for no limit (VISTLE_SHM_BUDGET)
+    static size_t budget();
 
     void detach();
     void setRemoveOnDetach();
@@ -161,6 +176,12 @@ public:
     int numRanksOnThisNode() const;
     void setNodeRanks(const std::vector<int> &nodeRanks);
     int nodeRank(int rank) const;
+    // bind all segments, including those created later on, to a NUMA node
+    bool bindToNumaNode(int node);
+    // description of configured and actual placement of shared memory pages
+    std::string placement() const;
+    // bytes allocated in all segments
+    size_t usedMemory() const;
 
 #ifdef NO_SHMEM
     typedef vistle::default_init_allocator<void> void_allocator;
@@ -185,6 +206,26 @@ public:
     shm_handle_t getHandleFromArray(const ShmData *array) const;
     ObjectData *getObjectDataFromName(const std::string &name) const;
     ObjectData *getObjectDataFromHandle(const shm_handle_t &handle) const;
+    void *getAddressFromHandle(const shm_handle_t &handle) const;
+
+    // handles encode segment number in their upper bits, handles into the first segment are plain offsets
+    static shm_handle_t makeHandle(unsigned segment, shm_handle_t offset);
+    static unsigned handleSegment(const shm_handle_t &handle);
+    static shm_handle_t handleOffset(const shm_handle_t &handle);
+
+    bool segmented() const;
+    size_t segmentSize() const;
+    unsigned numSegments() const;
+#ifndef NO_SHMEM
+    void *allocateInSegment(size_t bytes, unsigned &segment, shm_handle_t &offset);
+    void deallocateInSegment(unsigned segment, shm_handle_t offset);
+    void *segmentAddress(unsigned segment, shm_handle_t offset) const
+    {
+        if (auto seg = m_segments[segment].load(std::memory_order_acquire))
+            return static_cast<char *>(seg->get_address()) + offset;
+        return static_cast<char *>(mapSegment(segment)->get_address()) + offset;
+    }
+#endif
     std::shared_ptr<const Object> getObjectFromName(const std::string &name, bool onlyComplete = true) const;
     template<typename T>
     const ShmVector<T> getArrayFromName(const std::string &name) const;
@@ -194,6 +235,10 @@ public:
     static bool record(const std::string &segname);
 
     void markAsRemoved(const std::string &name);
+#ifndef NO_SHMEM
+    ShmDirectory &directory() const;
+    ShmContentIndex &contentIndex() const;
+#endif
     void addObject(const std::string &name, const shm_handle_t &handle);
     void addArray(const std::string &name, const ShmData *array);
 #ifdef SHMDEBUG
@@ -228,13 +273,28 @@ private:
     std::vector<int> m_nodeRanks; // mapping of global rank to ranks on each node
     std::atomic<int> m_objectId, m_arrayId;
     static Shm *s_singleton;
+    static bool s_compactIndices;
+    static size_t s_budget;
 #ifdef NO_SHMEM
     mutable std::recursive_mutex *m_objectDictionaryMutex;
     std::map<std::string, shm_handle_t> m_objectDictionary;
 #else
     static bool s_perRank;
+    static size_t s_segmentSize;
+    static bool s_hugePages;
     mutable boost::interprocess::interprocess_recursive_mutex *m_objectDictionaryMutex;
     managed_shm *m_shm;
+
+    static const unsigned MaxSegments = 1024;
+    std::string segmentName(unsigned segment) const;
+    managed_shm *mapSegment(unsigned segment) const;
+    void applyPlacement(managed_shm *seg) const;
+    shm_handle_t handleFromAddress(const void *p) const;
+    ShmSegmentTable *m_segmentTable = nullptr;
+    ShmDirectory *m_directory = nullptr;
+    ShmContentIndex *m_contentIndex = nullptr;
+    mutable std::mutex m_segmentMutex; // protects mapping of additional segments
+    mutable std::array<std::atomic<managed_shm *>, MaxSegments> m_segments;
 #endif
 #ifdef SHMBARRIER
 #ifndef NO_SHMEM
@@ -276,7 +336,13 @@ T *shm<T>::find(const std::string &name)
     atomic_func(lambda);
     return ret;
 #else
-    return Shm::the().shm().find<T>(name.c_str()).first;
+    auto &s = Shm::the();
+    shm_handle_t handle = 0;
+    if (s.directory().lookup(name, handle))
+        return static_cast<T *>(s.getAddressFromHandle(handle));
+    if (!s.directory().overflowed())
+        return nullptr;
+    return s.shm().find<T>(name.c_str()).first;
 #endif
 }
 
@@ -299,6 +365,21 @@ T *shm<T>::find_and_ref(const std::string &name)
     atomic_func(lambda);
     return ret;
 #else
+    auto &s = Shm::the();
+    auto &dir = s.directory();
+    {
+        ShmDirectory::lock_type lock(dir.mutex(name));
+        shm_handle_t handle = 0;
+        if (dir.lookup(name, handle)) {
+            T *t = static_cast<T *>(s.getAddressFromHandle(handle));
+            t->ref();
+            assert(t->refcount() > 0);
+            return t;
+        }
+    }
+    if (!dir.overflowed())
+        return nullptr;
+
     T *t = nullptr;
     auto lambda = [&name, &t]() {
         t = static_cast<T *>(static_cast<void *>(shm<char>::find(name)));
@@ -334,8 +415,13 @@ bool shm<T>::destroy(const std::string &name)
     std::cerr << "WARNING: shm: did not find object " << name << " to be deleted" << std::endl;
     return false;
 #else
-    const bool ret = Shm::the().shm().destroy<T>(name.c_str());
-    Shm::the().markAsRemoved(name);
+    auto &s = Shm::the();
+    {
+        ShmDirectory::lock_type lock(s.directory().mutex(name));
+        s.directory().remove(name);
+    }
+    const bool ret = s.shm().destroy<T>(name.c_str());
+    s.markAsRemoved(name);
     return ret;
 #endif
 }
@@ -343,6 +429,32 @@ bool shm<T>::destroy(const std::string &name)
 template<typename T>
 bool shm<T>::destroy_array(const std::string &name, shm<T>::array_ptr arr)
 {
+#ifndef NO_SHMEM
+    auto &s = Shm::the();
+    auto &dir = s.directory();
+    bool remove = false;
+    {
+        // lookups of arrays are serialized with their removal by this lock instead of the global one
+        ShmDirectory::lock_type lock(dir.mutex(name));
+        shm_handle_t handle = 0;
+        if (dir.lookup(name, handle)) {
+            if (arr->refcount() > 0)
+                return true;
+            dir.remove(name);
+            if (arr->contentHash())
+                s.contentIndex().remove(arr->contentHash(), name);
+            remove = true;
+        }
+    }
+    if (remove) {
+        const bool ret = s.shm().destroy<array>(name.c_str());
+        s.markAsRemoved(name);
+        return ret;
+    }
+    if (!dir.overflowed())
+        return false;
+#endif
+
     bool ret = false;
     auto lambda = [&name, &arr, &ret]() {
         if (arr->refcount() > 0) {
@@ -350,13 +462,16 @@ bool shm<T>::destroy_array(const std::string &name, shm<T>::array_ptr arr)
             return;
         }
         assert(arr->refcount() == 0);
+#ifndef NO_SHMEM
+        if (arr->contentHash())
+            Shm::the().contentIndex().remove(arr->contentHash(), name);
+#endif
         ret = shm<shm<T>::array>::destroy(name);
     };
     atomic_func(lambda);
     return ret;
 }
 
-#ifdef NO_SHMEM
 template<typename T>
 shm<T>::Constructor::Constructor(const std::string &name): name(name)
 {}
@@ -365,6 +480,18 @@ template<typename T>
 shm<T>::Constructor::~Constructor()
 {}
 
+#ifndef NO_SHMEM
+template<typename T>
+template<typename... Args>
+T *shm<T>::Constructor::operator()(Args &&...args)
+{
+    auto &s = Shm::the();
+    T *ret = s.shm().construct<T>(name.c_str())(std::forward<Args>(args)...);
+    // named objects are always located in the first segment
+    s.directory().insert(name, Shm::makeHandle(0, s.shm().get_handle_from_address(ret)));
+    return ret;
+}
+#else
 template<typename T>
 template<typename... Args>
 T *shm<T>::Constructor::operator()(Args &&...args)
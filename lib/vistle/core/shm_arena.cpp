@@ -0,0 +1,384 @@
+#include "shm_arena.h"
+
+#ifndef NO_SHMEM
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include <boost/interprocess/detail/utilities.hpp>
+
+namespace vistle {
+
+namespace {
+
+// size classes: 64 bytes, then 4 classes per power of two up to MaxClassSize
+constexpr unsigned MinClassShift = 6;
+constexpr size_t MinClassSize = size_t(1) << MinClassShift;
+constexpr unsigned MaxClassShift = 18;
+constexpr size_t MaxClassSize = size_t(1) << MaxClassShift;
+constexpr unsigned NumClasses = (MaxClassShift - MinClassShift) * 4 + 1;
+
+// bytes to carve from the segment manager at once when a bin runs empty
+constexpr size_t BatchBytes = 64 << 10;
+constexpr size_t MaxBatch = 32;
+
+typedef ShmArena::segment_manager segment_manager;
+
+std::atomic<unsigned> s_generation(1);
+std::atomic<bool> s_enabled(true);
+
+unsigned highestBit(size_t n)
+{
+    assert(n > 0);
+    unsigned bit = 0;
+    while (n >>= 1)
+        ++bit;
+    return bit;
+}
+
+unsigned sizeClass(size_t bytes)
+{
+    assert(bytes <= MaxClassSize);
+    if (bytes <= MinClassSize)
+        return 0;
+    const size_t n = bytes - 1;
+    const unsigned p = highestBit(n);
+    const size_t q = n >> (p - 2);
+    assert(q >= 4 && q < 8);
+    return (p - MinClassShift) * 4 + unsigned(q - 4) + 1;
+}
+
+size_t classSize(unsigned cls)
+{
+    if (cls == 0)
+        return MinClassSize;
+    const unsigned p = (cls - 1) / 4 + MinClassShift;
+    const size_t q = (cls - 1) % 4 + 4;
+    return (q + 1) << (p - 2);
+}
+
+// aligned blocks are carved from ordinary blocks padded by the alignment,
+// so that they can be allocated in batches like all others
+size_t alignedSize(unsigned cls)
+{
+    return classSize(cls) + ShmArena::Alignment;
+}
+
+// the distance to the start of the underlying block is stored in the byte preceding an aligned block
+void *alignBlock(void *raw)
+{
+    auto addr = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = (addr + ShmArena::Alignment) & ~uintptr_t(ShmArena::Alignment - 1);
+    auto p = reinterpret_cast<unsigned char *>(aligned);
+    p[-1] = static_cast<unsigned char>(aligned - addr);
+    return p;
+}
+
+void *unalignBlock(void *p)
+{
+    auto aligned = static_cast<unsigned char *>(p);
+    return aligned - aligned[-1];
+}
+
+size_t batchCount(size_t size)
+{
+    size_t count = BatchBytes / size;
+    if (count < 1)
+        count = 1;
+    if (count > MaxBatch)
+        count = MaxBatch;
+    return count;
+}
+
+struct ThreadCache;
+
+// all thread caches, so that they can be drained before detaching from a segment
+std::mutex &registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<ThreadCache *> &registry()
+{
+    static std::vector<ThreadCache *> caches;
+    return caches;
+}
+
+struct ThreadCache {
+    std::mutex mutex; // only contended while the cache is drained by another thread
+    segment_manager *mngr = nullptr;
+    unsigned generation = 0;
+    std::array<std::vector<void *>, NumClasses> bins;
+    std::array<std::vector<void *>, NumClasses> alignedBins;
+    ShmArena::Stats stats;
+
+    ThreadCache()
+    {
+        std::lock_guard<std::mutex> guard(registryMutex());
+        registry().push_back(this);
+    }
+
+    ~ThreadCache()
+    {
+        std::lock_guard<std::mutex> guard(registryMutex());
+        auto &caches = registry();
+        caches.erase(std::find(caches.begin(), caches.end(), this));
+        std::lock_guard<std::mutex> lock(mutex);
+        flush();
+    }
+
+    bool valid() const { return mngr && generation == s_generation; }
+
+    void drop()
+    {
+        for (auto &bin: bins)
+            bin.clear();
+        for (auto &bin: alignedBins)
+            bin.clear();
+        stats.cachedBytes = 0;
+        mngr = nullptr;
+    }
+
+    void flush()
+    {
+        if (!valid()) {
+            drop();
+            return;
+        }
+        for (unsigned cls = 0; cls < NumClasses; ++cls) {
+            release(cls, bins[cls].size());
+            releaseAligned(cls, alignedBins[cls].size());
+        }
+        assert(stats.cachedBytes == 0);
+        mngr = nullptr;
+    }
+
+    // return count blocks from the back of bin to the segment manager
+    void release(std::vector<void *> &bin, size_t size, size_t count)
+    {
+        assert(count <= bin.size());
+        if (count == 0)
+            return;
+        segment_manager::multiallocation_chain chain;
+        for (size_t i = bin.size() - count; i < bin.size(); ++i) {
+            chain.push_back(bin[i]);
+        }
+        mngr->deallocate_many(chain);
+        bin.resize(bin.size() - count);
+        stats.cachedBytes -= count * size;
+        ++stats.flushes;
+    }
+
+    void release(unsigned cls, size_t count) { release(bins[cls], classSize(cls), count); }
+
+    void releaseAligned(unsigned cls, size_t count) { release(alignedBins[cls], alignedSize(cls), count); }
+
+    void refill(std::vector<void *> &bin, size_t size)
+    {
+        segment_manager::multiallocation_chain chain;
+        try {
+            mngr->allocate_many(size, batchCount(size), chain);
+        } catch (std::bad_alloc &) {
+            // not enough space left for a whole batch: try without a reserve
+            bin.push_back(mngr->allocate(size));
+            stats.cachedBytes += size;
+            return;
+        }
+        while (!chain.empty()) {
+            bin.push_back(boost::interprocess::ipcdetail::to_raw_pointer(chain.pop_front()));
+            stats.cachedBytes += size;
+        }
+        ++stats.refills;
+    }
+
+    void refill(unsigned cls) { refill(bins[cls], classSize(cls)); }
+
+    void refillAligned(unsigned cls) { refill(alignedBins[cls], alignedSize(cls)); }
+
+    void attach(segment_manager *m)
+    {
+        if (mngr == m && valid())
+            return;
+        flush();
+        mngr = m;
+        generation = s_generation;
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+} // namespace
+
+void *ShmArena::allocate(segment_manager *mngr, size_t bytes)
+{
+    if (bytes > MaxClassSize) {
+        return mngr->allocate(bytes);
+    }
+
+    // always allocate whole size classes, so that blocks may be cached regardless of when they were allocated
+    const unsigned cls = sizeClass(bytes);
+    const size_t size = classSize(cls);
+    if (!enabled()) {
+        return mngr->allocate(size);
+    }
+
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.attach(mngr);
+    auto &bin = cache.bins[cls];
+    if (bin.empty()) {
+        ++cache.stats.misses;
+        cache.refill(cls);
+    } else {
+        ++cache.stats.hits;
+    }
+    assert(!bin.empty());
+    void *p = bin.back();
+    bin.pop_back();
+    cache.stats.cachedBytes -= size;
+    return p;
+}
+
+void ShmArena::deallocate(segment_manager *mngr, void *p, size_t bytes)
+{
+    if (!p)
+        return;
+    if (bytes > MaxClassSize || !enabled()) {
+        mngr->deallocate(p);
+        return;
+    }
+
+    const unsigned cls = sizeClass(bytes);
+    const size_t size = classSize(cls);
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.attach(mngr);
+    auto &bin = cache.bins[cls];
+    bin.push_back(p);
+    cache.stats.cachedBytes += size;
+    const size_t batch = batchCount(size);
+    if (bin.size() > 2 * batch) {
+        cache.release(cls, batch);
+    }
+}
+
+void *ShmArena::allocateAligned(segment_manager *mngr, size_t bytes)
+{
+    if (bytes > MaxClassSize) {
+        return mngr->allocate_aligned(bytes, Alignment);
+    }
+
+    // padded blocks regardless of enabled(), as they might be returned by another process
+    const unsigned cls = sizeClass(bytes);
+    const size_t size = alignedSize(cls);
+    if (!enabled()) {
+        return alignBlock(mngr->allocate(size));
+    }
+
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.attach(mngr);
+    auto &bin = cache.alignedBins[cls];
+    if (bin.empty()) {
+        ++cache.stats.misses;
+        cache.refillAligned(cls);
+    } else {
+        ++cache.stats.hits;
+    }
+    assert(!bin.empty());
+    void *p = bin.back();
+    bin.pop_back();
+    cache.stats.cachedBytes -= size;
+    return alignBlock(p);
+}
+
+void ShmArena::deallocateAligned(segment_manager *mngr, void *p, size_t bytes)
+{
+    if (!p)
+        return;
+    if (bytes > MaxClassSize) {
+        mngr->deallocate(p);
+        return;
+    }
+    if (!enabled()) {
+        mngr->deallocate(unalignBlock(p));
+        return;
+    }
+
+    const unsigned cls = sizeClass(bytes);
+    const size_t size = alignedSize(cls);
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.attach(mngr);
+    auto &bin = cache.alignedBins[cls];
+    bin.push_back(unalignBlock(p));
+    cache.stats.cachedBytes += size;
+    const size_t batch = batchCount(size);
+    if (bin.size() > 2 * batch) {
+        cache.releaseAligned(cls, batch);
+    }
+}
+
+void ShmArena::release()
+{
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.flush();
+}
+
+void ShmArena::invalidate()
+{
+    // return blocks cached by any thread while the segment is still mapped,
+    // and keep all caches locked until they cannot be revalidated for the old segment
+    std::lock_guard<std::mutex> guard(registryMutex());
+    auto &caches = registry();
+    for (auto *cache: caches) {
+        cache->mutex.lock();
+        cache->flush();
+    }
+    ++s_generation;
+    for (auto *cache: caches) {
+        cache->mutex.unlock();
+    }
+}
+
+void ShmArena::setEnabled(bool enable)
+{
+    if (!enable)
+        release();
+    s_enabled = enable;
+}
+
+bool ShmArena::enabled()
+{
+    return s_enabled;
+}
+
+size_t ShmArena::maxCachedSize()
+{
+    return MaxClassSize;
+}
+
+size_t ShmArena::roundedSize(size_t bytes)
+{
+    if (bytes > MaxClassSize)
+        return bytes;
+    return classSize(sizeClass(bytes));
+}
+
+ShmArena::Stats ShmArena::stats()
+{
+    auto &cache = t_cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    return cache.stats;
+}
+
+} // namespace vistle
+
+#endif
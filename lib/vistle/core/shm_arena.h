@@ -0,0 +1,148 @@
+#ifndef VISTLE_CORE_SHM_ARENA_H
+#define VISTLE_CORE_SHM_ARENA_H
+
+#ifndef NO_SHMEM
+
+#include <cstddef>
+#include <new>
+
+#include <vistle/util/boost_interprocess_config.h>
+#ifdef _WIN32
+#include <boost/interprocess/managed_windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/managed_shared_memory.hpp>
+#endif
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+
+#include "export.h"
+
+namespace vistle {
+
+#ifdef _WIN32
+typedef boost::interprocess::managed_windows_shared_memory managed_shm;
+#else
+typedef boost::interprocess::managed_shared_memory managed_shm;
+#endif
+
+// Per-thread cache of shared memory blocks binned by size class.
+// Blocks are carved from the segment manager in batches and returned to it in batches,
+// so that concurrently allocating threads only rarely have to take the segment manager's mutex.
+// Requests larger than maxCachedSize() are passed on to the segment manager directly.
+class V_COREEXPORT ShmArena {
+public:
+    typedef managed_shm::segment_manager segment_manager;
+
+    struct Stats {
+        size_t hits = 0; // allocations served from the thread cache
+        size_t misses = 0; // allocations requiring the segment manager
+        size_t refills = 0; // batched allocations from the segment manager
+        size_t flushes = 0; // batched deallocations to the segment manager
+        size_t cachedBytes = 0; // bytes currently held in the cache
+    };
+
+    // alignment of blocks returned by allocateAligned, suitable for aligned SIMD loads
+    static constexpr size_t Alignment = 64;
+
+    static void *allocate(segment_manager *mngr, size_t bytes);
+    static void deallocate(segment_manager *mngr, void *p, size_t bytes);
+    // aligned blocks are cached separately from the others and have to be returned with deallocateAligned
+    static void *allocateAligned(segment_manager *mngr, size_t bytes);
+    static void deallocateAligned(segment_manager *mngr, void *p, size_t bytes);
+
+    // return all blocks cached by the calling thread to the segment manager
+    static void release();
+    // return blocks cached by all threads to the segment manager and invalidate the caches,
+    // has to be called before detaching from a segment
+    static void invalidate();
+
+    static void setEnabled(bool enable);
+    static bool enabled();
+    static size_t maxCachedSize();
+    // size that is actually allocated for a request of size bytes
+    static size_t roundedSize(size_t bytes);
+
+    // statistics for the calling thread
+    static Stats stats();
+};
+
+// allocator for shared memory that can be used in place of boost::interprocess::allocator,
+// but it only implements the "version 1" interface of Boost.Container
+// so that all allocations go through the thread caches of ShmArena
+template<typename T>
+class shm_arena_allocator {
+    template<typename U>
+    friend class shm_arena_allocator;
+
+public:
+    typedef ShmArena::segment_manager segment_manager;
+    typedef typename segment_manager::void_pointer void_pointer;
+    typedef boost::interprocess::offset_ptr<segment_manager> segment_manager_ptr;
+
+    typedef T value_type;
+    typedef typename boost::intrusive::pointer_traits<void_pointer>::template rebind_pointer<T>::type pointer;
+    typedef
+        typename boost::intrusive::pointer_traits<void_pointer>::template rebind_pointer<const T>::type const_pointer;
+    typedef typename segment_manager::size_type size_type;
+    typedef typename segment_manager::difference_type difference_type;
+
+    template<typename U>
+    struct rebind {
+        typedef shm_arena_allocator<U> other;
+    };
+
+    shm_arena_allocator(segment_manager *mngr): m_mngr(mngr) {}
+
+    shm_arena_allocator(const shm_arena_allocator &other): m_mngr(other.m_mngr) {}
+
+    template<typename U>
+    shm_arena_allocator(const shm_arena_allocator<U> &other): m_mngr(other.m_mngr)
+    {}
+
+    template<typename U>
+    shm_arena_allocator(const boost::interprocess::allocator<U, segment_manager> &other)
+    : m_mngr(other.get_segment_manager())
+    {}
+
+    shm_arena_allocator &operator=(const shm_arena_allocator &other)
+    {
+        m_mngr = other.m_mngr;
+        return *this;
+    }
+
+    segment_manager *get_segment_manager() const { return m_mngr.get(); }
+
+    size_type max_size() const { return m_mngr->get_size() / sizeof(T); }
+
+    pointer allocate(size_type count)
+    {
+        if (count > max_size())
+            throw std::bad_alloc();
+        return pointer(static_cast<value_type *>(ShmArena::allocate(m_mngr.get(), count * sizeof(T))));
+    }
+
+    void deallocate(const pointer &ptr, size_type count)
+    {
+        ShmArena::deallocate(m_mngr.get(), boost::interprocess::ipcdetail::to_raw_pointer(ptr), count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const shm_arena_allocator<U> &other) const
+    {
+        return m_mngr == other.m_mngr;
+    }
+
+    template<typename U>
+    bool operator!=(const shm_arena_allocator<U> &other) const
+    {
+        return m_mngr != other.m_mngr;
+    }
+
+private:
+    segment_manager_ptr m_mngr;
+};
+
+} // namespace vistle
+
+#endif
+#endif
@@ -3,9 +3,11 @@
 
 #include <cassert>
 #include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <type_traits>
 #include <ostream>
+#include <span>
 
 #include "export.h"
 #include "index.h"
@@ -82,49 +84,69 @@ public:
     const_iterator begin() const
     {
         updateFromHandle();
-        return &*m_data;
+        return ptr();
     }
     const_iterator end() const
     {
         updateFromHandle();
-        return (&*m_data) + m_size;
+        return ptr() + m_size;
     }
     iterator begin()
     {
         updateFromHandle(true);
-        return &*m_data;
+        return ptr();
     }
     iterator end()
     {
         updateFromHandle(true);
-        return (&*m_data) + m_size;
+        return ptr() + m_size;
     }
 
     T *data()
     {
         updateFromHandle(true);
-        return &*m_data;
+        return ptr();
     }
     const T *data() const
     {
         updateFromHandle();
-        return &*m_data;
+        return ptr();
     }
 
     T &operator[](const size_t idx)
     {
         updateFromHandle(true);
-        return m_data[idx];
+        return ptr()[idx];
     }
     const T &operator[](const size_t idx) const
     {
         updateFromHandle();
-        return m_data[idx];
+        return ptr()[idx];
     }
 
     T &at(const size_t idx);
     const T &at(const size_t idx) const;
 
+    // true if storage is aligned suitably for aligned SIMD loads
+    bool is_aligned(size_t alignment = ShmArrayAlignment) const
+    {
+        updateFromHandle();
+        return reinterpret_cast<uintptr_t>(ptr()) % alignment == 0;
+    }
+
+    // views of all elements for use in inner loops, synchronized with the ArrayHandle only once:
+    // they stay valid until the array is resized or its ArrayHandle is modified
+    std::span<T> pin()
+    {
+        updateFromHandle(true);
+        return std::span<T>(ptr(), m_size);
+    }
+    std::span<const T> pin() const
+    {
+        updateFromHandle();
+        return std::span<const T>(ptr(), m_size);
+    }
+
     void push_back(const T &v);
 
     template<class... Args>
@@ -134,30 +156,30 @@ public:
         if (m_size >= m_capacity)
             reserve(m_capacity == 0 ? 1 : m_capacity * 2);
         assert(m_size < m_capacity);
-        new (&m_data[m_size]) T(std::forward<Args>(args)...);
+        new (&ptr()[m_size]) T(std::forward<Args>(args)...);
         ++m_size;
     }
 
     T &back()
     {
         updateFromHandle(true);
-        return m_data[m_size - 1];
+        return ptr()[m_size - 1];
     }
     T &front()
     {
         updateFromHandle(true);
-        return m_data[0];
+        return ptr()[0];
     }
 
     const T &back() const
     {
         updateFromHandle();
-        return m_data[m_size - 1];
+        return ptr()[m_size - 1];
     }
     const T &front() const
     {
         updateFromHandle();
-        return m_data[0];
+        return ptr()[0];
     }
     bool empty() const
     {
@@ -213,7 +235,33 @@ public:
 
     void print(std::ostream &os, bool verbose = false) const;
 
+#ifndef NO_SHMEM
+    // hash of contents and layout, used for finding arrays with identical contents
+    uint64_t computeContentHash() const;
+    bool sameContents(const shm_array &other) const;
+    // hash under which this array has been registered for deduplication, 0 if not registered
+    uint64_t contentHash() const
+    {
+        return m_contentHash;
+    }
+    void setContentHash(uint64_t hash)
+    {
+        m_contentHash = hash;
+    }
+#endif
+
 private:
+    T *ptr() const
+    {
+#ifdef NO_SHMEM
+        return m_data;
+#else
+        if (m_segment == 0)
+            return m_data.get();
+        return static_cast<T *>(ShmSegments::address(m_segment, m_offset));
+#endif
+    }
+
     const uint32_t m_type;
     size_t m_size = 0;
     size_t m_dim[3] = {0, 1, 1};
@@ -235,6 +283,9 @@ private:
 #else
     pointer m_data = nullptr;
     allocator m_allocator;
+    uint32_t m_segment = 0; // data is located at m_offset in an additional segment if not 0
+    shm_handle_t m_offset = 0;
+    uint64_t m_contentHash = 0;
 #endif
 
     ARCHIVE_ACCESS_SPLIT
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <atomic>
 #include <cstring>
+#include <memory>
 #include <type_traits>
 #include <iostream>
 
@@ -13,6 +14,8 @@
 #include "index.h"
 #include "archives_config.h"
 #include "shmdata.h"
+#include "shm_dedup.h"
+#include "shm_fill.h"
 #include <viskores/cont/ArrayRangeCompute.h>
 #include <boost/mpl/for_each.hpp>
 
@@ -75,9 +78,15 @@ shm_array<T, allocator>::shm_array(shm_array &&other)
 , m_handle(other.m_handle)
 #else
 , m_allocator(other.m_allocator)
+, m_segment(other.m_segment)
+, m_offset(other.m_offset)
 #endif
 {
     other.m_data = nullptr;
+#ifndef NO_SHMEM
+    other.m_segment = 0;
+    other.m_offset = 0;
+#endif
     other.m_size = 0;
     other.m_capacity = 0;
     other.invalidate_bounds();
@@ -117,7 +126,7 @@ void shm_array<T, allocator>::setHandle(const ArrayHandle &h)
     assert(m_size == 0 || bounds_valid());
 #else
     resize(h.GetNumberOfValues());
-    viskores::cont::ArrayHandleBasic<handle_type> handle(reinterpret_cast<handle_type *>(m_data.get()), m_size,
+    viskores::cont::ArrayHandleBasic<handle_type> handle(reinterpret_cast<handle_type *>(ptr()), m_size,
                                                          [](void *) {});
     viskores::cont::ArrayCopy(h, handle);
     handle.SyncControlArray();
@@ -155,7 +164,7 @@ T &shm_array<T, allocator>::at(const size_t idx)
     updateFromHandle(true);
     if (idx >= m_size)
         throw(std::out_of_range("shm_array"));
-    return m_data[idx];
+    return ptr()[idx];
 }
 
 template<typename T, class allocator>
@@ -164,7 +173,7 @@ const T &shm_array<T, allocator>::at(const size_t idx) const
     updateFromHandle();
     if (idx >= m_size)
         throw(std::out_of_range("shm_array"));
-    return m_data[idx];
+    return ptr()[idx];
 }
 
 template<typename T, class allocator>
@@ -174,7 +183,7 @@ void shm_array<T, allocator>::push_back(const T &v)
     if (m_size >= m_capacity)
         reserve(m_capacity == 0 ? 1 : m_capacity * 2);
     assert(m_size < m_capacity);
-    new (&m_data[m_size]) T(v);
+    new (&ptr()[m_size]) T(v);
     ++m_size;
 }
 
@@ -194,7 +203,11 @@ void shm_array<T, allocator>::resize(const size_t size)
     reserve(size);
     if (!std::is_trivially_copyable<T>::value) {
         for (size_t i = m_size; i < size; ++i)
-            new (&m_data[i]) T();
+            new (&ptr()[i]) T();
+    } else if (size > m_size && ShmFill::firstTouch()) {
+        T *p = ptr() + m_size;
+        ShmFill::forChunks(size - m_size, sizeof(T),
+                           [p](size_t b, size_t e) { ::memset(static_cast<void *>(p + b), 0, (e - b) * sizeof(T)); });
     }
     m_size = size;
     clearDimensionHint();
@@ -208,8 +221,14 @@ void shm_array<T, allocator>::resize(const size_t size, const T &value)
 
     updateFromHandle(true);
     reserve(size);
-    for (size_t i = m_size; i < size; ++i)
-        new (&m_data[i]) T(value);
+    if (std::is_trivially_copyable<T>::value && size > m_size) {
+        T *p = ptr() + m_size;
+        ShmFill::forChunks(size - m_size, sizeof(T),
+                           [p, &value](size_t b, size_t e) { std::uninitialized_fill(p + b, p + e, value); });
+    } else {
+        for (size_t i = m_size; i < size; ++i)
+            new (&ptr()[i]) T(value);
+    }
     m_size = size;
     clearDimensionHint();
 }
@@ -235,7 +254,7 @@ shm_array<T, allocator>::handle() const
 template<typename T, class allocator>
 const viskores::cont::ArrayHandle<typename shm_array<T, allocator>::handle_type> shm_array<T, allocator>::handle() const
 {
-    return viskores::cont::make_ArrayHandle(reinterpret_cast<const handle_type *>(m_data.get()), m_size,
+    return viskores::cont::make_ArrayHandle(reinterpret_cast<const handle_type *>(ptr()), m_size,
                                             viskores::CopyFlag::Off);
 }
 #endif
@@ -313,26 +332,57 @@ void shm_array<T, allocator>::reserve_or_shrink(const size_t capacity)
         m_data = nullptr;
     }
 #else
-    pointer new_data = capacity > 0 ? m_allocator.allocate(capacity) : nullptr;
+    pointer new_data = nullptr;
+    uint32_t new_segment = 0;
+    shm_handle_t new_offset = 0;
+    T *new_ptr = nullptr;
+    if (capacity > 0) {
+        // large arrays go to additional segments, if these are available
+        bool segmented = ShmSegments::enabled();
+        if (segmented && capacity * sizeof(T) >= ShmSegments::threshold()) {
+            new_ptr = static_cast<T *>(ShmSegments::allocate(capacity * sizeof(T), new_segment, new_offset));
+        }
+        if (!new_ptr) {
+            try {
+                new_data = pointer(static_cast<T *>(
+                    ShmArena::allocateAligned(m_allocator.get_segment_manager(), capacity * sizeof(T))));
+                new_ptr = new_data.get();
+            } catch (std::bad_alloc &) {
+                if (!segmented)
+                    throw;
+                new_ptr = static_cast<T *>(ShmSegments::allocate(capacity * sizeof(T), new_segment, new_offset));
+                if (!new_ptr)
+                    throw;
+            }
+        }
+    }
+    T *old_ptr = ptr();
     const size_t n = capacity < m_size ? capacity : m_size;
-    if (m_data && new_data) {
+    if (old_ptr && new_ptr) {
         if (std::is_trivially_copyable<T>::value) {
-            ::memcpy(&*new_data, &*m_data, sizeof(T) * n);
+            ShmFill::forChunks(n, sizeof(T), [new_ptr, old_ptr](size_t b, size_t e) {
+                ::memcpy(new_ptr + b, old_ptr + b, sizeof(T) * (e - b));
+            });
         } else {
             for (size_t i = 0; i < n; ++i) {
-                new (&new_data[i]) T(std::move(m_data[i]));
+                new (&new_ptr[i]) T(std::move(old_ptr[i]));
             }
         }
     }
-    if (m_data) {
+    if (old_ptr) {
         if (!std::is_trivially_copyable<T>::value) {
             for (size_t i = n; i < m_size; ++i) {
-                m_data[i].~T();
+                old_ptr[i].~T();
             }
         }
-        m_allocator.deallocate(m_data, m_capacity);
+        if (m_segment == 0)
+            ShmArena::deallocateAligned(m_allocator.get_segment_manager(), m_data.get(), m_capacity * sizeof(T));
+        else
+            ShmSegments::deallocate(m_segment, m_offset);
     }
     m_data = new_data;
+    m_segment = new_segment;
+    m_offset = new_offset;
     m_capacity = capacity;
 #endif
 }
@@ -361,12 +411,46 @@ void shm_array<T, allocator>::update_bounds()
     updateFromHandle();
     invalidate_bounds();
 
-    if (!m_data)
+    const T *p = ptr();
+    if (!p)
         return;
 
-    for (auto it = begin(); it != end(); ++it) {
-        m_min = std::min(m_min, *it);
-        m_max = std::max(m_max, *it);
+    if constexpr (std::is_arithmetic<T>::value) {
+        // independent lanes without data dependencies between them allow for vectorization,
+        // comparisons are ordered like std::min/std::max, so that NaNs are skipped
+        constexpr size_t Lanes = ShmArrayAlignment / sizeof(T) >= 4 ? ShmArrayAlignment / sizeof(T) : 4;
+        T lmin[Lanes], lmax[Lanes];
+        for (size_t l = 0; l < Lanes; ++l) {
+            lmin[l] = m_min;
+            lmax[l] = m_max;
+        }
+        const size_t n = m_size - m_size % Lanes;
+        auto reduce = [&lmin, &lmax](const T *a, size_t n) {
+            for (size_t i = 0; i < n; i += Lanes) {
+                for (size_t l = 0; l < Lanes; ++l) {
+                    const T v = a[i + l];
+                    lmin[l] = v < lmin[l] ? v : lmin[l];
+                    lmax[l] = lmax[l] < v ? v : lmax[l];
+                }
+            }
+        };
+        if (is_aligned())
+            reduce(std::assume_aligned<ShmArrayAlignment>(p), n);
+        else
+            reduce(p, n);
+        for (size_t l = 0; l < Lanes; ++l) {
+            m_min = std::min(m_min, lmin[l]);
+            m_max = std::max(m_max, lmax[l]);
+        }
+        for (size_t i = n; i < m_size; ++i) {
+            m_min = std::min(m_min, p[i]);
+            m_max = std::max(m_max, p[i]);
+        }
+    } else {
+        for (auto it = begin(); it != end(); ++it) {
+            m_min = std::min(m_min, *it);
+            m_max = std::max(m_max, *it);
+        }
     }
 }
 
@@ -377,6 +461,33 @@ void shm_array<T, allocator>::set_bounds(T min, T max)
     m_max = max;
 }
 
+#ifndef NO_SHMEM
+template<typename T, class allocator>
+uint64_t shm_array<T, allocator>::computeContentHash() const
+{
+    PROF_SCOPE("shm_array::computeContentHash()");
+    updateFromHandle();
+    uint64_t seed = ShmContentIndex::hash(m_dim, sizeof(m_dim), (uint64_t(m_type) << 1) | m_exact);
+    return ShmContentIndex::hash(ptr(), m_size * sizeof(T), seed);
+}
+
+template<typename T, class allocator>
+bool shm_array<T, allocator>::sameContents(const shm_array &other) const
+{
+    if (m_type != other.m_type || m_size != other.m_size || m_exact != other.m_exact)
+        return false;
+    for (int c = 0; c < 3; ++c) {
+        if (m_dim[c] != other.m_dim[c])
+            return false;
+    }
+    updateFromHandle();
+    other.updateFromHandle();
+    if (m_size == 0)
+        return true;
+    return memcmp(ptr(), other.ptr(), m_size * sizeof(T)) == 0;
+}
+#endif
+
 template<typename T, class allocator>
 template<class Archive>
 void shm_array<T, allocator>::save(Archive &ar) const
@@ -388,9 +499,9 @@ void shm_array<T, allocator>::save(Archive &ar) const
     //std::cerr << "saving array: exact=" << m_exact << ", size=" << m_size << std::endl;
     if (m_size > 0) {
         if (m_dim[0] * m_dim[1] * m_dim[2] == m_size)
-            ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(&m_data[0], m_exact, m_dim[0], m_dim[1], m_dim[2]));
+            ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(ptr(), m_exact, m_dim[0], m_dim[1], m_dim[2]));
         else
-            ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(&m_data[0], m_exact, m_size));
+            ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(ptr(), m_exact, m_size));
     }
     ar &V_NAME(ar, "min", m_min);
     ar &V_NAME(ar, "max", m_max);
@@ -456,9 +567,9 @@ void shm_array<T, allocator>::load(Archive &ar)
         if (m_size > 0) {
             if (m_dim[0] * m_dim[1] * m_dim[2] == m_size)
                 ar &V_NAME(ar, "elements",
-                           detail::wrap_array<Archive>(&m_data[0], m_exact, m_dim[0], m_dim[1], m_dim[2]));
+                           detail::wrap_array<Archive>(ptr(), m_exact, m_dim[0], m_dim[1], m_dim[2]));
             else
-                ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(&m_data[0], m_exact, m_size));
+                ar &V_NAME(ar, "elements", detail::wrap_array<Archive>(ptr(), m_exact, m_size));
         }
         ar &V_NAME(ar, "min", m_min);
         ar &V_NAME(ar, "max", m_max);
@@ -493,7 +604,7 @@ void shm_array<T, allocator>::print(std::ostream &os, bool verbose) const
     if (verbose) {
         os << ":";
         for (size_t i = 0; i < size(); ++i) {
-            os << " " << Printable<T>::value(m_data[i]);
+            os << " " << Printable<T>::value(ptr()[i]);
         }
     }
     os << "]";
@@ -1,33 +1,44 @@
 #ifndef VISTLE_CORE_SHM_CONFIG_H
 #define VISTLE_CORE_SHM_CONFIG_H
 
+#include <cstddef>
+
 #ifdef NO_SHMEM
+#include <vistle/util/allocator.h>
 #include "shmdata.h"
 #else
-#ifdef _WIN32
-#include <boost/interprocess/managed_windows_shared_memory.hpp>
-#else
-#include <boost/interprocess/managed_shared_memory.hpp>
-#endif
+#include <cstdint>
+#include "shm_arena.h"
+#include "export.h"
 #endif
 
 
 namespace vistle {
 
+// alignment of array storage, sufficient for aligned loads of a whole cache line
+constexpr size_t ShmArrayAlignment = 64;
+
 #ifdef NO_SHMEM
 typedef ShmData *shm_handle_t;
 template<typename T>
-using shm_allocator = vistle::default_init_allocator<T>;
+using shm_allocator = vistle::default_init_allocator<T, vistle::aligned_allocator<T, ShmArrayAlignment>>;
 #else
-#ifdef _WIN32
-typedef boost::interprocess::managed_windows_shared_memory managed_shm;
-#else
-typedef boost::interprocess::managed_shared_memory managed_shm;
-#endif
-
 typedef managed_shm::handle_t shm_handle_t;
 template<typename T>
-using shm_allocator = boost::interprocess::allocator<T, managed_shm::segment_manager>;
+using shm_allocator = vistle::shm_arena_allocator<T>;
+static_assert(ShmArena::Alignment >= ShmArrayAlignment, "arena blocks not aligned sufficiently for arrays");
+
+// storage for large arrays in additional segments that are mapped on demand,
+// only available if segmented mode has been enabled when creating shared memory
+struct V_COREEXPORT ShmSegments {
+    static bool enabled();
+    // arrays of at least this many bytes are placed into additional segments
+    static size_t threshold();
+    // returns nullptr if no space is available
+    static void *allocate(size_t bytes, uint32_t &segment, shm_handle_t &offset);
+    static void deallocate(uint32_t segment, shm_handle_t offset);
+    static void *address(uint32_t segment, shm_handle_t offset);
+};
 #endif
 
 } // namespace vistle
@@ -0,0 +1,158 @@
+#include "shm_dedup.h"
+
+#ifndef NO_SHMEM
+
+#include <cstring>
+
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+namespace vistle {
+
+namespace {
+
+// arrays smaller than this are not worth hashing
+const size_t MinSize = 4096;
+
+std::atomic<bool> s_enabled(false);
+
+std::atomic<uint64_t> s_hashed(0);
+std::atomic<uint64_t> s_hashedBytes(0);
+std::atomic<uint64_t> s_deduplicated(0);
+std::atomic<uint64_t> s_savedBytes(0);
+
+const uint64_t Prime1 = 0x9e3779b185ebca87ull;
+const uint64_t Prime2 = 0xc2b2ae3d27d4eb4full;
+
+inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t mix(uint64_t acc, uint64_t word)
+{
+    acc += word * Prime2;
+    acc = rotl(acc, 31);
+    return acc * Prime1;
+}
+
+inline uint64_t load64(const unsigned char *p)
+{
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+} // namespace
+
+ShmContentIndex::ShmContentIndex(managed_shm::segment_manager *mngr)
+: m_entries(std::less<uint64_t>(), shm_arena_allocator<value_type>(mngr))
+{}
+
+bool ShmContentIndex::findOrInsert(uint64_t hash, unsigned type, const std::string &name, std::string &existing)
+{
+    boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        if (it->second.type != type)
+            return false;
+        existing = it->second.name.str();
+        return existing != name;
+    }
+    Entry e;
+    e.name = name;
+    e.type = type;
+    m_entries.emplace(hash, e);
+    return false;
+}
+
+void ShmContentIndex::remove(uint64_t hash, const std::string &name)
+{
+    boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end() && it->second.name == name)
+        m_entries.erase(it);
+}
+
+size_t ShmContentIndex::size() const
+{
+    boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t ShmContentIndex::hash(const void *data, size_t bytes, uint64_t seed)
+{
+    // four independent lanes, so that hashing is not limited by the latency of multiplications
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + bytes;
+    uint64_t acc[4] = {seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1};
+    while (end - p >= 32) {
+        for (int l = 0; l < 4; ++l)
+            acc[l] = mix(acc[l], load64(p + 8 * l));
+        p += 32;
+    }
+    uint64_t h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+    h += bytes;
+    while (end - p >= 8) {
+        h ^= mix(0, load64(p));
+        h = rotl(h, 27) * Prime1 + Prime2;
+        p += 8;
+    }
+    while (p < end) {
+        h ^= *p * Prime1;
+        h = rotl(h, 11) * Prime2;
+        ++p;
+    }
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    return h;
+}
+
+void ShmContentIndex::setEnabled(bool enable)
+{
+    s_enabled = enable;
+}
+
+bool ShmContentIndex::enabled()
+{
+    return s_enabled;
+}
+
+size_t ShmContentIndex::minSize()
+{
+    return MinSize;
+}
+
+void ShmContentIndex::recordHashed(size_t bytes)
+{
+    s_hashed.fetch_add(1, std::memory_order_relaxed);
+    s_hashedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ShmContentIndex::recordDeduplicated(size_t bytes)
+{
+    s_deduplicated.fetch_add(1, std::memory_order_relaxed);
+    s_savedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+ShmContentIndex::Stats ShmContentIndex::stats()
+{
+    Stats s;
+    s.hashed = s_hashed;
+    s.hashedBytes = s_hashedBytes;
+    s.deduplicated = s_deduplicated;
+    s.savedBytes = s_savedBytes;
+    return s;
+}
+
+void ShmContentIndex::resetStats()
+{
+    s_hashed = 0;
+    s_hashedBytes = 0;
+    s_deduplicated = 0;
+    s_savedBytes = 0;
+}
+
+} // namespace vistle
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef VISTLE_CORE_SHM_DEDUP_H
+#define VISTLE_CORE_SHM_DEDUP_H
+
+#ifndef NO_SHMEM
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <vistle/util/boost_interprocess_config.h>
+#include <boost/interprocess/containers/map.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+
+#include "export.h"
+#include "shm_arena.h"
+#include "shmname.h"
+
+namespace vistle {
+
+// Index of the contents of published arrays, used for mapping arrays with identical contents onto a single instance.
+// It is located in shared memory and maps content hashes to the names of the first arrays having been registered.
+// Entries are removed when the registered array is destroyed.
+class V_COREEXPORT ShmContentIndex {
+public:
+    // process-local statistics
+    struct Stats {
+        uint64_t hashed = 0; // arrays hashed
+        uint64_t hashedBytes = 0;
+        uint64_t deduplicated = 0; // arrays replaced by an existing array
+        uint64_t savedBytes = 0;
+    };
+
+    ShmContentIndex(managed_shm::segment_manager *mngr);
+
+    // if an array with the same hash and type is registered, return true and its name in existing,
+    // otherwise register name and return false
+    bool findOrInsert(uint64_t hash, unsigned type, const std::string &name, std::string &existing);
+    // remove entry for hash, if it is registered for name
+    void remove(uint64_t hash, const std::string &name);
+    size_t size() const;
+
+    static uint64_t hash(const void *data, size_t bytes, uint64_t seed = 0);
+
+    static void setEnabled(bool enable);
+    static bool enabled();
+    // smaller arrays are not considered
+    static size_t minSize();
+
+    static void recordHashed(size_t bytes);
+    static void recordDeduplicated(size_t bytes);
+    static Stats stats();
+    static void resetStats();
+
+private:
+    struct Entry {
+        shm_name_t name;
+        uint32_t type = 0;
+    };
+    typedef std::pair<const uint64_t, Entry> value_type;
+    typedef boost::interprocess::map<uint64_t, Entry, std::less<uint64_t>, shm_arena_allocator<value_type>> map_type;
+
+    mutable boost::interprocess::interprocess_mutex m_mutex;
+    map_type m_entries;
+};
+
+} // namespace vistle
+
+#endif
+#endif
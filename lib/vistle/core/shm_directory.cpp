@@ -0,0 +1,427 @@
+#include "shm_directory.h"
+
+#ifndef NO_SHMEM
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace vistle {
+
+namespace {
+
+// sample every n-th lookup for timing
+const uint64_t TimingInterval = 64;
+
+// fraction of slots occupied by removed entries that triggers a rebuild
+const size_t CompactionDivisor = 4;
+
+struct Counters {
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> probes{0};
+    std::atomic<uint64_t> timedLookups{0};
+    std::atomic<uint64_t> timedNanoseconds{0};
+
+    void add(const Counters &other)
+    {
+        lookups += other.lookups;
+        hits += other.hits;
+        probes += other.probes;
+        timedLookups += other.timedLookups;
+        timedNanoseconds += other.timedNanoseconds;
+    }
+
+    void clear()
+    {
+        lookups = 0;
+        hits = 0;
+        probes = 0;
+        timedLookups = 0;
+        timedNanoseconds = 0;
+    }
+};
+
+// only the owning thread updates its counters, so that lookups do not contend on shared cache lines
+void increment(std::atomic<uint64_t> &counter, uint64_t n = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct StatsRegistry {
+    std::mutex mutex;
+    std::vector<Counters *> threads;
+    Counters retired; // counters of threads that have terminated
+};
+
+StatsRegistry &statsRegistry()
+{
+    static StatsRegistry registry;
+    return registry;
+}
+
+struct ThreadCounters: Counters {
+    ThreadCounters()
+    {
+        auto &reg = statsRegistry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        reg.threads.push_back(this);
+    }
+
+    ~ThreadCounters()
+    {
+        auto &reg = statsRegistry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        reg.retired.add(*this);
+        reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+    }
+};
+
+thread_local ThreadCounters t_counters;
+
+size_t roundUpToPowerOfTwo(size_t n)
+{
+    size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+} // namespace
+
+ShmDirectory::ShmDirectory(size_t capacity, managed_shm::segment_manager *mngr)
+: m_capacity(roundUpToPowerOfTwo(capacity < 2 * MaxProbe ? 2 * MaxProbe : capacity)), m_mngr(mngr)
+{
+    void *mem = mngr->allocate_aligned(m_capacity * sizeof(Slot), alignof(Slot));
+    Slot *slots = static_cast<Slot *>(mem);
+    for (size_t i = 0; i < m_capacity; ++i) {
+        new (&slots[i]) Slot;
+    }
+    m_slots = slots;
+}
+
+ShmDirectory::~ShmDirectory()
+{
+    Slot *slots = m_slots.get();
+    for (size_t i = 0; i < m_capacity; ++i) {
+        slots[i].~Slot();
+    }
+    m_mngr->deallocate(slots);
+}
+
+ShmDirectory::Key ShmDirectory::makeKey(const std::string &name)
+{
+    char buf[sizeof(Key)] = {};
+    memcpy(buf, name.data(), std::min(name.size(), sizeof(buf) - 1));
+    Key key;
+    memcpy(key.data(), buf, sizeof(buf));
+    return key;
+}
+
+uint64_t ShmDirectory::hashKey(const Key &key)
+{
+    // FNV-1a on 64 bit words, followed by a finalizer for mixing into the low bits
+    uint64_t h = 14695981039346656037ull;
+    for (auto w: key) {
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+bool ShmDirectory::matches(const Slot &slot, uint64_t hash, const Key &key) const
+{
+    if (slot.hash.load(std::memory_order_relaxed) != hash)
+        return false;
+    for (unsigned i = 0; i < KeyWords; ++i) {
+        if (slot.key[i].load(std::memory_order_relaxed) != key[i])
+            return false;
+    }
+    return true;
+}
+
+ShmDirectory::mutex_type &ShmDirectory::mutex(const std::string &name)
+{
+    return m_stripes[stripe(hashKey(makeKey(name)))];
+}
+
+void ShmDirectory::store(Slot &slot, uint32_t state, uint64_t hash, const Key &key, handle_type handle)
+{
+    const uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.hash.store(hash, std::memory_order_relaxed);
+    for (unsigned k = 0; k < KeyWords; ++k)
+        slot.key[k].store(key[k], std::memory_order_relaxed);
+    slot.handle.store(handle, std::memory_order_relaxed);
+    slot.state.store(state, std::memory_order_relaxed);
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool ShmDirectory::insert(const std::string &name, handle_type handle)
+{
+    const Key key = makeKey(name);
+    const uint64_t hash = hashKey(key);
+
+    if (m_removed > m_capacity / CompactionDivisor)
+        compact();
+
+    {
+        lock_type lock(m_stripes[stripe(hash)]);
+        if (insertLocked(hash, key, handle))
+            return true;
+    }
+
+    if (m_removed > 0) {
+        compact();
+        lock_type lock(m_stripes[stripe(hash)]);
+        if (insertLocked(hash, key, handle))
+            return true;
+    }
+
+    if (!m_overflowed.exchange(true)) {
+        std::cerr << "ShmDirectory: no slot for " << name << " (" << m_size << " entries, capacity " << m_capacity
+                  << "), falling back to segment manager for lookups" << std::endl;
+    }
+    return false;
+}
+
+bool ShmDirectory::insertLocked(uint64_t hash, const Key &key, handle_type handle)
+{
+    Slot *slots = m_slots.get();
+    const size_t home = homeSlot(hash);
+    for (;;) {
+        // scan the whole probe sequence for an existing entry before reusing the first free slot
+        Slot *candidate = nullptr;
+        uint32_t candidateState = Empty;
+        for (unsigned i = 0; i < MaxProbe; ++i) {
+            Slot &slot = slots[(home + i) & (m_capacity - 1)];
+            uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (state == Used) {
+                // entries for the same name can only be changed while holding our lock
+                if (matches(slot, hash, key)) {
+                    slot.handle.store(handle, std::memory_order_release);
+                    return true;
+                }
+                continue;
+            }
+            if (state == Busy)
+                continue;
+            if (!candidate) {
+                candidate = &slot;
+                candidateState = state;
+            }
+            if (state == Empty)
+                break;
+        }
+        if (!candidate)
+            return false;
+
+        // slot might have been claimed for a name from another stripe in the meantime
+        uint32_t state = candidateState;
+        if (!candidate->state.compare_exchange_strong(state, Busy, std::memory_order_acquire))
+            continue;
+        store(*candidate, Used, hash, key, handle);
+        if (candidateState == Removed)
+            --m_removed;
+        ++m_size;
+        return true;
+    }
+}
+
+void ShmDirectory::compact()
+{
+    // lock stripes in a fixed order, callers must not hold any of them
+    for (auto &m: m_stripes)
+        m.lock();
+
+    if (m_removed > 0) {
+        struct Entry {
+            uint64_t hash;
+            Key key;
+            handle_type handle;
+        };
+        std::vector<Entry> entries;
+        entries.reserve(m_size);
+
+        m_rebuilds.fetch_add(1, std::memory_order_acq_rel);
+        Slot *slots = m_slots.get();
+        const Key empty{};
+        for (size_t i = 0; i < m_capacity; ++i) {
+            Slot &slot = slots[i];
+            const uint32_t state = slot.state.load(std::memory_order_relaxed);
+            if (state == Used) {
+                Entry e;
+                e.hash = slot.hash.load(std::memory_order_relaxed);
+                for (unsigned k = 0; k < KeyWords; ++k)
+                    e.key[k] = slot.key[k].load(std::memory_order_relaxed);
+                e.handle = slot.handle.load(std::memory_order_relaxed);
+                entries.push_back(e);
+            }
+            if (state != Empty)
+                store(slot, Empty, 0, empty, 0);
+        }
+        for (const auto &e: entries) {
+            const size_t home = homeSlot(e.hash);
+            for (size_t i = 0;; ++i) {
+                Slot &slot = slots[(home + i) & (m_capacity - 1)];
+                if (slot.state.load(std::memory_order_relaxed) == Empty) {
+                    store(slot, Used, e.hash, e.key, e.handle);
+                    break;
+                }
+            }
+        }
+        m_removed = 0;
+        m_rebuilds.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    for (auto &m: m_stripes)
+        m.unlock();
+}
+
+bool ShmDirectory::lookup(const std::string &name, handle_type &handle) const
+{
+    auto &counters = t_counters;
+    const uint64_t n = counters.lookups.load(std::memory_order_relaxed);
+    increment(counters.lookups);
+    const bool timed = n % TimingInterval == 0;
+    std::chrono::steady_clock::time_point start;
+    if (timed)
+        start = std::chrono::steady_clock::now();
+
+    const Key key = makeKey(name);
+    const uint64_t hash = hashKey(key);
+    const Slot *slots = m_slots.get();
+    const size_t home = homeSlot(hash);
+
+    bool found = false;
+    unsigned i = 0;
+    for (;;) {
+        const uint32_t rebuilds = m_rebuilds.load(std::memory_order_acquire);
+        for (i = 0; i < MaxProbe; ++i) {
+            const Slot &slot = slots[(home + i) & (m_capacity - 1)];
+            uint32_t seq1 = 0, state = Empty;
+            handle_type h = 0;
+            bool match = false;
+            // read a consistent snapshot of the slot
+            for (;;) {
+                seq1 = slot.seq.load(std::memory_order_acquire);
+                if (seq1 & 1)
+                    continue;
+                state = slot.state.load(std::memory_order_relaxed);
+                if (state == Used) {
+                    match = matches(slot, hash, key);
+                    h = slot.handle.load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == seq1)
+                    break;
+            }
+            if (state == Empty)
+                break;
+            if (state == Used && match) {
+                handle = h;
+                found = true;
+                ++i;
+                break;
+            }
+        }
+        // entries are moved while the table is rebuilt
+        if (found || (!(rebuilds & 1) && m_rebuilds.load(std::memory_order_acquire) == rebuilds))
+            break;
+    }
+
+    increment(counters.probes, i);
+    if (found)
+        increment(counters.hits);
+    if (timed) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        increment(counters.timedLookups);
+        increment(counters.timedNanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    return found;
+}
+
+bool ShmDirectory::remove(const std::string &name)
+{
+    const Key key = makeKey(name);
+    const uint64_t hash = hashKey(key);
+    Slot *slots = m_slots.get();
+    const size_t home = homeSlot(hash);
+
+    // caller has to hold mutex(name)
+    for (unsigned i = 0; i < MaxProbe; ++i) {
+        Slot &slot = slots[(home + i) & (m_capacity - 1)];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == Empty)
+            return false;
+        if (state != Used || !matches(slot, hash, key))
+            continue;
+
+        store(slot, Removed, 0, Key{}, 0);
+        ++m_removed;
+        --m_size;
+        return true;
+    }
+    return false;
+}
+
+size_t ShmDirectory::size() const
+{
+    return m_size;
+}
+
+size_t ShmDirectory::capacity() const
+{
+    return m_capacity;
+}
+
+size_t ShmDirectory::removed() const
+{
+    return m_removed;
+}
+
+bool ShmDirectory::overflowed() const
+{
+    return m_overflowed;
+}
+
+ShmDirectory::Stats ShmDirectory::stats()
+{
+    auto &reg = statsRegistry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    Counters sum;
+    sum.add(reg.retired);
+    for (auto *c: reg.threads)
+        sum.add(*c);
+
+    Stats s;
+    s.lookups = sum.lookups;
+    s.hits = sum.hits;
+    s.probes = sum.probes;
+    s.timedLookups = sum.timedLookups;
+    s.timedSeconds = sum.timedNanoseconds * 1e-9;
+    return s;
+}
+
+void ShmDirectory::resetStats()
+{
+    // counts of lookups by other threads that are concurrently in progress may be lost
+    auto &reg = statsRegistry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.retired.clear();
+    for (auto *c: reg.threads)
+        c->clear();
+}
+
+} // namespace vistle
+
+#endif
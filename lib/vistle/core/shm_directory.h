@@ -0,0 +1,112 @@
+#ifndef VISTLE_CORE_SHM_DIRECTORY_H
+#define VISTLE_CORE_SHM_DIRECTORY_H
+
+#ifndef NO_SHMEM
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <vistle/util/boost_interprocess_config.h>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "export.h"
+#include "shm_arena.h"
+
+namespace vistle {
+
+// Open-addressing hash table mapping names of shared memory objects and arrays to their handles.
+// It is located in shared memory and used by all processes attached to a segment.
+// Lookups do not lock, inserting and removing entries is serialized per stripe of names.
+// Slots of removed entries are reused by insertions, and the table is rebuilt once they make up a quarter of it.
+class V_COREEXPORT ShmDirectory {
+public:
+    typedef ptrdiff_t handle_type;
+    typedef boost::interprocess::interprocess_mutex mutex_type;
+    typedef boost::interprocess::scoped_lock<mutex_type> lock_type;
+
+    // process-local statistics, aggregated from per-thread counters
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t probes = 0; // slots inspected
+        uint64_t timedLookups = 0; // lookups sampled for timing
+        double timedSeconds = 0.; // time spent in sampled lookups
+
+        double averageLookupTime() const { return timedLookups > 0 ? timedSeconds / timedLookups : 0.; }
+    };
+
+    ShmDirectory(size_t capacity, managed_shm::segment_manager *mngr);
+    ~ShmDirectory();
+
+    // mutex protecting insertion and removal of name, to be held by callers requiring a stable result of lookup
+    mutex_type &mutex(const std::string &name);
+
+    bool insert(const std::string &name, handle_type handle);
+    bool lookup(const std::string &name, handle_type &handle) const;
+    bool remove(const std::string &name);
+
+    size_t size() const;
+    size_t capacity() const;
+    // number of slots of removed entries that have not been reused yet
+    size_t removed() const;
+    // true if an entry could not be inserted, so that lookups have to fall back to the segment manager
+    bool overflowed() const;
+
+    static Stats stats();
+    static void resetStats();
+
+private:
+    static const unsigned NumStripes = 256;
+    static const unsigned MaxProbe = 128;
+    static const unsigned KeyWords = 4;
+    typedef std::array<uint64_t, KeyWords> Key;
+
+    enum SlotState : uint32_t {
+        Empty,
+        Busy, // claimed for insertion
+        Used,
+        Removed,
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> seq{0}; // odd while contents are being modified
+        std::atomic<uint32_t> state{Empty};
+        std::atomic<uint64_t> hash{0};
+        std::array<std::atomic<uint64_t>, KeyWords> key;
+        std::atomic<handle_type> handle{0};
+
+        Slot()
+        {
+            for (auto &k: key)
+                k = 0;
+        }
+    };
+
+    static Key makeKey(const std::string &name);
+    static uint64_t hashKey(const Key &key);
+    size_t homeSlot(uint64_t hash) const { return (hash >> 8) & (m_capacity - 1); }
+    static unsigned stripe(uint64_t hash) { return hash & (NumStripes - 1); }
+    bool matches(const Slot &slot, uint64_t hash, const Key &key) const;
+    static void store(Slot &slot, uint32_t state, uint64_t hash, const Key &key, handle_type handle);
+    bool insertLocked(uint64_t hash, const Key &key, handle_type handle);
+    // rebuild table without slots of removed entries, locks all stripes
+    void compact();
+
+    size_t m_capacity = 0; // power of two
+    boost::interprocess::offset_ptr<Slot> m_slots;
+    boost::interprocess::offset_ptr<managed_shm::segment_manager> m_mngr;
+    std::atomic<size_t> m_size{0};
+    std::atomic<size_t> m_removed{0};
+    std::atomic<uint32_t> m_rebuilds{0}; // odd while compacting, lookups missing an entry have to retry
+    std::atomic<bool> m_overflowed{false};
+    std::array<mutex_type, NumStripes> m_stripes;
+};
+
+} // namespace vistle
+
+#endif
+#endif
@@ -0,0 +1,49 @@
+#include "shm_fill.h"
+
+#include <vistle/util/taskpool.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace vistle {
+
+namespace {
+
+const size_t Threshold = size_t(1) << 23;
+// no helper is used for less than this many bytes
+const size_t MinChunk = size_t(1) << 21;
+
+std::atomic<bool> s_firstTouch(false);
+
+} // namespace
+
+size_t ShmFill::threshold()
+{
+    return Threshold;
+}
+
+void ShmFill::setFirstTouch(bool enable)
+{
+    s_firstTouch = enable;
+}
+
+bool ShmFill::firstTouch()
+{
+    return s_firstTouch;
+}
+
+void ShmFill::forChunks(size_t count, size_t elementSize, const std::function<void(size_t, size_t)> &func)
+{
+    const size_t bytes = count * elementSize;
+    auto &pool = TaskPool::the();
+    const unsigned nthreads = pool.concurrency();
+    if (bytes < Threshold || nthreads <= 1) {
+        func(0, count);
+        return;
+    }
+    const size_t nchunks = std::min(size_t(nthreads), bytes / MinChunk);
+    pool.forChunks(nchunks,
+                   [count, nchunks, &func](size_t c) { func(count * c / nchunks, count * (c + 1) / nchunks); });
+}
+
+} // namespace vistle
@@ -0,0 +1,27 @@
+#ifndef VISTLE_CORE_SHM_FILL_H
+#define VISTLE_CORE_SHM_FILL_H
+
+#include <cstddef>
+#include <functional>
+
+#include "export.h"
+
+namespace vistle {
+
+// Initialization and copying of large arrays in parallel chunks on the task pool that also executes block tasks,
+// see vistle::TaskPool::forChunks(), the number of threads is limited by vistle::TaskPool::ThreadLimit.
+class V_COREEXPORT ShmFill {
+public:
+    // ranges of at least this many bytes are processed in parallel
+    static size_t threshold();
+
+    // whether uninitialized storage of large arrays of trivially copyable types is zeroed in parallel when resizing
+    static void setFirstTouch(bool enable);
+    static bool firstTouch();
+
+    // call func(begin, end) for chunks covering [0, count) for elements of elementSize bytes
+    static void forChunks(size_t count, size_t elementSize, const std::function<void(size_t, size_t)> &func);
+};
+
+} // namespace vistle
+#endif
@@ -87,15 +87,6 @@ void shm_name_t::load(Archive &ar)
     //std::cerr << "SHM_NAME_T load: '" << name.data() << "'" << std::endl;
 }
 
-#ifdef NO_SHMEM
-#else
-template<typename T>
-typename managed_shm::segment_manager::template construct_proxy<T>::type shm<T>::construct(const std::string &name)
-{
-    return Shm::the().shm().construct<T>(name.c_str());
-}
-#endif
-
 } // namespace vistle
 
 #endif
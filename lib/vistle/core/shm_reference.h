@@ -3,6 +3,7 @@
 
 #include "archives_config.h"
 #include <string>
+#include <vector>
 #include <cassert>
 #include "shmname.h"
 #include "shm_array.h"
@@ -144,6 +145,10 @@ public:
 
     void print(std::ostream &os, bool verbose = false) const;
 
+    // replace with a reference to an existing array with identical contents, if content deduplication is enabled
+    // - to be called only after the array will not be modified anymore
+    bool deduplicate();
+
 private:
     shm_name_t m_name;
 #ifdef NO_SHMEM
@@ -320,6 +325,19 @@ public:
         return *this;
     }
 
+    // refer to process-local data, vec has to outlive this proxy and must not be resized
+    ShmArrayProxy &operator=(const std::vector<T> &vec)
+    {
+#ifdef NO_SHMEM
+        m_arr = nullptr;
+#endif
+        m_data = vec.data();
+        m_size = vec.size();
+        m_handle = viskores::cont::make_ArrayHandle(reinterpret_cast<const handle_type *>(vec.data()), vec.size(),
+                                                    viskores::CopyFlag::Off);
+        return *this;
+    }
+
     operator const T *() const
     {
         updateFromHandle();
@@ -341,6 +359,12 @@ public:
         updateFromHandle();
         return m_data;
     }
+    // read-only view of all elements, see shm_array::pin()
+    std::span<const T> pin() const
+    {
+        updateFromHandle();
+        return std::span<const T>(static_cast<const T *>(m_data), m_size);
+    }
     size_t size() const
     {
         return m_size;
@@ -350,7 +374,7 @@ public:
 #ifdef NO_SHMEM
         if (m_arr) {
             m_handle = m_arr->handle();
-        } else {
+        } else if (!m_data) {
             m_handle = s_nullHandle;
         }
 #endif
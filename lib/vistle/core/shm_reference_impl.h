@@ -92,6 +92,38 @@ void shm_array_ref<T>::load(Archive &ar)
     //std::cerr << "shm_array: first try: this=" << *this << ", ref=" << ref << std::endl;
 }
 
+template<class T>
+bool shm_array_ref<T>::deduplicate()
+{
+#ifdef NO_SHMEM
+    return false;
+#else
+    if (!m_p || !ShmContentIndex::enabled())
+        return false;
+    const size_t bytes = m_p->size() * sizeof(typename T::value_type);
+    if (bytes < ShmContentIndex::minSize())
+        return false;
+    if (m_p->contentHash() != 0) {
+        // has already been registered
+        return false;
+    }
+
+    const uint64_t hash = m_p->computeContentHash();
+    ShmContentIndex::recordHashed(bytes);
+    m_p->setContentHash(hash);
+    std::string existing;
+    if (!Shm::the().contentIndex().findOrInsert(hash, m_p->type(), m_name.str(), existing))
+        return false;
+
+    shm_array_ref other{shm_name_t(existing)};
+    if (!other || !other->sameContents(*m_p))
+        return false;
+    *this = other;
+    ShmContentIndex::recordDeduplicated(bytes);
+    return true;
+#endif
+}
+
 template<class T>
 T &shm_array_ref<T>::operator*()
 {
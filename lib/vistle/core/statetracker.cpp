@@ -999,6 +999,11 @@ bool StateTracker::handle(const message::Message &msg, const char *payload, size
         handled = handlePriv(m);
         break;
     }
+    case TRANSFERSTATISTICS: {
+        const auto &m = msg.as<TransferStatistics>();
+        handled = handlePriv(m, pl);
+        break;
+    }
 
     case COVER:
     case CREATEMODULECOMPOUND:
@@ -1096,6 +1101,13 @@ bool StateTracker::handlePriv(const message::RemoveHub &rm)
 
     runningMap.erase(id);
 
+    for (auto it = m_transferStatistics.begin(); it != m_transferStatistics.end();) {
+        if (it->first.first == id)
+            it = m_transferStatistics.erase(it);
+        else
+            ++it;
+    }
+
     auto it = std::find_if(m_hubs.begin(), m_hubs.end(), [id](const HubData &hub) { return hub.id == id; });
 
     if (it != m_hubs.end()) {
@@ -1372,6 +1384,13 @@ bool StateTracker::handlePriv(const message::ModuleExit &moduleExit)
     } else {
         portTracker()->removeModule(mod);
 
+        for (auto it = m_transferStatistics.begin(); it != m_transferStatistics.end();) {
+            if (it->first.first == mod)
+                it = m_transferStatistics.erase(it);
+            else
+                ++it;
+        }
+
         setModified("exit " + std::to_string(mod));
         for (StateObserver *o: m_observers) {
             o->deleteModule(mod);
@@ -1931,6 +1950,20 @@ bool StateTracker::handlePriv(const message::ItemInfo &info, const buffer &paylo
     return true;
 }
 
+bool StateTracker::handlePriv(const message::TransferStatistics &stats, const buffer &payload)
+{
+    auto pl = message::getPayload<message::TransferStatistics::Payload>(payload);
+    mutex_locker guard(m_stateMutex);
+    m_transferStatistics[std::make_pair(stats.senderId(), stats.rank())] = std::move(pl.entries);
+    return true;
+}
+
+StateTracker::TransferStatisticsMap StateTracker::getTransferStatistics() const
+{
+    mutex_locker guard(m_stateMutex);
+    return m_transferStatistics;
+}
+
 bool StateTracker::handlePriv(const message::SendText &info, const buffer &payload)
 {
     auto pl = message::getPayload<message::SendText::Payload>(payload);
@@ -151,6 +151,10 @@ public:
     std::vector<int> getBusyList() const;
     int getHub(int id) const;
     const HubData &getHubData(int id) const;
+    typedef std::map<std::pair<int, int>, std::vector<message::TransferStatistics::Entry>> TransferStatisticsMap;
+    //! most recently reported statistics of transfers received from remote hubs or, by modules, from other ranks,
+    //! keyed by reporting hub or module and rank
+    TransferStatisticsMap getTransferStatistics() const;
     std::string getModuleName(int id) const;
     std::string getModuleDisplayName(int id) const;
     std::string getModuleCategory(int id) const;
@@ -388,6 +392,7 @@ private:
     bool handlePriv(const message::CloseConnection &close);
     bool handlePriv(const message::Colormap &colormap, const buffer &payload);
     bool handlePriv(const message::RemoveColormap &rmcm);
+    bool handlePriv(const message::TransferStatistics &stats, const buffer &payload);
 
     HubData *getModifiableHubData(int id);
 
@@ -416,6 +421,8 @@ private:
     size_t m_numObjects = 0;
     size_t m_aggregatedPayload = 0;
 
+    TransferStatisticsMap m_transferStatistics;
+
     mutable mutex m_stateMutex;
 
     int m_workflowLoader = message::Id::Invalid;
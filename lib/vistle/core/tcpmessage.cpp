@@ -152,12 +152,19 @@ struct SendRequest {
     std::shared_ptr<buffer> payload;
     std::shared_ptr<MessagePayload> payloadShm;
     std::shared_ptr<socket_t> payloadSocket;
+    size_t payloadOffset = 0;
+    size_t payloadLength = ~size_t(0); //!< whole payload
     std::function<void(error_code)> handler;
     SendRequest(socket_t &sock, const message::Message &msg, std::shared_ptr<buffer> payload,
                 std::function<void(error_code)> handler)
     : sock(sock), msg(msg), payload(payload), handler(handler)
     {}
 
+    SendRequest(socket_t &sock, const message::Message &msg, std::shared_ptr<buffer> payload, size_t offset,
+                size_t size, std::function<void(error_code)> handler)
+    : sock(sock), msg(msg), payload(payload), payloadOffset(offset), payloadLength(size), handler(handler)
+    {}
+
     SendRequest(socket_t &sock, const message::Message &msg, std::shared_ptr<socket_t> payloadSocket,
                 std::function<void(error_code)> handler)
     : sock(sock), msg(msg), payloadSocket(payloadSocket), handler(handler)
@@ -168,6 +175,15 @@ struct SendRequest {
     : sock(sock), msg(msg), payloadShm(std::make_shared<MessagePayload>(payload)), handler(handler)
     {}
 
+    size_t length() const
+    {
+        if (!payload)
+            return 0;
+        if (payloadLength != ~size_t(0))
+            return payloadLength;
+        return payload->size();
+    }
+
     void operator()()
     {
         error_code ec;
@@ -179,8 +195,8 @@ struct SendRequest {
                 n = 0;
             }
         } else if (payload) {
-            if (n >= payload->size()) {
-                n -= payload->size();
+            if (n >= length()) {
+                n -= length();
             } else {
                 n = 0;
             }
@@ -196,7 +212,10 @@ struct SendRequest {
                 payload = get_buffer(0);
             }
 #endif
-            sent = send(sock, msg, ec, payload.get());
+            if (payload && payloadLength != ~size_t(0))
+                sent = send(sock, msg, ec, payload->data() + payloadOffset, payloadLength);
+            else
+                sent = send(sock, msg, ec, payload.get());
         }
 
         if (sent && payloadSocket) {
@@ -253,7 +272,7 @@ void submitSendRequest(std::shared_ptr<SendRequest> req)
 
 } // namespace
 
-bool recv_payload(socket_t &sock, message::Buffer &msg, error_code &ec, buffer *payload)
+bool recv_payload(socket_t &sock, const message::Message &msg, error_code &ec, char *data)
 {
     if (msg.payloadSize() > 0) {
 #ifdef DEBUG
@@ -279,19 +298,13 @@ bool recv_payload(socket_t &sock, message::Buffer &msg, error_code &ec, buffer *
             return false;
         }
 #endif
-        buffer pl;
-        if (!payload) {
-            std::cerr << "message::recv: ignoring payload: " << msg << std::endl;
-            payload = &pl;
-        }
-        payload->resize(msg.payloadSize());
-        auto buf = asio::buffer(payload->data(), payload->size());
+        auto buf = asio::buffer(data, msg.payloadSize());
         size_t sz = asio::read(sock, buf, ec);
         if (ec) {
             std::cerr << "message::recv: payload error " << ec.message() << std::endl;
             return false;
         } else if (sz != msg.payloadSize()) {
-            std::cerr << "message::recv: short payload read: received " << sz << " instead of " << payload->size()
+            std::cerr << "message::recv: short payload read: received " << sz << " instead of " << msg.payloadSize()
                       << std::endl;
             return false;
         }
@@ -300,6 +313,18 @@ bool recv_payload(socket_t &sock, message::Buffer &msg, error_code &ec, buffer *
     return true;
 }
 
+bool recv_payload(socket_t &sock, const message::Message &msg, error_code &ec, buffer *payload)
+{
+    buffer pl;
+    if (!payload) {
+        if (msg.payloadSize() > 0)
+            std::cerr << "message::recv: ignoring payload: " << msg << std::endl;
+        payload = &pl;
+    }
+    payload->resize(msg.payloadSize());
+    return recv_payload(sock, msg, ec, payload->data());
+}
+
 namespace {
 
 struct RecvRequest;
@@ -645,6 +670,22 @@ void async_send(socket_t &sock, const message::Message &msg, const MessagePayloa
     }
 }
 
+void async_send(socket_t &sock, const message::Message &msg, std::shared_ptr<buffer> payload, size_t offset,
+                size_t size, const std::function<void(error_code ec)> handler)
+{
+    assert(payload);
+    assert(offset + size <= payload->size());
+    assert(check(msg, payload->data() + offset, size));
+    auto req = std::make_shared<SendRequest>(sock, msg, payload, offset, size, handler);
+
+    std::lock_guard<std::mutex> locker(sendQueueMutex);
+    bool submit = sendQueues[&sock].empty();
+    sendQueues[&sock].emplace_back(req);
+
+    if (submit) {
+        submitSendRequest(req);
+    }
+}
 
 void async_forward(socket_t &sock, const message::Message &msg, std::shared_ptr<socket_t> payloadSock,
                    const std::function<void(error_code ec)> handler)
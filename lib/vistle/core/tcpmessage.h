@@ -26,12 +26,19 @@ void V_COREEXPORT async_send(socket_t &sock, const Message &msg, std::shared_ptr
                              const std::function<void(error_code ec)> handler);
 void V_COREEXPORT async_send(socket_t &sock, const Message &msg, const MessagePayload &payload,
                              const std::function<void(error_code ec)> handler);
+//! send size bytes starting at offset of payload, msg.payloadSize() has to match size
+void V_COREEXPORT async_send(socket_t &sock, const Message &msg, std::shared_ptr<buffer> payload, size_t offset,
+                             size_t size, const std::function<void(error_code ec)> handler);
 void V_COREEXPORT async_forward(socket_t &sock, const Message &msg, std::shared_ptr<socket_t> payloadSock,
                                 const std::function<void(error_code ec)> handler);
 
 bool V_COREEXPORT recv(socket_t &sock, message::Buffer &msg, error_code &ec, bool block = false,
                        buffer *payload = nullptr);
 bool V_COREEXPORT recv_message(socket_t &sock, message::Buffer &msg, error_code &ec, bool block = false);
+//! receive payload announced by msg after it has been received with recv_message
+bool V_COREEXPORT recv_payload(socket_t &sock, const message::Message &msg, error_code &ec, buffer *payload);
+//! receive payload announced by msg into storage for msg.payloadSize() bytes at data
+bool V_COREEXPORT recv_payload(socket_t &sock, const message::Message &msg, error_code &ec, char *data);
 void V_COREEXPORT async_recv(socket_t &sock, vistle::message::Buffer &msg,
                              std::function<void(error_code, std::shared_ptr<buffer>)> handler);
 void V_COREEXPORT async_recv_header(socket_t &sock, vistle::message::Buffer &msg,
@@ -52,6 +52,14 @@ void UnstructuredGrid::resetElements()
     refreshImpl();
 }
 
+void UnstructuredGrid::updateInternals()
+{
+    if (d()->tl.deduplicate())
+        refreshImpl();
+
+    Base::updateInternals();
+}
+
 bool UnstructuredGrid::isEmpty()
 {
     return Base::isEmpty();
@@ -158,6 +166,21 @@ Vector2 bilinearInverse(const Vector3 &p0, const Vector3 p[4])
     return ss;
 }
 
+// vertices of element elem with indices of type Index: points into the connectivity list,
+// or into buf, if it is stored with 32 bit indices
+const Index *cellIndices(const UnstructuredGrid &grid, Index elem, std::vector<Index> &buf)
+{
+    return grid.withIndices([elem, &buf](const auto *el, const auto *cl) -> const Index * {
+        const Index begin = el[elem], end = el[elem + 1];
+        if constexpr (std::is_same_v<std::decay_t<decltype(*cl)>, Index>) {
+            return &cl[begin];
+        } else {
+            buf.assign(&cl[begin], &cl[end]);
+            return buf.data();
+        }
+    });
+}
+
 } // namespace
 
 Scalar UnstructuredGrid::cellDiameter(Index elem) const
@@ -189,18 +212,16 @@ Index UnstructuredGrid::cellNumVertices(Index elem) const
 {
     auto t = tl()[elem];
     if (t == POLYHEDRON) {
-        const Index *el = this->el().data();
-        const Index *cl = this->cl().data();
-        const Index begin = el[elem], end = el[elem + 1];
-        std::vector<Index> verts(&cl[begin], &cl[end]);
-        std::sort(verts.begin(), verts.end());
-        auto last = std::unique(verts.begin(), verts.end());
-        return last - verts.begin();
+        return withIndices([elem](const auto *el, const auto *cl) -> Index {
+            const Index begin = el[elem], end = el[elem + 1];
+            std::vector<Index> verts(&cl[begin], &cl[end]);
+            std::sort(verts.begin(), verts.end());
+            auto last = std::unique(verts.begin(), verts.end());
+            return last - verts.begin();
+        });
     } else if (t < NUM_TYPES) {
         if (NumVertices[t] < 0) {
-            const Index *el = this->el().data();
-            const Index begin = el[elem], end = el[elem + 1];
-            return end - begin;
+            return withIndices([elem](const auto *el, const auto *cl) -> Index { return el[elem + 1] - el[elem]; });
         }
         return NumVertices[t];
     }
@@ -211,10 +232,12 @@ Scalar UnstructuredGrid::cellEdgeLength(Index elem) const
 {
     auto t = tl()[elem];
     Scalar retval = -1;
+    std::vector<Index> buf;
     meta::_for<NumSupportedTypes>([&](auto i) {
         constexpr auto type = SupportedTypes[i()];
         if (t == type) {
-            retval = edgeLength<type>(cellNumVertices(elem), &cl()[el()[elem]], {x().data(), y().data(), z().data()});
+            retval = edgeLength<type>(cellNumVertices(elem), cellIndices(*this, elem, buf),
+                                      {x().data(), y().data(), z().data()});
         }
     });
     return retval;
@@ -224,10 +247,12 @@ Scalar UnstructuredGrid::cellSurface(Index elem) const
 {
     auto t = tl()[elem];
     Scalar retval = -1;
+    std::vector<Index> buf;
     meta::_for<NumSupportedTypes>([&](auto i) {
         constexpr auto type = SupportedTypes[i()];
         if (t == type) {
-            retval = surface<type>(cellNumVertices(elem), &cl()[el()[elem]], {x().data(), y().data(), z().data()});
+            retval = surface<type>(cellNumVertices(elem), cellIndices(*this, elem, buf),
+                                   {x().data(), y().data(), z().data()});
         }
     });
     return retval;
@@ -237,10 +262,12 @@ Scalar UnstructuredGrid::cellVolume(Index elem) const
 {
     auto t = tl()[elem];
     Scalar retval = -1;
+    std::vector<Index> buf;
     meta::_for<NumSupportedTypes>([&](auto i) {
         constexpr auto type = SupportedTypes[i()];
         if (t == type) {
-            retval = volume<type>(cellNumVertices(elem), &cl()[el()[elem]], {x().data(), y().data(), z().data()});
+            retval = volume<type>(cellNumVertices(elem), cellIndices(*this, elem, buf),
+                                  {x().data(), y().data(), z().data()});
         }
     });
     return retval;
@@ -250,24 +277,23 @@ Index UnstructuredGrid::cellNumFaces(Index elem) const
 {
     auto t = tl()[elem];
     if (t == POLYHEDRON) {
-        const Index *el = this->el().data();
-        const Index begin = el[elem], end = el[elem + 1];
-        const Index *cl = &this->cl()[begin];
-        const Index nverts = end - begin;
+        return withIndices([elem](const auto *el, const auto *cl) -> Index {
+            const Index begin = el[elem], end = el[elem + 1];
 
-        Index numFaces = 0;
-        Index term = InvalidIndex;
-        for (Index i = 0; i < nverts; ++i) {
-            if (term == InvalidIndex) {
-                term = cl[i];
-            } else if (cl[i] == term) {
-                ++numFaces;
-                term = InvalidIndex;
+            Index numFaces = 0;
+            Index term = InvalidIndex;
+            for (Index i = begin; i < end; ++i) {
+                if (term == InvalidIndex) {
+                    term = cl[i];
+                } else if (cl[i] == term) {
+                    ++numFaces;
+                    term = InvalidIndex;
+                }
             }
-        }
-        assert(term == InvalidIndex);
+            assert(term == InvalidIndex);
 
-        return numFaces;
+            return numFaces;
+        });
     } else if (t < NUM_TYPES) {
         return NumFaces[t] >= 0 ? NumFaces[t] : 0;
     }
@@ -276,9 +302,8 @@ Index UnstructuredGrid::cellNumFaces(Index elem) const
 
 Scalar UnstructuredGrid::exitDistance(Index elem, const Vector3 &point, const Vector3 &dir) const
 {
-    const Index *el = this->el().data();
-    const Index begin = el[elem], end = el[elem + 1];
-    const Index *cl = &this->cl()[begin];
+    std::vector<Index> buf;
+    const Index *cl = cellIndices(*this, elem, buf);
     const Scalar *x = this->x().data();
     const Scalar *y = this->y().data();
     const Scalar *z = this->z().data();
@@ -288,7 +313,7 @@ Scalar UnstructuredGrid::exitDistance(Index elem, const Vector3 &point, const Ve
     Scalar exitDist = -1;
     const auto type(tl()[elem]);
     if (type == UnstructuredGrid::POLYHEDRON) {
-        const Index nvert = end - begin;
+        const Index nvert = Indexed::cellNumVertices(elem);
         Index term = 0;
         Index facestart = InvalidIndex;
         for (Index i = 0; i < nvert; ++i) {
@@ -360,11 +385,25 @@ bool UnstructuredGrid::inside(Index elem, const Vector3 &point) const
         return false;
 
     const auto type = tl()[elem];
-    const Index begin = el()[elem];
-    const Index end = el()[elem + 1];
-    const Index *cl = &this->cl()[begin];
-
-    return insideCell(point, type, end - begin, cl, this->x().data(), this->y().data(), this->z().data());
+    const Scalar *x = this->x().data(), *y = this->y().data(), *z = this->z().data();
+    return withIndices([&](const auto *el, const auto *cl) {
+        const Index begin = el[elem], end = el[elem + 1];
+        if constexpr (std::is_same_v<std::decay_t<decltype(*cl)>, Index>) {
+            return insideCell(point, type, end - begin, &cl[begin], x, y, z);
+        } else {
+            // insideCell requires indices of type Index
+            const Index n = end - begin;
+            Index verts[8];
+            std::vector<Index> polyVerts;
+            Index *v = verts;
+            if (n > 8) {
+                polyVerts.resize(n);
+                v = polyVerts.data();
+            }
+            std::copy(&cl[begin], &cl[end], v);
+            return insideCell(point, type, n, v, x, y, z);
+        }
+    });
 }
 
 GridInterface::Interpolator UnstructuredGrid::getInterpolator(Index elem, const Vector3 &point, Mapping mapping,
@@ -385,12 +424,12 @@ GridInterface::Interpolator UnstructuredGrid::getInterpolator(Index elem, const
         return Interpolator(weights, indices);
     }
 
-    const auto el = this->el().data();
     const auto tl = this->tl().data();
-    const auto cl = &this->cl()[el[elem]];
+    std::vector<Index> buf;
+    const auto cl = cellIndices(*this, elem, buf);
     const Scalar *x[3] = {this->x().data(), this->y().data(), this->z().data()};
 
-    const Index nvert = el[elem + 1] - el[elem];
+    const Index nvert = Indexed::cellNumVertices(elem);
     std::vector<Scalar> weights((mode == Linear || mode == Mean) ? nvert : 1);
     std::vector<Index> indices((mode == Linear || mode == Mean) ? nvert : 1);
 
@@ -709,14 +748,14 @@ std::vector<Index> UnstructuredGrid::cellVertices(Index elem) const
     const auto t = tl()[elem];
 
     if (t == UnstructuredGrid::POLYHEDRON) {
-        const Index *el = this->el().data();
-        const Index *cl = this->cl().data();
-        const Index begin = el[elem], end = el[elem + 1];
-        std::vector<Index> verts(&cl[begin], &cl[end]);
-        std::sort(verts.begin(), verts.end());
-        auto last = std::unique(verts.begin(), verts.end());
-        verts.resize(last - verts.begin());
-        return verts;
+        return withIndices([elem](const auto *el, const auto *cl) {
+            const Index begin = el[elem], end = el[elem + 1];
+            std::vector<Index> verts(&cl[begin], &cl[end]);
+            std::sort(verts.begin(), verts.end());
+            auto last = std::unique(verts.begin(), verts.end());
+            verts.resize(last - verts.begin());
+            return verts;
+        });
     }
 
     if (NumVertices[t] >= 0) {
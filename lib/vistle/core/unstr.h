@@ -178,6 +178,7 @@ public:
                      const Meta &meta = Meta());
 
     void resetElements() override;
+    void updateInternals() override;
 
     shm<Byte>::array &tl() { return *d()->tl; }
     const ShmArrayProxy<Byte> &tl() const { return m_tl; }
@@ -169,6 +169,14 @@ bool Vec<T, Dim>::checkImpl(std::ostream &os, bool quick) const
 template<class T, unsigned Dim>
 void Vec<T, Dim>::updateInternals()
 {
+    bool deduplicated = false;
+    for (unsigned c = 0; c < Dim; ++c) {
+        if (d()->x[c].deduplicate())
+            deduplicated = true;
+    }
+    if (deduplicated)
+        refreshImpl();
+
     d()->updateBounds();
     Base::updateInternals();
 }
@@ -0,0 +1,166 @@
+#include "arraycache.h"
+
+#include <vistle/util/crypto.h>
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+
+namespace vistle {
+
+namespace {
+
+// hashing and the additional round trip for missing arrays do not pay off for small arrays
+const size_t MinSize = 64 << 10;
+
+uint64_t randomEpoch()
+{
+    std::random_device rd;
+    return (uint64_t(rd()) << 32) | rd();
+}
+
+} // namespace
+
+ArrayCache::ArrayCache(size_t capacity): m_capacity(capacity), m_epoch(randomEpoch())
+{}
+
+bool ArrayCache::enabled() const
+{
+    return m_capacity > 0;
+}
+
+size_t ArrayCache::capacity() const
+{
+    return m_capacity;
+}
+
+uint64_t ArrayCache::epoch() const
+{
+    return m_epoch;
+}
+
+size_t ArrayCache::minSize()
+{
+    return MinSize;
+}
+
+ArrayCache::Hash ArrayCache::hash(const void *data, size_t bytes)
+{
+    auto h = crypto::hash_new();
+    crypto::hash_update(h, data, bytes);
+    auto digest = crypto::hash_final(h);
+    Hash result{};
+    std::copy_n(digest.begin(), std::min(digest.size(), result.size()), result.begin());
+    return result;
+}
+
+void ArrayCache::insert(const Hash &hash, int type, size_t bytes, const std::string &name,
+                        std::shared_ptr<ArrayLoader::ArrayOwner> owner)
+{
+    if (!enabled() || bytes > m_capacity)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_index.find(hash);
+    if (it != m_index.end()) {
+        m_bytes -= it->second->second.bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    Entry e;
+    e.type = type;
+    e.bytes = bytes;
+    e.name = name;
+    e.owner = owner;
+    m_lru.emplace_front(hash, e);
+    m_index[hash] = m_lru.begin();
+    m_bytes += bytes;
+    evict();
+}
+
+std::string ArrayCache::lookup(const Hash &hash, int type)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_index.find(hash);
+    if (it == m_index.end())
+        return std::string();
+    if (it->second->second.type != type)
+        return std::string();
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second.name;
+}
+
+void ArrayCache::evict()
+{
+    while (m_bytes > m_capacity && !m_lru.empty()) {
+        auto &last = m_lru.back();
+        m_bytes -= last.second.bytes;
+        m_index.erase(last.first);
+        m_lru.pop_back();
+    }
+}
+
+void ArrayCache::evict(SentHashes &sent)
+{
+    while (sent.bytes > sent.capacity && !sent.lru.empty()) {
+        auto &last = sent.lru.back();
+        sent.bytes -= last.second;
+        sent.index.erase(last.first);
+        sent.lru.pop_back();
+    }
+}
+
+void ArrayCache::setPeerCache(int hub, int rank, size_t capacity, uint64_t epoch)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto &sent = m_sent[std::make_pair(hub, rank)];
+    if (sent.advertised && sent.epoch != epoch) {
+        // receiver has lost what it had cached
+        sent.lru.clear();
+        sent.index.clear();
+        sent.bytes = 0;
+    }
+    sent.advertised = true;
+    sent.epoch = epoch;
+    sent.capacity = capacity;
+    evict(sent);
+}
+
+bool ArrayCache::sentTo(int hub, int rank, const Hash &hash, size_t bytes)
+{
+    if (!enabled())
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto &sent = m_sent[std::make_pair(hub, rank)];
+    if (!sent.advertised)
+        return false;
+    auto it = sent.index.find(hash);
+    if (it != sent.index.end()) {
+        sent.lru.splice(sent.lru.begin(), sent.lru, it->second);
+        return true;
+    }
+
+    if (bytes > sent.capacity)
+        return false;
+    sent.lru.emplace_front(hash, bytes);
+    sent.index[hash] = sent.lru.begin();
+    sent.bytes += bytes;
+    // mirrors eviction by the receiving cache
+    evict(sent);
+    return false;
+}
+
+void ArrayCache::removeHub(int hub)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto it = m_sent.begin(); it != m_sent.end();) {
+        if (it->first.first == hub)
+            it = m_sent.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace vistle
@@ -0,0 +1,82 @@
+#ifndef VISTLE_MANAGER_ARRAYCACHE_H
+#define VISTLE_MANAGER_ARRAYCACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <vistle/core/archive_loader.h>
+#include <vistle/core/messages.h>
+
+namespace vistle {
+
+//! content-addressed cache of arrays for avoiding to resend arrays with identical contents between hubs
+/*! The receiving side keeps references to arrays received from remote hubs, indexed by their content hash,
+ *  the sending side remembers which hashes it has already sent to a hub.
+ *  Both are bounded and evicted in least recently used order.
+ */
+class ArrayCache {
+public:
+    typedef message::SendObject::ContentHash Hash;
+
+    //! capacity of received arrays in bytes, 0 disables caching
+    explicit ArrayCache(size_t capacity);
+
+    bool enabled() const;
+    //! capacity and epoch are advertised to sending hubs, the epoch changes whenever cached contents are lost
+    size_t capacity() const;
+    uint64_t epoch() const;
+    //! arrays smaller than this are always sent
+    static size_t minSize();
+    static Hash hash(const void *data, size_t bytes);
+
+    // receiving side
+    //! keep array received under name alive and make it available for references to hash
+    void insert(const Hash &hash, int type, size_t bytes, const std::string &name,
+                std::shared_ptr<ArrayLoader::ArrayOwner> owner);
+    //! name of a local array with contents hash and type, empty if not available
+    std::string lookup(const Hash &hash, int type);
+
+    // sending side
+    //! update capacity and epoch of the cache of rank of hub, as advertised with its requests
+    void setPeerCache(int hub, int rank, size_t capacity, uint64_t epoch);
+    //! record that rank of hub has received an array with contents hash, return true if this has happened before
+    /*! nothing is recorded as long as the hub has not advertised its cache */
+    bool sentTo(int hub, int rank, const Hash &hash, size_t bytes);
+    void removeHub(int hub);
+
+private:
+    struct Entry {
+        int type = -1;
+        size_t bytes = 0;
+        std::string name;
+        std::shared_ptr<ArrayLoader::ArrayOwner> owner;
+    };
+    typedef std::list<std::pair<Hash, Entry>> EntryList;
+
+    //! hashes sent to a rank of a hub, evicted like by the receiving cache
+    struct SentHashes {
+        bool advertised = false;
+        size_t capacity = 0;
+        uint64_t epoch = 0;
+        size_t bytes = 0;
+        std::list<std::pair<Hash, size_t>> lru;
+        std::map<Hash, std::list<std::pair<Hash, size_t>>::iterator> index;
+    };
+
+    void evict();
+    static void evict(SentHashes &sent);
+
+    std::mutex m_mutex;
+    const size_t m_capacity = 0;
+    const uint64_t m_epoch = 0;
+    size_t m_bytes = 0;
+    EntryList m_lru; //!< received arrays, most recently used first
+    std::map<Hash, EntryList::iterator> m_index;
+    std::map<std::pair<int, int>, SentHashes> m_sent; //!< for every hub and rank
+};
+
+} // namespace vistle
+#endif
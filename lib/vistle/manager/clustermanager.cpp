@@ -307,6 +307,11 @@ int ClusterManager::archiveCompressionSpeed() const
     return getSessionParameter<Integer>(state(), "archive_compression_speed");
 }
 
+bool ClusterManager::archiveCompressionAdaptive() const
+{
+    return getSessionParameter<Integer>(state(), "archive_compression_adaptive") != 0;
+}
+
 const CompressionSettings &ClusterManager::compressionSettings()
 {
     //TODO: find out why values don't change when setting them in the GUI's Session Parameter Menu?
@@ -315,6 +320,7 @@ const CompressionSettings &ClusterManager::compressionSettings()
 
         auto &cs = m_compressionSettings;
         cs.mode = getSessionParameter<FieldCompressionMode>(state(), CompressionSettings::p_mode);
+        cs.integerMode = getSessionParameter<FieldCompressionMode>(state(), CompressionSettings::p_integerMode);
 
         cs.zfpMode = getSessionParameter<FieldCompressionZfpMode>(state(), CompressionSettings::p_zfpMode);
         cs.zfpRate = getSessionParameter<Float>(state(), CompressionSettings::p_zfpRate);
@@ -692,6 +698,7 @@ bool ClusterManager::handle(const message::Buffer &message, const MessagePayload
             payload.rankNames = Communicator::the().m_rankNames;
             payload.rankAddresses = Communicator::the().m_rankAddresses;
             payload.rankDataPorts = Communicator::the().m_rankDataPorts;
+            payload.rankShmNamespaces = Communicator::the().m_rankShmNamespaces;
             MessagePayload pl(message::addPayload(ident, payload));
             sendHub(ident, pl);
         }
@@ -843,6 +850,12 @@ bool ClusterManager::handle(const message::Buffer &message, const MessagePayload
         break;
     }
 
+    case message::TRANSFERSTATISTICS: {
+        const message::TransferStatistics &m = message.as<TransferStatistics>();
+        result = handlePriv(m, payload);
+        break;
+    }
+
     case message::REQUESTTUNNEL: {
         const message::RequestTunnel &m = message.as<RequestTunnel>();
         result = handlePriv(m);
@@ -1432,7 +1445,8 @@ bool ClusterManager::addObjectSource(const message::AddObject &addObj)
                 a.setDestId(hub);
                 a.setDestRank(0);
                 Communicator::the().dataManager().prepareTransfer(a);
-                // TODO: serialize object into message payload - it's small and saves a round trip
+                // small objects are sent along without waiting for requests, saving round trips
+                Communicator::the().dataManager().pushObject(a);
                 sendHub(a, MessagePayload(), hub);
             }
         }
@@ -1539,6 +1553,33 @@ bool ClusterManager::addObjectDestination(const message::AddObject &addObj, Obje
     return true;
 }
 
+bool ClusterManager::addObjectFused(const message::AddObject &addObj)
+{
+    const Port *port = portManager().findPort(addObj.senderId(), addObj.getSenderPort());
+    if (!port) {
+        CERR << "AddObject [" << addObj.objectName() << "] to port [" << addObj.getSenderPort() << "] of ["
+             << addObj.senderId() << "]: port not found" << std::endl;
+        return true;
+    }
+    const Port::ConstPortSet *list = portManager().getConnectionList(port);
+    if (!list) {
+        assert(list);
+        return true;
+    }
+
+    // object has not been forwarded, but the receiving module still relies on being told to compute it
+    for (const Port *destPort: *list) {
+        if (destPort->getName() != addObj.getDestPort() || !isLocal(destPort->getModuleID()))
+            continue;
+        portManager().addObject(destPort);
+        return checkExecuteObject(destPort->getModuleID());
+    }
+
+    CERR << "AddObject [" << addObj.objectName() << "] from fused port [" << addObj.getSenderPort() << "] of ["
+         << addObj.senderId() << "]: destination port " << addObj.getDestPort() << " not connected" << std::endl;
+    return true;
+}
+
 bool ClusterManager::handlePriv(const message::AddObject &addObj)
 {
     const bool resendAfterConnect = message::Id::isModule(addObj.destId());
@@ -1573,6 +1614,12 @@ bool ClusterManager::handlePriv(const message::AddObject &addObj)
         addObjectSource(addObj);
     }
 
+    if (addObj.isFused()) {
+        // already handed over to the connected module within the same process, just account for it
+        assert(localAdd);
+        return addObjectFused(addObj);
+    }
+
     //CERR << "ADDOBJECT: " << addObj << ", local=" << localAdd << std::endl;
     Object::const_ptr obj;
 
@@ -2120,6 +2167,14 @@ bool ClusterManager::handlePriv(const message::ItemInfo &info, const MessagePayl
     return true;
 }
 
+bool ClusterManager::handlePriv(const message::TransferStatistics &stats, const MessagePayload &payload)
+{
+    // modules report from any rank, sendHub forwards to rank 0
+    message::Buffer buf(stats);
+    buf.setDestId(Id::MasterHub);
+    return sendHub(buf, payload);
+}
+
 bool ClusterManager::handlePriv(const message::Colormap &cm, const MessagePayload &payload)
 {
     return true;
@@ -2181,6 +2236,18 @@ bool ClusterManager::handlePriv(const message::DataTransferState &state)
     m_numTransfering[r] = state.numTransferring();
     m_totalNumTransferring += m_numTransfering[r];
 
+    if (state.bandwidth() > 0.) {
+        if (ssize_t(m_transferCompression.size()) < m_size)
+            m_transferCompression.resize(m_size, std::make_pair(-1, 0));
+        auto comp = std::make_pair(int(state.compressionMode()), state.compressionSpeed());
+        if (m_transferCompression[r] != comp) {
+            m_transferCompression[r] = comp;
+            CERR << "rank " << r << ": adaptive archive compression switched to "
+                 << message::toString(state.compressionMode()) << " with speed " << state.compressionSpeed()
+                 << " for link throughput of " << state.bandwidth() / 1e6 << " MB/s" << std::endl;
+        }
+    }
+
     std::stringstream str;
     if (m_totalNumTransferring == 0) {
         Communicator::the().clearStatus();
@@ -76,6 +76,8 @@ public:
 
     message::CompressionMode archiveCompressionMode() const;
     int archiveCompressionSpeed() const;
+    //! choose compression mode and speed per transfer from measured throughput instead of the settings above
+    bool archiveCompressionAdaptive() const;
     const CompressionSettings &compressionSettings();
 
     bool isLocal(int id) const;
@@ -124,6 +126,7 @@ private:
     std::map<PortKey, PortObjectCache> m_outputObjects; // current objects at local output ports
     bool addObjectSource(const message::AddObject &addObj);
     bool addObjectDestination(const message::AddObject &addObj, Object::const_ptr obj);
+    bool addObjectFused(const message::AddObject &addObj);
 
     bool handlePriv(const message::Trace &trace);
     bool handlePriv(const message::SetName &setname);
@@ -145,6 +148,7 @@ private:
     bool handlePriv(const message::BarrierReached &barrierReached);
     bool handlePriv(const message::SendText &text, const MessagePayload &payload);
     bool handlePriv(const message::ItemInfo &info, const MessagePayload &payload);
+    bool handlePriv(const message::TransferStatistics &stats, const MessagePayload &payload);
     bool handlePriv(const message::RequestTunnel &tunnel);
     bool handlePriv(const message::DataTransferState &state);
     bool handlePriv(const message::Colormap &cm, const MessagePayload &payload);
@@ -215,6 +219,7 @@ private:
     ModuleSet m_reachedSet;
 
     std::vector<int> m_numTransfering;
+    std::vector<std::pair<int, int>> m_transferCompression; //!< adaptive compression mode and speed for every rank
     long m_totalNumTransferring = 0;
     double m_lastStatusUpdateTime = 0.;
 
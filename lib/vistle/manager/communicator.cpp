@@ -119,7 +119,8 @@ int Communicator::getSize() const
 
 bool Communicator::connectHub(std::string host, unsigned short port, unsigned short dataPort)
 {
-    boost::mpi::gather(m_comm, host, m_rankNames, 0);
+    boost::mpi::gather(m_comm, hostname(), m_rankNames, 0);
+    boost::mpi::gather(m_comm, shmnamespace(), m_rankShmNamespaces, 0);
 
     std::vector<std::string> localAddresses;
     {
@@ -66,6 +66,7 @@ private:
 
     boost::mpi::communicator m_comm;
     std::vector<std::string> m_rankNames; //< host names of all ranks (only valid on rank 0)
+    std::vector<std::string> m_rankShmNamespaces; //< shared memory namespaces of all ranks (only valid on rank 0)
     std::vector<std::vector<std::string>> m_rankAddresses; //< local addresses of all ranks (only valid on rank 0)
     std::vector<unsigned short> m_rankDataPorts; //< data ports of all ranks (only valid on rank 0)
     ClusterManager *m_clusterManager;
@@ -0,0 +1,152 @@
+#include "compressiontuner.h"
+
+#include <cassert>
+#include <limits>
+
+namespace vistle {
+
+namespace {
+
+const size_t MinSize = 64 << 10;
+// weight of a new sample in the moving averages
+const double Smoothing = 0.25;
+// re-measure the least recently used codec after this many decisions, as data and load change over time
+const size_t ProbeInterval = 32;
+
+double average(double avg, double sample, size_t samples)
+{
+    if (samples == 0)
+        return sample;
+    return (1. - Smoothing) * avg + Smoothing * sample;
+}
+
+} // namespace
+
+CompressionTuner::CompressionTuner()
+{
+    // codecs not available in this build do not reduce payload size and will therefore never be chosen
+    const Codec candidates[] = {
+        {message::CompressionNone, 0}, {message::CompressionLz4, 1},  {message::CompressionZstd, -1},
+        {message::CompressionZstd, 3}, {message::CompressionZstd, 9},
+    };
+    for (const auto &c: candidates) {
+        m_codecs.emplace_back();
+        m_codecs.back().codec = c;
+    }
+}
+
+size_t CompressionTuner::minSize()
+{
+    return MinSize;
+}
+
+void CompressionTuner::recordTransfer(int hub, size_t bytes, double seconds)
+{
+    if (bytes < MinSize || seconds <= 0.)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_bandwidth.find(hub);
+    double sample = bytes / seconds;
+    if (it == m_bandwidth.end())
+        m_bandwidth.emplace(hub, sample);
+    else
+        it->second = average(it->second, sample, 1);
+}
+
+double CompressionTuner::bandwidth(int hub) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_bandwidth.find(hub);
+    if (it == m_bandwidth.end())
+        return 0.;
+    return it->second;
+}
+
+void CompressionTuner::removeHub(int hub)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_bandwidth.erase(hub);
+}
+
+double CompressionTuner::expectedTime(const CodecStats &stats, size_t rawSize, double bandwidth) const
+{
+    // decompression is considerably faster than compression for all candidates and is not accounted for
+    double t = rawSize * stats.ratio / bandwidth;
+    if (stats.codec.mode != message::CompressionNone) {
+        if (stats.speed <= 0.)
+            return std::numeric_limits<double>::max();
+        t += rawSize / stats.speed;
+    }
+    return t;
+}
+
+bool CompressionTuner::choose(size_t rawSize, double bandwidth, Codec &codec)
+{
+    if (rawSize < MinSize || bandwidth <= 0.)
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_decisions;
+
+    const CodecStats *best = nullptr;
+    for (const auto &s: m_codecs) {
+        if (s.samples == 0) {
+            // measure every codec at least once
+            best = &s;
+            break;
+        }
+    }
+    if (!best && m_decisions % ProbeInterval == 0) {
+        for (const auto &s: m_codecs) {
+            if (!best || s.lastUse < best->lastUse)
+                best = &s;
+        }
+    }
+    if (!best) {
+        double bestTime = std::numeric_limits<double>::max();
+        for (const auto &s: m_codecs) {
+            double t = expectedTime(s, rawSize, bandwidth);
+            if (t < bestTime) {
+                bestTime = t;
+                best = &s;
+            }
+        }
+    }
+    assert(best);
+
+    codec = best->codec;
+    m_lastChoice = codec;
+    m_lastBandwidth = bandwidth;
+    return true;
+}
+
+void CompressionTuner::recordCompression(const Codec &codec, size_t rawSize, size_t compressedSize, double seconds)
+{
+    if (rawSize < MinSize)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto &s: m_codecs) {
+        if (s.codec != codec)
+            continue;
+        if (seconds > 0.)
+            s.speed = average(s.speed, rawSize / seconds, s.samples);
+        s.ratio = average(s.ratio, double(compressedSize) / rawSize, s.samples);
+        ++s.samples;
+        s.lastUse = m_decisions;
+        break;
+    }
+}
+
+bool CompressionTuner::lastChoice(Codec &codec, double &bandwidth) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_lastBandwidth <= 0.)
+        return false;
+    codec = m_lastChoice;
+    bandwidth = m_lastBandwidth;
+    return true;
+}
+
+} // namespace vistle
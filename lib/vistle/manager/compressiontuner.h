@@ -0,0 +1,67 @@
+#ifndef VISTLE_MANAGER_COMPRESSIONTUNER_H
+#define VISTLE_MANAGER_COMPRESSIONTUNER_H
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <vistle/core/message.h>
+
+namespace vistle {
+
+//! select payload compression for transfers between hubs based on measured link throughput and codec performance
+/*! The receiving side estimates the throughput achieved by transfers from each hub and passes it along with its
+ *  requests, the sending side tracks compression speed and ratio of each candidate codec and picks the one
+ *  minimizing the expected time for compressing and transmitting a payload.
+ */
+class CompressionTuner {
+public:
+    struct Codec {
+        message::CompressionMode mode = message::CompressionNone;
+        int speed = 0;
+        bool operator==(const Codec &other) const { return mode == other.mode && speed == other.speed; }
+        bool operator!=(const Codec &other) const { return !(*this == other); }
+    };
+
+    CompressionTuner();
+
+    //! payloads smaller than this do not yield meaningful measurements and are compressed with static settings
+    static size_t minSize();
+
+    // receiving side
+    //! record that bytes have been received from hub seconds after they have been sent
+    void recordTransfer(int hub, size_t bytes, double seconds);
+    //! estimated throughput in bytes/s of transfers from hub, 0 if unknown
+    double bandwidth(int hub) const;
+    void removeHub(int hub);
+
+    // sending side
+    //! codec for compressing rawSize bytes to be sent over a link with bandwidth, false if there is no basis for a choice
+    bool choose(size_t rawSize, double bandwidth, Codec &codec);
+    //! record performance of codec, compressedSize equals rawSize if compression did not reduce size
+    void recordCompression(const Codec &codec, size_t rawSize, size_t compressedSize, double seconds);
+
+    //! most recent choice and the bandwidth it was based on, returns false if no choice has been made yet
+    bool lastChoice(Codec &codec, double &bandwidth) const;
+
+private:
+    struct CodecStats {
+        Codec codec;
+        size_t samples = 0;
+        size_t lastUse = 0; //!< decision counter when codec was last measured
+        double speed = 0.; //!< bytes/s of uncompressed data
+        double ratio = 1.; //!< compressed/uncompressed size
+    };
+
+    double expectedTime(const CodecStats &stats, size_t rawSize, double bandwidth) const;
+
+    mutable std::mutex m_mutex;
+    std::map<int, double> m_bandwidth;
+    std::vector<CodecStats> m_codecs;
+    size_t m_decisions = 0;
+    Codec m_lastChoice;
+    double m_lastBandwidth = 0.;
+};
+
+} // namespace vistle
+#endif
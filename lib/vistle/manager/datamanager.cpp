@@ -1,12 +1,17 @@
 #include <boost/mpi/communicator.hpp>
 
 #include "datamanager.h"
+#include "arraycache.h"
+#include "compressiontuner.h"
 #include "clustermanager.h"
 #include "communicator.h"
 #include <vistle/util/vecstreambuf.h>
 #include <vistle/util/sleep.h>
 #include <vistle/util/threadname.h>
+#include <vistle/util/stopwatch.h>
 #include <vistle/util/listenv4v6.h>
+#include <vistle/util/hostname.h>
+#include <vistle/util/sysdep.h>
 #include <vistle/core/archives.h>
 #include <vistle/core/archive_loader.h>
 #include <vistle/core/archive_saver.h>
@@ -19,6 +24,9 @@
 #include <vistle/core/shmvector.h>
 #include <vistle/config/value.h>
 #include <vistle/config/access.h>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
 #include <iostream>
 #include <functional>
 
@@ -40,6 +48,71 @@ bool isLocal(int id)
     return (state.getHub(id) == comm.hubId());
 }
 
+// below this size, avoiding a copy through the kernel does not outweigh the cost of setting up a shared memory object
+const size_t MinShmPayloadSize = 1 << 20;
+// sender removes shared memory objects holding payloads not consumed by the receiver within this many seconds
+const double ShmPayloadTimeout = 60.;
+
+bool shmPayloadExists(const std::string &name)
+{
+    namespace interprocess = boost::interprocess;
+    try {
+        interprocess::shared_memory_object shm(interprocess::open_only, name.c_str(), interprocess::read_only);
+    } catch (interprocess::interprocess_exception &) {
+        return false;
+    }
+    return true;
+}
+
+bool writeShmPayload(const std::string &name, const buffer &data)
+{
+    namespace interprocess = boost::interprocess;
+    try {
+        interprocess::shared_memory_object shm(interprocess::create_only, name.c_str(), interprocess::read_write);
+        shm.truncate(data.size());
+        interprocess::mapped_region region(shm, interprocess::read_write);
+        memcpy(region.get_address(), data.data(), data.size());
+    } catch (interprocess::interprocess_exception &ex) {
+        std::cerr << "DataManager: could not place payload into shared memory object " << name << ": " << ex.what()
+                  << std::endl;
+        interprocess::shared_memory_object::remove(name.c_str());
+        return false;
+    }
+    return true;
+}
+
+// map a received payload for reading it in place, the shared memory object is unlinked right away
+std::shared_ptr<boost::interprocess::mapped_region> mapShmPayload(const std::string &name, size_t size)
+{
+    namespace interprocess = boost::interprocess;
+    std::shared_ptr<interprocess::mapped_region> region;
+    try {
+        interprocess::shared_memory_object shm(interprocess::open_only, name.c_str(), interprocess::read_only);
+        region = std::make_shared<interprocess::mapped_region>(shm, interprocess::read_only);
+        if (region->get_size() < size) {
+            std::cerr << "DataManager: shared memory object " << name << " too small for payload of " << size
+                      << " bytes" << std::endl;
+            region.reset();
+        }
+    } catch (interprocess::interprocess_exception &ex) {
+        std::cerr << "DataManager: could not read payload from shared memory object " << name << ": " << ex.what()
+                  << std::endl;
+        region.reset();
+    }
+    interprocess::shared_memory_object::remove(name.c_str());
+    return region;
+}
+
+// returns the uncompressed payload: either data itself, or storage after decompressing into it
+std::pair<const char *, size_t> uncompressedPayload(const message::SendObject &snd, const char *data, size_t size,
+                                                    buffer &storage)
+{
+    if (snd.payloadCompression() == message::CompressionNone)
+        return {data, size};
+    storage = message::decompressPayload(snd.payloadCompression(), snd.payloadSize(), snd.payloadRawSize(), data);
+    return {storage.data(), storage.size()};
+}
+
 } // namespace
 
 DataManager::DataManager(mpi::communicator &comm, unsigned short baseport)
@@ -65,6 +138,14 @@ DataManager::DataManager(mpi::communicator &comm, unsigned short baseport)
     m_numConnections = *config.value<int64_t>("system", "net", "num_direct_connections", m_numConnections);
     m_useDirectComm = m_numConnections > 0;
     m_asyncSend = *config.value<bool>("system", "net", "async_send", m_asyncSend);
+    int64_t stripeMb = *config.value<int64_t>("system", "net", "stripe_size", m_stripeSize >> 20);
+    m_stripeSize = size_t(std::max(stripeMb, int64_t(0))) << 20;
+    int64_t pushMb = *config.value<int64_t>("system", "net", "push_size", m_pushSize >> 20);
+    m_pushSize = size_t(std::max(pushMb, int64_t(0))) << 20;
+    m_shmTransfer = *config.value<bool>("system", "net", "shm_transfer", m_shmTransfer);
+    int64_t arrayCacheMb = *config.value<int64_t>("system", "net", "array_cache_size", 512);
+    m_arrayCache = std::make_unique<ArrayCache>(size_t(std::max(arrayCacheMb, int64_t(0))) << 20);
+    m_compressionTuner = std::make_unique<CompressionTuner>();
 
     m_ioThreads.emplace_back([this]() {
         setThreadName("vistle:dmgr_send");
@@ -262,14 +343,20 @@ bool DataManager::serveDirectSocket(std::shared_ptr<tcp_socket> sock)
         message::Buffer buf;
         buffer payload;
         message::error_code ec;
-        if (message::recv(*sock, buf, ec, false, &payload)) {
+        if (message::recv_message(*sock, buf, ec, false)) {
             {
                 std::lock_guard<std::mutex> guard(m_recvMutex);
                 if (m_quit)
                     break;
             }
             gotMsg = true;
-            handle(sock, buf, &payload);
+            if (buf.type() == message::SENDOBJECT && buf.as<message::SendObject>().isChunk()) {
+                receiveChunk(sock, buf.as<message::SendObject>());
+            } else if (message::recv_payload(*sock, buf, ec, &payload)) {
+                handle(sock, buf, &payload);
+            } else {
+                CERR << "Data communication error: " << ec.message() << std::endl;
+            }
         } else if (ec) {
             CERR << "Data communication error: " << ec.message() << std::endl;
         }
@@ -290,6 +377,48 @@ bool DataManager::serveDirectSocket(std::shared_ptr<tcp_socket> sock)
     return true;
 }
 
+bool DataManager::receiveChunk(std::shared_ptr<tcp_socket> &sock, const message::SendObject &chunk)
+{
+    const size_t total = chunk.totalPayloadSize();
+    StripeKey key(chunk.senderId(), chunk.rank(), chunk.uuid(), chunk.objectId());
+    std::unique_lock<std::mutex> lock(m_stripeMutex);
+    auto &stripe = m_stripes[key];
+    if (!stripe) {
+        stripe = std::make_shared<StripedPayload>();
+        stripe->payload.resize(total);
+    }
+    auto s = stripe;
+    lock.unlock();
+
+    message::error_code ec;
+    if (s->payload.size() != total || chunk.chunkOffset() + chunk.payloadSize() > total) {
+        CERR << "invalid chunk at " << chunk.chunkOffset() << " of " << chunk.payloadSize() << " bytes for "
+             << chunk.objectId() << std::endl;
+        // keep the connection in sync
+        buffer discard;
+        message::recv_payload(*sock, chunk, ec, &discard);
+        return false;
+    }
+    // chunks occupy disjoint ranges, so they are received in place concurrently
+    if (!message::recv_payload(*sock, chunk, ec, s->payload.data() + chunk.chunkOffset())) {
+        CERR << "Data communication error while receiving chunk: " << ec.message() << std::endl;
+        return false;
+    }
+
+    lock.lock();
+    s->received += chunk.payloadSize();
+    if (s->received < total)
+        return true;
+    m_stripes.erase(key);
+    lock.unlock();
+
+    message::Buffer buf(chunk);
+    auto &snd = buf.as<message::SendObject>();
+    snd.setChunk(0, 0);
+    snd.setPayloadSize(total);
+    return handle(sock, buf, &s->payload);
+}
+
 bool DataManager::connect(boost::asio::ip::basic_resolver_results<boost::asio::ip::tcp> &hub)
 {
 #ifdef DEBUG
@@ -311,6 +440,17 @@ bool DataManager::connect(boost::asio::ip::basic_resolver_results<boost::asio::i
 
 bool DataManager::addHub(const message::AddHub &hub, const message::AddHub::Payload &payload)
 {
+    if (m_shmTransfer && hub.id() != Communicator::the().hubId()) {
+        std::lock_guard<std::mutex> guard(m_colocatedMutex);
+        // host names might be identical for containers or virtual machines on different hosts
+        const auto host = hostname();
+        const auto ns = shmnamespace();
+        for (size_t i = 0; i < payload.rankNames.size() && i < payload.rankShmNamespaces.size(); ++i) {
+            if (payload.rankNames[i] == host && payload.rankShmNamespaces[i] == ns)
+                m_colocated.emplace(hub.id(), int(i));
+        }
+    }
+
     std::unique_lock<std::mutex> lock(m_directSocketsMutex);
     auto numRanks = payload.rankAddresses.size();
     if (m_directSockets.find(hub.id()) != m_directSockets.end()) {
@@ -440,9 +580,62 @@ bool DataManager::addHub(const message::AddHub &hub, const message::AddHub::Payl
     return true;
 }
 
+void DataManager::removeShmPayloads(int hub, bool expiredOnly)
+{
+    const double now = Clock::time();
+    std::lock_guard<std::mutex> guard(m_shmPayloadMutex);
+    for (auto it = m_shmPayloads.begin(); it != m_shmPayloads.end();) {
+        if (hub != message::Id::Invalid && it->second.hub != hub) {
+            ++it;
+        } else if (!shmPayloadExists(it->first)) {
+            // receiver has consumed the payload and removed it
+            it = m_shmPayloads.erase(it);
+        } else if (!expiredOnly || it->second.deadline <= now) {
+            boost::interprocess::shared_memory_object::remove(it->first.c_str());
+            it = m_shmPayloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void DataManager::removeHub(const message::RemoveHub &hub)
 {
     closeDirect(hub.id());
+    removeShmPayloads(hub.id(), false);
+    m_arrayCache->removeHub(hub.id());
+    m_compressionTuner->removeHub(hub.id());
+
+    {
+        std::lock_guard<std::mutex> guard(m_colocatedMutex);
+        for (auto it = m_colocated.begin(); it != m_colocated.end();) {
+            if (it->first == hub.id())
+                it = m_colocated.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_stripeMutex);
+        for (auto it = m_stripes.begin(); it != m_stripes.end();) {
+            if (std::get<0>(it->first) == hub.id())
+                it = m_stripes.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_pushMutex);
+    for (auto it = m_pushed.begin(); it != m_pushed.end();) {
+        if (it->second->msg.senderId() == hub.id()) {
+            m_pushedBytes -= it->second->payload.size();
+            m_pushOrder.erase(std::find(m_pushOrder.begin(), m_pushOrder.end(), it->first));
+            it = m_pushed.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void DataManager::closeDirect(int hub)
@@ -533,6 +726,8 @@ bool DataManager::dispatch()
         }
     }
 
+    publishStatistics();
+
     return work;
 }
 
@@ -577,6 +772,7 @@ bool DataManager::send(const message::Message &message, std::shared_ptr<buffer>
     }
 
     std::shared_ptr<boost::asio::ip::tcp::socket> socket = nullptr;
+    std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> stripes;
     if (m_useDirectComm) {
         std::unique_lock<std::mutex> lock(m_directSocketsMutex);
         auto it = m_directSockets.find(destId);
@@ -584,9 +780,17 @@ bool DataManager::send(const message::Message &message, std::shared_ptr<buffer>
 #ifdef DEBUG
             CERR << "using direct connection to rank " << rank << " for sending to " << destId << std::endl;
 #endif
+            // striped chunks have to be queued together with other messages on the same socket
+            if (m_asyncSend && m_stripeSize > 0 && payload && payload->size() > m_stripeSize &&
+                message.type() == message::SENDOBJECT) {
+                stripes = it->second[rank].all();
+            }
             socket = it->second[rank].get();
         }
     }
+    if (stripes.size() > 1) {
+        return sendStriped(stripes, message.as<message::SendObject>(), payload);
+    }
     if (!socket) {
 #ifdef DEBUG
         CERR << "falling back to hub relay for sending to " << rank << " of " << destId << std::endl;
@@ -596,10 +800,36 @@ bool DataManager::send(const message::Message &message, std::shared_ptr<buffer>
     return send(socket, message, payload);
 }
 
+bool DataManager::sendStriped(const std::vector<std::shared_ptr<tcp_socket>> &sockets,
+                              const message::SendObject &msg, std::shared_ptr<buffer> payload)
+{
+    const size_t total = payload->size();
+    size_t i = 0;
+    for (size_t offset = 0; offset < total; offset += m_stripeSize, ++i) {
+        auto sock = sockets[i % sockets.size()];
+        if (!sock || !sock->is_open()) {
+            CERR << "ERROR: no connection to hub for sending chunk of " << msg << std::endl;
+            return false;
+        }
+        size_t size = std::min(m_stripeSize, total - offset);
+        message::SendObject chunk(msg);
+        chunk.setChunk(offset, total);
+        chunk.setPayloadSize(size);
+        message::async_send(*sock, chunk, payload, offset, size, [this, sock](boost::system::error_code ec) {
+            if (ec) {
+                CERR << "ERROR: async send of chunk to " << sock->remote_endpoint() << " failed: " << ec.message()
+                     << std::endl;
+            }
+        });
+    }
+    return true;
+}
+
 bool DataManager::requestArray(const std::string &referrer, const std::string &arrayId, int localType, int remoteType,
                                int hub, int rank, const ArrayCompletionHandler &handler)
 {
     //CERR << "requesting array: " << arrayId << " for " << referrer << std::endl;
+    std::unique_ptr<PushedData> pushed;
     {
         std::lock_guard<std::mutex> lock(m_requestArrayMutex);
         auto it = m_requestedArrays.find(arrayId);
@@ -616,9 +846,19 @@ bool DataManager::requestArray(const std::string &referrer, const std::string &a
 #endif
         it = m_requestedArrays.emplace(arrayId, localType).first;
         it->second.handlers.push_back(handler);
+        it->second.requestTime = Clock::time();
+        pushed = takePushed(arrayId);
+        if (pushed)
+            it->second.answered = true;
     }
 
+    if (pushed)
+        return processSendObject(pushed->msg.as<message::SendObject>(), &pushed->payload);
+
     message::RequestObject req(hub, rank, arrayId, remoteType, referrer);
+    req.setLinkBandwidth(m_compressionTuner->bandwidth(hub));
+    req.setAcceptShmPayload(isColocated(hub, rank));
+    req.setArrayCache(m_arrayCache->capacity(), m_arrayCache->epoch());
     req.setSenderId(Communicator::the().hubId());
     req.setRank(m_rank);
     send(req);
@@ -639,6 +879,7 @@ bool DataManager::requestObject(const message::AddObject &add, const std::string
         return false;
     }
 
+    std::unique_ptr<PushedData> pushed;
     {
         std::lock_guard<std::mutex> lock(m_requestObjectMutex);
         m_outstandingAdds[objId].insert(add);
@@ -652,13 +893,26 @@ bool DataManager::requestObject(const message::AddObject &add, const std::string
 #endif
             return true;
         }
-        m_requestedObjects[objId].completionHandlers.push_back(handler);
+        auto &outstanding = m_requestedObjects[objId];
+        outstanding.completionHandlers.push_back(handler);
+        outstanding.requestTime = Clock::time();
+        m_transferOrigin[add.objectName()] = std::make_pair(add.senderId(), std::string(add.getSenderPort()));
 #ifdef DEBUG
         CERR << m_outstandingAdds[objId].size() << " outstanding adds for " << objId << ", requesting..." << std::endl;
 #endif
+        pushed = takePushed(objId);
+        if (pushed)
+            outstanding.answered = true;
     }
 
+    if (pushed)
+        return processSendObject(pushed->msg.as<message::SendObject>(), &pushed->payload);
+
     message::RequestObject req(add, objId);
+    const int hub = Communicator::the().clusterManager().state().getHub(add.senderId());
+    req.setLinkBandwidth(m_compressionTuner->bandwidth(hub));
+    req.setAcceptShmPayload(isColocated(hub, add.rank()));
+    req.setArrayCache(m_arrayCache->capacity(), m_arrayCache->epoch());
     req.setSenderId(Communicator::the().hubId());
     req.setRank(m_rank);
     send(req);
@@ -680,6 +934,7 @@ bool DataManager::requestObject(const std::string &referrer, const std::string &
         return false;
     }
 
+    std::unique_ptr<PushedData> pushed;
     {
         std::unique_lock<std::mutex> lock(m_requestObjectMutex);
         auto it = m_requestedObjects.find(objId);
@@ -692,14 +947,25 @@ bool DataManager::requestObject(const std::string &referrer, const std::string &
             return true;
         }
 
-        m_requestedObjects[objId].completionHandlers.push_back(handler);
+        auto &outstanding = m_requestedObjects[objId];
+        outstanding.completionHandlers.push_back(handler);
+        outstanding.requestTime = Clock::time();
 #ifdef DEBUG
         CERR << m_outstandingAdds[objId].size() << " outstanding adds for subobj " << objId << ", requesting..."
              << std::endl;
 #endif
+        pushed = takePushed(objId);
+        if (pushed)
+            outstanding.answered = true;
     }
 
+    if (pushed)
+        return processSendObject(pushed->msg.as<message::SendObject>(), &pushed->payload);
+
     message::RequestObject req(hub, rank, objId, referrer);
+    req.setLinkBandwidth(m_compressionTuner->bandwidth(hub));
+    req.setAcceptShmPayload(isColocated(hub, rank));
+    req.setArrayCache(m_arrayCache->capacity(), m_arrayCache->epoch());
     req.setSenderId(Communicator::the().hubId());
     req.setRank(m_rank);
     send(req);
@@ -721,6 +987,127 @@ bool DataManager::prepareTransfer(const message::AddObject &add)
     return true;
 }
 
+bool DataManager::pushObject(const message::AddObject &add)
+{
+    if (m_pushSize == 0)
+        return false;
+
+    Object::const_ptr obj = Shm::the().getObjectFromName(add.objectName());
+    if (!obj)
+        return false;
+
+    // same rank as the one handling the AddObject message on the receiving hub
+    const int hub = add.destId();
+    int rank = 0;
+    int block = add.meta().block();
+    if (block >= 0) {
+        int numRanks = Communicator::the().clusterManager().state().getHubData(hub).numRanks;
+        if (numRanks > 0)
+            rank = block % numRanks;
+    }
+
+    auto fut = std::async(std::launch::async, [this, add, obj, hub, rank]() {
+        setThreadName("dmgr:push:" + std::string(add.objectName()));
+
+        auto saver = std::make_shared<DeepArchiveSaver>();
+        saver->setRawArrays(true);
+        vecostreambuf<buffer> objbuf;
+        vistle::oarchive objar(objbuf);
+        objar.setSaver(saver);
+        obj->saveObject(objar);
+        auto dir = saver->getDirectory();
+        auto rawdir = saver->getRawDirectory();
+
+        size_t bytes = 0;
+        for (const auto &ent: rawdir)
+            bytes += ent.bytes;
+        if (bytes > m_pushSize) {
+            // too large to risk sending it in vain, wait for requests
+            return true;
+        }
+
+        auto &clusterManager = Communicator::the().clusterManager();
+        auto mode = clusterManager.archiveCompressionMode();
+        int speed = clusterManager.archiveCompressionSpeed();
+        auto push = [this, hub, rank, mode, speed](message::SendObject &snd, buffer &mem) {
+            std::shared_ptr<buffer> compressed;
+            if (!mem.empty())
+                compressed = std::make_shared<buffer>(message::compressPayload(mode, snd, mem, speed));
+            snd.setPushed(true);
+            snd.setDestId(hub);
+            snd.setDestRank(rank);
+            snd.setSenderId(Communicator::the().hubId());
+            snd.setRank(m_rank);
+            send(snd, compressed);
+        };
+
+        // receiver can start loading the object before its arrays arrive
+        message::SendObject top(message::RequestObject(add, add.objectName()), obj, objbuf.get_vector().size());
+        push(top, objbuf.get_vector());
+
+        for (const auto &ent: dir) {
+            if (ent.is_array)
+                continue;
+            Object::const_ptr sub = Shm::the().getObjectFromName(ent.name);
+            if (!sub)
+                continue;
+            buffer mem(ent.data, ent.data + ent.size);
+            message::SendObject snd(message::RequestObject(add, ent.name), sub, mem.size());
+            push(snd, mem);
+        }
+
+        for (const auto &ent: rawdir) {
+            message::RequestObject req(hub, rank, ent.name, ent.type, add.objectName());
+            message::SendObject::ContentHash contentHash{};
+            if (m_arrayCache->enabled() && ent.bytes >= ArrayCache::minSize()) {
+                contentHash = ArrayCache::hash(ent.data, ent.bytes);
+                if (m_arrayCache->sentTo(hub, rank, contentHash, ent.bytes)) {
+                    buffer none;
+                    message::SendObject snd(req, 0);
+                    snd.setContentHash(contentHash);
+                    snd.setReference(true);
+                    push(snd, none);
+                    continue;
+                }
+            }
+
+            vecostreambuf<buffer> buf;
+            vistle::oarchive memar(buf);
+#ifdef USE_YAS
+            memar.setCompressionSettings(clusterManager.compressionSettings());
+#endif
+            ArraySaver saver(ent.name, ent.type, memar);
+            if (!saver.save()) {
+                CERR << "failed to serialize array " << ent.name << " for pushing" << std::endl;
+                continue;
+            }
+            message::SendObject snd(req, buf.get_vector().size());
+            snd.setContentHash(contentHash);
+            push(snd, buf.get_vector());
+        }
+
+        return true;
+    });
+
+    std::lock_guard<std::mutex> lock(m_sendTaskMutex);
+    m_sendTasks.emplace_back(std::move(fut));
+
+    return true;
+}
+
+std::unique_ptr<DataManager::PushedData> DataManager::takePushed(const std::string &name)
+{
+    std::lock_guard<std::mutex> guard(m_pushMutex);
+    auto it = m_pushed.find(name);
+    if (it == m_pushed.end())
+        return nullptr;
+    auto data = std::move(it->second);
+    m_pushed.erase(it);
+    m_pushedBytes -= data->payload.size();
+    m_pushOrder.erase(std::find(m_pushOrder.begin(), m_pushOrder.end(), name));
+    return data;
+}
+
 bool DataManager::completeTransfer(const message::AddObjectCompleted &complete)
 {
 #ifdef DEBUG
@@ -746,6 +1133,10 @@ bool DataManager::completeTransfer(const message::AddObjectCompleted &complete)
 void DataManager::updateStatus()
 {
     message::DataTransferState m(m_inTransitObjects.size());
+    CompressionTuner::Codec codec;
+    double bandwidth = 0.;
+    if (m_compressionTuner->lastChoice(codec, bandwidth))
+        m.setCompression(codec.mode, codec.speed, bandwidth);
     m.setSenderId(Communicator::the().hubId());
     m.setRank(m_rank);
 
@@ -755,6 +1146,77 @@ void DataManager::updateStatus()
         Communicator::the().forwardToMaster(m);
 }
 
+void DataManager::recordTransfer(const message::SendObject &snd, double received, double decompressTime)
+{
+    message::TransferStatistics::Entry ent;
+    double requestTime = 0.;
+    if (snd.isArray()) {
+        std::lock_guard<std::mutex> lock(m_requestArrayMutex);
+        auto it = m_requestedArrays.find(snd.objectId());
+        if (it != m_requestedArrays.end())
+            requestTime = it->second.requestTime;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_requestObjectMutex);
+        if (!snd.isArray()) {
+            auto it = m_requestedObjects.find(snd.objectId());
+            if (it != m_requestedObjects.end())
+                requestTime = it->second.requestTime;
+        }
+        // sub-objects and arrays are requested on behalf of the object announced by AddObject
+        auto it = m_transferOrigin.find(snd.referrer());
+        if (it != m_transferOrigin.end()) {
+            ent.module = it->second.first;
+            ent.port = it->second.second;
+        }
+    }
+
+    ent.compression = snd.payloadCompression();
+    ent.transfers = 1;
+    ent.rawBytes = snd.payloadRawSize();
+    ent.compressedBytes = snd.payloadSize();
+    ent.compressTime = snd.compressionTime();
+    ent.decompressTime = decompressTime;
+    ent.waitTime = std::max(0., snd.preparationTime() - snd.compressionTime());
+    // pushed data may arrive before it is requested
+    if (requestTime > 0. && received > requestTime)
+        ent.wireTime = std::max(0., received - requestTime - snd.preparationTime());
+
+    std::lock_guard<std::mutex> guard(m_statisticsMutex);
+    m_statistics[StatisticsKey(ent.module, ent.port, ent.compression)].add(ent);
+    m_statisticsChanged = true;
+}
+
+void DataManager::publishStatistics()
+{
+    const double interval = 2.; // seconds
+    auto now = Clock::time();
+    message::TransferStatistics::Payload pl;
+    {
+        std::lock_guard<std::mutex> guard(m_statisticsMutex);
+        if (!m_statisticsChanged || now - m_statisticsTime < interval)
+            return;
+        m_statisticsChanged = false;
+        m_statisticsTime = now;
+        for (const auto &s: m_statistics) {
+            pl.entries.push_back(s.second);
+            auto &ent = pl.entries.back();
+            ent.module = std::get<0>(s.first);
+            ent.port = std::get<1>(s.first);
+            ent.compression = std::get<2>(s.first);
+        }
+    }
+
+    message::TransferStatistics stats;
+    stats.setSenderId(Communicator::the().hubId());
+    stats.setRank(m_rank);
+    MessagePayload payload(message::addPayload(stats, pl));
+    if (m_rank == 0)
+        Communicator::the().handleMessage(stats, payload);
+    else
+        Communicator::the().forwardToMaster(stats, payload);
+}
+
 bool DataManager::notifyTransferComplete(const message::AddObject &addObj)
 {
     //std::unique_lock<Communicator> guard(Communicator::the());
@@ -847,22 +1309,48 @@ bool DataManager::handlePriv(const message::RequestObject &req)
     }
 #endif
 
-    auto fut = std::async(std::launch::async, [this, req]() {
+    double start = Clock::time();
+    auto fut = std::async(std::launch::async, [this, req, start]() {
         setThreadName("dmgr:req:" + std::string(req.objectId()));
         std::shared_ptr<message::SendObject> snd;
+        message::SendObject::ContentHash contentHash{};
         vecostreambuf<buffer> buf;
         buffer &mem = buf.get_vector();
         vistle::oarchive memar(buf);
 #ifdef USE_YAS
         memar.setCompressionSettings(Communicator::the().clusterManager().compressionSettings());
 #endif
+        m_arrayCache->setPeerCache(req.senderId(), req.rank(), req.arrayCacheCapacity(), req.arrayCacheEpoch());
         if (req.isArray()) {
+            if (m_arrayCache->enabled()) {
+                // do not resend contents the requesting rank already holds
+                auto raw = std::make_shared<DeepArchiveSaver>();
+                raw->setRawArrays(true);
+                raw->saveArray(req.objectId(), req.arrayType(), nullptr);
+                auto rawdir = raw->getRawDirectory();
+                if (rawdir.size() == 1 && rawdir[0].bytes >= ArrayCache::minSize()) {
+                    contentHash = ArrayCache::hash(rawdir[0].data, rawdir[0].bytes);
+                    if (m_arrayCache->sentTo(req.senderId(), req.rank(), contentHash, rawdir[0].bytes) &&
+                        req.acceptReference()) {
+                        snd.reset(new message::SendObject(req, 0));
+                        snd->setContentHash(contentHash);
+                        snd->setReference(true);
+                        snd->setDestId(req.senderId());
+                        snd->setDestRank(req.rank());
+                        snd->setSenderId(Communicator::the().hubId());
+                        snd->setRank(m_rank);
+                        send(*snd);
+                        return true;
+                    }
+                }
+            }
             ArraySaver saver(req.objectId(), req.arrayType(), memar);
             if (!saver.save()) {
                 CERR << "failed to serialize array " << req.objectId() << std::endl;
                 return false;
             }
             snd.reset(new message::SendObject(req, mem.size()));
+            snd->setContentHash(contentHash);
         } else {
             Object::const_ptr obj = Shm::the().getObjectFromName(req.objectId());
             if (!obj) {
@@ -873,15 +1361,54 @@ bool DataManager::handlePriv(const message::RequestObject &req)
             snd.reset(new message::SendObject(req, obj, mem.size()));
         }
 
-        auto compressed = std::make_shared<buffer>();
-        *compressed = message::compressPayload(Communicator::the().clusterManager().archiveCompressionMode(), *snd, mem,
-                                               Communicator::the().clusterManager().archiveCompressionSpeed());
+        auto &clusterManager = Communicator::the().clusterManager();
+        auto mode = clusterManager.archiveCompressionMode();
+        int speed = clusterManager.archiveCompressionSpeed();
+        // copying through shared memory is faster than any compression
+        const bool viaShm = m_shmTransfer && req.acceptShmPayload() && mem.size() >= MinShmPayloadSize;
+        if (viaShm)
+            mode = message::CompressionNone;
+        CompressionTuner::Codec codec;
+        bool adaptive = clusterManager.archiveCompressionAdaptive() && !viaShm &&
+                        m_compressionTuner->choose(mem.size(), req.linkBandwidth(), codec);
+        if (adaptive) {
+            mode = codec.mode;
+            speed = codec.speed;
+        }
+        size_t rawSize = mem.size();
+        std::shared_ptr<buffer> compressed;
+        if (viaShm) {
+            std::string name = "vistle_xfer_" + std::to_string(getpid()) + "_" + std::to_string(++m_shmPayloadCount);
+            if (writeShmPayload(name, mem)) {
+                snd->setPayloadRawSize(rawSize);
+                snd->setPayloadCompression(message::CompressionNone);
+                snd->setShmPayload(name, rawSize);
+                snd->setPayloadSize(0);
+                std::lock_guard<std::mutex> guard(m_shmPayloadMutex);
+                m_shmPayloads[name] = ShmPayload{req.senderId(), Clock::time() + ShmPayloadTimeout};
+            }
+        }
+        if (snd->shmPayloadSize() == 0) {
+            double compressStart = Clock::time();
+            compressed = std::make_shared<buffer>(message::compressPayload(mode, *snd, mem, speed));
+            double compressTime = Clock::time() - compressStart;
+            snd->setCompressionTime(compressTime);
+            if (adaptive) {
+                m_compressionTuner->recordCompression(codec, rawSize, snd->payloadSize(), compressTime);
+            }
+        }
+        snd->setPreparationTime(Clock::time() - start);
 
         snd->setDestId(req.senderId());
         snd->setDestRank(req.rank());
         snd->setSenderId(Communicator::the().hubId());
         snd->setRank(m_rank);
-        send(*snd, compressed);
+        if (!send(*snd, compressed) && snd->shmPayloadSize() > 0) {
+            // receiver will never know about it
+            std::lock_guard<std::mutex> guard(m_shmPayloadMutex);
+            m_shmPayloads.erase(snd->shmPayloadName());
+            boost::interprocess::shared_memory_object::remove(snd->shmPayloadName());
+        }
         //CERR << "sent " << snd->payloadSize() << "(" << snd->payloadRawSize() << ") bytes for " << req << " with " << *snd << std::endl;
 
         return true;
@@ -895,6 +1422,9 @@ bool DataManager::handlePriv(const message::RequestObject &req)
 
 bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
 {
+    if (snd.shmPayloadSize() > 0)
+        return receiveShmPayload(snd);
+
 #ifdef DEBUG
     if (snd.isArray()) {
         CERR << "received array " << snd.objectId() << " for " << snd.referrer() << ", size=" << snd.payloadSize()
@@ -905,11 +1435,157 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
     }
 #endif
 
+    if (snd.isPushed()) {
+        if (!acceptPushed(snd, payload))
+            return true;
+    } else if (!acceptReply(snd)) {
+        return true;
+    }
+
+    if (snd.isArray() && !snd.isReference() && !snd.isPushed()) {
+        std::unique_lock<std::mutex> lock(m_requestArrayMutex);
+        auto it = m_requestedArrays.find(snd.objectId());
+        if (it != m_requestedArrays.end()) {
+            double elapsed = Clock::time() - it->second.requestTime - snd.preparationTime();
+            lock.unlock();
+            m_compressionTuner->recordTransfer(snd.senderId(), snd.payloadSize(), elapsed);
+        }
+    }
+
+    return processSendObject(snd, payload);
+}
+
+bool DataManager::isColocated(int hub, int rank)
+{
+    std::lock_guard<std::mutex> guard(m_colocatedMutex);
+    return m_colocated.find(std::make_pair(hub, rank)) != m_colocated.end();
+}
+
+bool DataManager::receiveShmPayload(const message::SendObject &snd)
+{
+    auto region = mapShmPayload(snd.shmPayloadName(), snd.shmPayloadSize());
+    if (!region) {
+        // peer is not reachable through shared memory after all: request again for sending through sockets
+        {
+            std::lock_guard<std::mutex> guard(m_colocatedMutex);
+            m_colocated.erase(std::make_pair(snd.senderId(), snd.rank()));
+        }
+        std::unique_ptr<message::RequestObject> req;
+        if (snd.isArray()) {
+            req.reset(new message::RequestObject(snd.senderId(), snd.rank(), snd.objectId(), snd.arrayType(),
+                                                 snd.referrer()));
+            std::lock_guard<std::mutex> lock(m_requestArrayMutex);
+            auto it = m_requestedArrays.find(snd.objectId());
+            if (it != m_requestedArrays.end())
+                it->second.requestTime = Clock::time();
+        } else {
+            req.reset(new message::RequestObject(snd.senderId(), snd.rank(), snd.objectId(), snd.referrer()));
+        }
+        req->setLinkBandwidth(m_compressionTuner->bandwidth(snd.senderId()));
+        req->setArrayCache(m_arrayCache->capacity(), m_arrayCache->epoch());
+        req->setSenderId(Communicator::the().hubId());
+        req->setRank(m_rank);
+        send(*req);
+        return true;
+    }
+
+    message::SendObject local(snd);
+    local.setShmPayload(std::string(), 0);
+    local.setPayloadSize(snd.shmPayloadSize());
+    if (!acceptReply(local))
+        return true;
+    // deserialize directly from the mapping instead of copying it to the heap first
+    auto data = static_cast<const char *>(region->get_address());
+    return processSendObject(local, region, data, snd.shmPayloadSize());
+}
+
+bool DataManager::acceptPushed(const message::SendObject &snd, buffer *payload)
+{
+    const std::string name = snd.objectId();
+    std::unique_lock<std::mutex> lock(snd.isArray() ? m_requestArrayMutex : m_requestObjectMutex);
+    bool *answered = nullptr;
+    if (snd.isArray()) {
+        auto it = m_requestedArrays.find(name);
+        if (it != m_requestedArrays.end())
+            answered = &it->second.answered;
+    } else {
+        auto it = m_requestedObjects.find(name);
+        if (it != m_requestedObjects.end())
+            answered = &it->second.answered;
+    }
+
+    std::lock_guard<std::mutex> guard(m_pushMutex);
+    if (answered) {
+        // already requested: serve request from pushed data, unless a reply has arrived first
+        if (*answered)
+            return false;
+        *answered = true;
+        m_pushAnswered.insert(name);
+        return true;
+    }
+
+    if (m_pushed.find(name) != m_pushed.end())
+        return false;
+    if (!snd.isArray() && Shm::the().getObjectFromName(name))
+        return false;
+
+    message::SendObject msg(snd);
+    if (snd.isArray() && !snd.isReference() && snd.contentHash() != message::SendObject::ContentHash{} &&
+        !m_arrayCache->lookup(snd.contentHash(), snd.arrayType()).empty()) {
+        // contents are already available locally: keep only a reference, it is resolved again when requested
+        msg.setReference(true);
+        payload->clear();
+    }
+
+    // keep until requested
+    m_pushedBytes += payload->size();
+    m_pushed.emplace(name, std::make_unique<PushedData>(msg, std::move(*payload)));
+    m_pushOrder.push_back(name);
+    while (m_pushedBytes > 16 * m_pushSize && !m_pushOrder.empty()) {
+        auto it = m_pushed.find(m_pushOrder.front());
+        m_pushedBytes -= it->second->payload.size();
+        m_pushed.erase(it);
+        m_pushOrder.pop_front();
+    }
+    return false;
+}
+
+bool DataManager::acceptReply(const message::SendObject &snd)
+{
+    const std::string name = snd.objectId();
+    std::unique_lock<std::mutex> lock(snd.isArray() ? m_requestArrayMutex : m_requestObjectMutex);
+    std::lock_guard<std::mutex> guard(m_pushMutex);
+    if (m_pushAnswered.erase(name) > 0) {
+        // request has been served from pushed data
+        return false;
+    }
+
+    if (snd.isArray()) {
+        auto it = m_requestedArrays.find(name);
+        if (it != m_requestedArrays.end())
+            it->second.answered = true;
+    } else {
+        auto it = m_requestedObjects.find(name);
+        if (it != m_requestedObjects.end())
+            it->second.answered = true;
+    }
+    return true;
+}
+
+bool DataManager::processSendObject(const message::SendObject &snd, buffer *payload)
+{
     auto payload2 = std::make_shared<buffer>(std::move(*payload));
-    auto fut = std::async(std::launch::async, [this, snd, payload2]() {
+    const char *data = payload2->data();
+    size_t size = payload2->size();
+    return processSendObject(snd, payload2, data, size);
+}
+
+bool DataManager::processSendObject(const message::SendObject &snd, std::shared_ptr<const void> owner,
+                                    const char *data, size_t size)
+{
+    const double received = Clock::time();
+    auto fut = std::async(std::launch::async, [this, snd, owner, data, size, received]() {
         setThreadName("dmgr:recv:" + std::string(snd.objectId()));
-        buffer uncompressed = decompressPayload(snd, *payload2.get());
-        vecistreambuf<buffer> membuf(uncompressed);
 
         if (snd.isArray()) {
             std::unique_lock<std::mutex> lock(m_requestArrayMutex);
@@ -920,13 +1596,48 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
                      << std::endl;
                 return false;
             }
-
-            // an array was received
-            vistle::iarchive memar(membuf);
-            ArrayLoader loader(snd.objectId(), it->second.type, memar);
-            if (!loader.load()) {
-                CERR << "failed to restore array " << snd.objectId() << std::endl;
-                return false;
+            const int type = it->second.type;
+
+            std::string name;
+            std::unique_ptr<ArrayLoader> loader;
+            if (snd.isReference()) {
+                // contents are already available locally
+                name = m_arrayCache->lookup(snd.contentHash(), type);
+                if (name.empty()) {
+                    // evicted in the meantime: request again including contents
+                    message::RequestObject req(snd.senderId(), snd.rank(), snd.objectId(), snd.arrayType(),
+                                               snd.referrer());
+                    req.setAcceptReference(false);
+                    req.setLinkBandwidth(m_compressionTuner->bandwidth(snd.senderId()));
+                    req.setAcceptShmPayload(isColocated(snd.senderId(), snd.rank()));
+                    req.setArrayCache(m_arrayCache->capacity(), m_arrayCache->epoch());
+                    req.setSenderId(Communicator::the().hubId());
+                    req.setRank(m_rank);
+                    lock.lock();
+                    it->second.requestTime = Clock::time();
+                    it->second.answered = false;
+                    lock.unlock();
+                    send(req);
+                    return true;
+                }
+            } else {
+                // an array was received
+                double decompressStart = Clock::time();
+                buffer uncompressed;
+                auto raw = uncompressedPayload(snd, data, size, uncompressed);
+                recordTransfer(snd, received, Clock::time() - decompressStart);
+                vecistreambuf<buffer> membuf(raw.first, raw.second);
+                vistle::iarchive memar(membuf);
+                loader = std::make_unique<ArrayLoader>(snd.objectId(), type, memar);
+                if (!loader->load()) {
+                    CERR << "failed to restore array " << snd.objectId() << std::endl;
+                    return false;
+                }
+                name = snd.objectId();
+                if (snd.contentHash() != message::SendObject::ContentHash{}) {
+                    m_arrayCache->insert(snd.contentHash(), type, raw.second, loader->name(),
+                                         loader->owner());
+                }
             }
 
             lock.lock();
@@ -946,12 +1657,18 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
                      << std::endl;
 #endif
                 for (const auto &completionHandler: reqArr.handlers)
-                    completionHandler(snd.objectId());
+                    completionHandler(name);
             }
 
             return true;
         }
 
+        double decompressStart = Clock::time();
+        buffer uncompressed;
+        auto raw = uncompressedPayload(snd, data, size, uncompressed);
+        recordTransfer(snd, received, Clock::time() - decompressStart);
+        vecistreambuf<buffer> membuf(raw.first, raw.second);
+
         // an object was received
         std::string objName = snd.objectId();
         auto completionHandler = [this, objName]() mutable -> void {
@@ -964,6 +1681,7 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
             } else {
                 notify = std::move(addIt->second);
                 m_outstandingAdds.erase(addIt);
+                m_transferOrigin.erase(objName);
             }
 
             auto objIt = m_requestedObjects.find(objName);
@@ -1109,11 +1827,14 @@ void DataManager::cleanLoop()
                 break;
         }
 
+        removeShmPayloads(message::Id::Invalid, true);
+
         vistle::adaptive_wait(work, this + 3);
         std::lock_guard<std::mutex> guard(m_recvMutex);
         if (m_quit)
             break;
     }
+    removeShmPayloads(message::Id::Invalid, false);
 }
 
 DataManager::Msg::Msg(message::Buffer &&buf, buffer &&payload): buf(std::move(buf)), payload(std::move(payload))
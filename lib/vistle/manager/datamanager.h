@@ -1,11 +1,14 @@
 #ifndef VISTLE_MANAGER_DATAMANAGER_H
 #define VISTLE_MANAGER_DATAMANAGER_H
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <future>
+#include <map>
 #include <set>
 #include <thread>
+#include <tuple>
 
 #include <vistle/core/message.h>
 #include <vistle/core/messages.h>
@@ -22,6 +25,8 @@
 
 namespace vistle {
 
+class ArrayCache;
+class CompressionTuner;
 class Communicator;
 class StateTracker;
 class Object;
@@ -47,6 +52,8 @@ public:
     bool requestArray(const std::string &referrer, const std::string &arrayId, int localType, int remoteType, int hub,
                       int rank, const ArrayCompletionHandler &handler);
     bool prepareTransfer(const message::AddObject &add);
+    //! send a small object together with its sub-objects and arrays to the receiving hub without waiting for requests
+    bool pushObject(const message::AddObject &add);
     bool completeTransfer(const message::AddObjectCompleted &complete);
     bool notifyTransferComplete(const message::AddObject &add);
     bool connect(boost::asio::ip::basic_resolver_results<boost::asio::ip::tcp> &hub);
@@ -81,9 +88,22 @@ private:
 
     bool handlePriv(const message::RequestObject &req);
     bool handlePriv(const message::SendObject &snd, buffer *payload);
+    bool processSendObject(const message::SendObject &snd, buffer *payload);
+    // payload is read from [data, data+size), which has to be kept valid by owner
+    bool processSendObject(const message::SendObject &snd, std::shared_ptr<const void> owner, const char *data,
+                           size_t size);
+    bool acceptPushed(const message::SendObject &snd, buffer *payload);
+    bool acceptReply(const message::SendObject &snd);
     bool handlePriv(const message::AddObjectCompleted &complete);
     bool serveDirectSocket(std::shared_ptr<tcp_socket> sock);
+    bool sendStriped(const std::vector<std::shared_ptr<tcp_socket>> &sockets, const message::SendObject &msg,
+                     std::shared_ptr<buffer> payload);
+    bool receiveChunk(std::shared_ptr<tcp_socket> &sock, const message::SendObject &chunk);
+    bool receiveShmPayload(const message::SendObject &snd);
+    bool isColocated(int hub, int rank);
     void updateStatus();
+    void recordTransfer(const message::SendObject &snd, double received, double decompressTime);
+    void publishStatistics();
 
     std::mutex m_recvMutex;
     std::deque<Msg> m_recvQueue;
@@ -128,6 +148,11 @@ private:
                 current = 0;
             return sockets[current++];
         }
+        std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> all()
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            return sockets;
+        }
     };
     std::map<int, std::vector<SocketList>> m_directSockets; // for every hub and rank, a vector of sockets
 
@@ -141,6 +166,8 @@ private:
     struct RequestedArray {
         RequestedArray(int type): type(type){};
         int type = -1;
+        double requestTime = 0.; //!< for estimating link throughput
+        bool answered = false; //!< a reply or pushed data is being processed
         std::vector<ArrayCompletionHandler> handlers;
     };
     std::map<std::string, RequestedArray>
@@ -149,10 +176,56 @@ private:
     struct OutstandingObject {
         vistle::Object::const_ptr obj;
         std::vector<ObjectCompletionHandler> completionHandlers;
+        double requestTime = 0.;
+        bool answered = false; //!< a reply or pushed data is being processed
     };
     std::mutex m_requestObjectMutex;
     std::map<std::string, OutstandingObject>
         m_requestedObjects; //!< requests for (sub-)objects which have not been serviced yet
+    std::map<std::string, std::pair<int, std::string>>
+        m_transferOrigin; //!< module and port that added an object being transferred, for attributing statistics
+
+    typedef std::tuple<int, std::string, int> StatisticsKey; //!< module, port, compression mode
+    std::mutex m_statisticsMutex;
+    std::map<StatisticsKey, message::TransferStatistics::Entry> m_statistics; //!< totals of received transfers
+    bool m_statisticsChanged = false;
+    double m_statisticsTime = 0.; //!< when statistics have been published last
+
+    std::unique_ptr<ArrayCache> m_arrayCache; //!< avoid resending arrays with identical contents
+    std::unique_ptr<CompressionTuner> m_compressionTuner; //!< adapt payload compression to link throughput
+
+    struct StripedPayload {
+        buffer payload;
+        size_t received = 0;
+    };
+    typedef std::tuple<int, int, message::uuid_t, std::string> StripeKey; //!< sender hub and rank, uuid, object
+    std::mutex m_stripeMutex;
+    std::map<StripeKey, std::shared_ptr<StripedPayload>> m_stripes; //!< large payloads being received in chunks
+
+    struct PushedData {
+        PushedData(const message::SendObject &snd, buffer &&payload): msg(snd), payload(std::move(payload)) {}
+        message::Buffer msg;
+        buffer payload;
+    };
+    std::unique_ptr<PushedData> takePushed(const std::string &name);
+    std::mutex m_pushMutex;
+    std::map<std::string, std::unique_ptr<PushedData>> m_pushed; //!< data pushed before it has been requested
+    std::deque<std::string> m_pushOrder; //!< for evicting the oldest pushed data
+    size_t m_pushedBytes = 0;
+    std::set<std::string> m_pushAnswered; //!< requests served by pushed data, the regular reply is discarded
+
+    std::mutex m_colocatedMutex;
+    std::set<std::pair<int, int>> m_colocated; //!< hub and rank of peers running on this host
+    std::atomic<size_t> m_shmPayloadCount{0};
+    //! shared memory objects holding payloads sent to a hub, removed by the receiver after reading
+    struct ShmPayload {
+        int hub = message::Id::Invalid;
+        double deadline = 0.; //!< remove if not yet consumed by then
+    };
+    std::mutex m_shmPayloadMutex;
+    std::map<std::string, ShmPayload> m_shmPayloads;
+    //! remove objects for payloads sent to hub (or any hub), only if they have timed out if expiredOnly is set
+    void removeShmPayloads(int hub, bool expiredOnly);
 
     std::mutex m_recvTaskMutex;
     std::deque<std::future<bool>> m_recvTasks;
@@ -172,6 +245,9 @@ private:
     size_t m_numConnections = 1; // number of connections per rank (and direction)
     bool m_asyncSend = true; // don't wait for message sends to complete
     bool m_useDirectComm = true; // use direct connections between hubs if possible
+    size_t m_stripeSize = 4 << 20; // split larger payloads for sending across all direct connections, 0 to disable
+    size_t m_pushSize = 0; // push objects with at most this many bytes of array data to remote hubs, 0 to disable
+    bool m_shmTransfer = true; // pass large payloads to peers on the same host through shared memory
 };
 
 } // namespace vistle
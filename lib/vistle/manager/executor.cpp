@@ -6,6 +6,8 @@
 #include <vistle/util/hostname.h>
 #include <vistle/util/shmconfig.h>
 #include <vistle/util/affinity.h>
+#include <vistle/config/access.h>
+#include <vistle/config/value.h>
 
 #include <sys/types.h>
 
@@ -58,6 +60,9 @@ Executor::Executor(int argc, char *argv[], boost::mpi::communicator comm)
     mpi::broadcast(comm, m_name, 0);
 
     bool shmPerRank = vistle::shmPerRank();
+    vistle::config::Access config;
+    bool shmHugePages = vistle::shmHugePages(*config.value<bool>("system", "shm", "huge_pages", false));
+    bool shmBindNuma = vistle::shmBindNuma(*config.value<bool>("system", "shm", "numa_bind", false));
 
     std::string hostname = vistle::hostname();
     std::vector<std::string> hostnames;
@@ -83,6 +88,7 @@ Executor::Executor(int argc, char *argv[], boost::mpi::communicator comm)
         first = true;
 
     if (first) {
+        vistle::Shm::setHugePages(shmHugePages);
         vistle::Shm::remove(m_name, 0, m_rank, shmPerRank);
         vistle::Shm::create(m_name, 0, m_rank, shmPerRank);
         vistle::Shm::the().setNumRanksOnThisNode(ranksPerNode[hostname]);
@@ -94,6 +100,20 @@ Executor::Executor(int argc, char *argv[], boost::mpi::communicator comm)
     comm.barrier();
 
     vistle::apply_affinity_from_environment(nodeRank[m_rank], ranksPerNode[hostname]);
+    if (shmBindNuma) {
+        if (shmPerRank) {
+            int node = vistle::numa_node_of_affinity();
+            if (node >= 0)
+                vistle::Shm::the().bindToNumaNode(node);
+            else
+                std::cerr << "shm: not binding to NUMA node, rank " << m_rank << " is not bound to a single node"
+                          << std::endl;
+        } else {
+            std::cerr << "shm: binding to NUMA nodes requires shared memory per rank" << std::endl;
+        }
+    }
+    if (shmHugePages || shmBindNuma)
+        std::cerr << "shm placement on rank " << m_rank << ": " << vistle::Shm::the().placement() << std::endl;
 
     m_comm = new vistle::Communicator(m_rank, hostnames, comm, dataMgrBase);
     if (!m_comm->connectHub(argv[1], port, dataPort)) {
@@ -26,6 +26,7 @@
 #include <vistle/util/affinity.h>
 #include <vistle/util/profile.h>
 #include <vistle/util/directory.h>
+#include <vistle/util/taskpool.h>
 #include <vistle/config/config.h>
 #include <vistle/core/object.h>
 #include <vistle/core/empty.h>
@@ -137,6 +138,69 @@ void recv(const mpi::communicator &comm, int rank, int tag, T *values, size_t co
 #endif
 }
 
+// chunks of this size are broadcast in a pipeline
+static const size_t pipelineChunk = 4 << 20;
+// number of chunk broadcasts in flight
+static const size_t pipelineDepth = 8;
+
+// finished block tasks waiting for their output to be added, per allowed thread
+static const unsigned MaxHeldBackTasksPerThread = 4;
+
+#ifdef MODULE_THREAD
+// message queue of a module, remains valid as long as it is not reset while holding the mutex
+struct FusionQueue {
+    std::mutex mutex;
+    message::MessageQueue *queue = nullptr;
+    // objects handed over along with their AddObject, which does not hold a reference in shared memory
+    std::map<std::string, Object::const_ptr> objects;
+};
+// modules within this process, accepting objects directly from upstream modules if port is not empty
+struct FusionTarget {
+    std::string port;
+    std::shared_ptr<FusionQueue> queue;
+};
+static std::mutex s_fusionMutex;
+static std::map<int, FusionTarget> s_fusionTargets;
+#endif
+
+typedef std::pair<char *, size_t> Segment;
+
+// Broadcast a sequence of buffers in chunks with several nonblocking broadcasts in flight,
+// so that ranks forward earlier chunks while later ones are still being sent.
+// All ranks have to provide buffers of identical sizes.
+void broadcast_pipelined(const mpi::communicator &comm, const std::vector<Segment> &segments, int root)
+{
+    std::deque<MPI_Request> inflight;
+    for (const auto &seg: segments) {
+        for (size_t off = 0; off < seg.second; off += pipelineChunk) {
+            if (inflight.size() >= pipelineDepth) {
+                MPI_Wait(&inflight.front(), MPI_STATUS_IGNORE);
+                inflight.pop_front();
+            }
+            MPI_Request req;
+            MPI_Ibcast(seg.first + off, int(std::min(pipelineChunk, seg.second - off)), MPI_BYTE, root, comm, &req);
+            inflight.push_back(req);
+        }
+    }
+    for (auto &req: inflight) {
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+#ifdef MPI_DEBUG
+    auto hash = vistle::crypto::hash_new();
+    for (const auto &seg: segments) {
+        vistle::crypto::hash_update(hash, seg.first, seg.second);
+    }
+    auto hashval = vistle::crypto::hash_final(hash);
+    auto hashref = hashval;
+    mpi::broadcast(comm, hashref, root);
+    if (hashval != hashref) {
+        std::cerr << "vistle::bigmpi::broadcast_pipelined: hash mismatch on rank " << comm.rank() << " after transfering "
+                  << segments.size() << " buffers" << std::endl;
+        abort();
+    }
+#endif
+}
+
 } // namespace bigmpi
 
 namespace vistle {
@@ -458,6 +522,7 @@ void Module::setOpenmpThreads(int nthreads, bool updateParam)
     if (nthreads > 0)
         omp_set_num_threads(nthreads);
 #endif
+    TaskPool::setThreadLimit(nthreads);
     if (updateParam)
         setIntParameter("_openmp_threads", nthreads);
 }
@@ -661,6 +726,7 @@ bool Module::removeParameter(const std::string &name)
 bool Module::sendObject(const mpi::communicator &comm, Object::const_ptr obj, int destRank) const
 {
     auto saver = std::make_shared<DeepArchiveSaver>();
+    saver->setRawArrays(true);
     vecostreambuf<buffer> memstr;
     vistle::oarchive memar(memstr);
     memar.setSaver(saver);
@@ -672,6 +738,12 @@ bool Module::sendObject(const mpi::communicator &comm, Object::const_ptr obj, in
     for (auto &ent: dir) {
         bigmpi::send(comm, destRank, 0, ent.data, ent.size);
     }
+    auto rawdir = saver->getRawDirectory();
+    comm.send(destRank, 0, rawdir);
+    for (auto &ent: rawdir) {
+        if (ent.bytes > 0)
+            bigmpi::send(comm, destRank, 0, ent.data, ent.bytes);
+    }
     return true;
 }
 
@@ -682,8 +754,10 @@ bool Module::sendObject(Object::const_ptr object, int destRank) const
 
 Object::const_ptr Module::receiveObject(const mpi::communicator &comm, int sourceRank) const
 {
+    double start = Clock::time();
     buffer mem;
     comm.recv(sourceRank, 0, mem);
+    size_t bytes = mem.size();
     vistle::SubArchiveDirectory dir;
     std::map<std::string, buffer> objects, arrays;
     std::map<std::string, message::CompressionMode> comp;
@@ -698,13 +772,33 @@ Object::const_ptr Module::receiveObject(const mpi::communicator &comm, int sourc
             ent.data = objects[ent.name].data();
         }
         bigmpi::recv(comm, sourceRank, 0, ent.data, ent.size);
-    }
+        bytes += ent.size;
+    }
+    // land array elements directly in shared memory
+    vistle::RawArrayDirectory rawdir;
+    comm.recv(sourceRank, 0, rawdir);
+    RawArrayAllocator rawAlloc;
+    buffer discard;
+    for (auto &ent: rawdir) {
+        ent.data = rawAlloc.allocate(ent);
+        if (ent.bytes == 0)
+            continue;
+        if (!ent.data) {
+            discard.resize(ent.bytes);
+            ent.data = discard.data();
+        }
+        bigmpi::recv(comm, sourceRank, 0, ent.data, ent.bytes);
+        bytes += ent.bytes;
+    }
+    double received = Clock::time();
     vecistreambuf<buffer> membuf(mem);
     vistle::iarchive memar(membuf);
     auto fetcher = std::make_shared<DeepArchiveFetcher>(objects, arrays, comp, rawsizes);
+    fetcher->prefetchArrays();
     memar.setFetcher(fetcher);
     Object::ptr p(Object::loadObject(memar));
     //CERR << "receiveObject " << p->getName() << ": refcount=" << p->refcount() << std::endl;
+    recordTransfer("sendObject", bytes, received - start, Clock::time() - received);
     return p;
 }
 
@@ -713,16 +807,54 @@ Object::const_ptr Module::receiveObject(int destRank) const
     return receiveObject(comm(), destRank);
 }
 
+void Module::recordTransfer(const std::string &op, size_t bytes, double transferTime, double loadTime) const
+{
+    message::TransferStatistics::Entry ent;
+    ent.transfers = 1;
+    ent.rawBytes = bytes;
+    ent.compressedBytes = bytes;
+    ent.decompressTime = loadTime;
+    ent.wireTime = transferTime;
+
+    std::lock_guard<std::mutex> guard(m_transferStatisticsMutex);
+    m_transferStatistics[op].add(ent);
+    m_transferStatisticsChanged = true;
+}
+
+void Module::publishTransferStatistics()
+{
+    message::TransferStatistics::Payload pl;
+    {
+        std::lock_guard<std::mutex> guard(m_transferStatisticsMutex);
+        if (!m_transferStatisticsChanged)
+            return;
+        m_transferStatisticsChanged = false;
+        for (const auto &s: m_transferStatistics) {
+            pl.entries.push_back(s.second);
+            auto &ent = pl.entries.back();
+            ent.module = id();
+            ent.port = s.first;
+            ent.compression = message::CompressionNone;
+        }
+    }
+
+    message::TransferStatistics stats;
+    sendMessageWithPayload(stats, pl);
+}
+
 bool Module::broadcastObject(const mpi::communicator &comm, Object::const_ptr &obj, int root) const
 {
     if (comm.size() == 1)
         return true;
 
+    // all payloads are broadcast in one pipeline after the directories are known on all ranks
+    std::vector<bigmpi::Segment> payload;
     if (comm.rank() == root) {
         assert(obj->check(std::cerr));
         vecostreambuf<buffer> objstr;
         vistle::oarchive objar(objstr);
         auto saver = std::make_shared<DeepArchiveSaver>();
+        saver->setRawArrays(true);
         objar.setSaver(saver);
         obj->saveObject(objar);
         const buffer &objbuf = objstr.get_vector();
@@ -730,18 +862,27 @@ bool Module::broadcastObject(const mpi::communicator &comm, Object::const_ptr &o
 
         auto dir = saver->getDirectory();
         mpi::broadcast(comm, dir, root);
+        auto rawdir = saver->getRawDirectory();
+        mpi::broadcast(comm, rawdir, root);
         for (auto &ent: dir) {
-            bigmpi::broadcast(comm, ent.data, ent.size, root);
+            payload.emplace_back(ent.data, ent.size);
+        }
+        for (auto &ent: rawdir) {
+            payload.emplace_back(ent.data, ent.bytes);
         }
+        bigmpi::broadcast_pipelined(comm, payload, root);
     } else {
+        double start = Clock::time();
         buffer objbuf;
         mpi::broadcast(comm, objbuf, root);
         vistle::SubArchiveDirectory dir;
-        std::map<std::string, buffer> objects, arrays;
+        std::map<std::string, buffer> objects, arrays, discarded;
         std::map<std::string, message::CompressionMode> comp;
         std::map<std::string, size_t> rawsizes;
 
         mpi::broadcast(comm, dir, root);
+        vistle::RawArrayDirectory rawdir;
+        mpi::broadcast(comm, rawdir, root);
         for (auto &ent: dir) {
             if (ent.is_array) {
                 arrays[ent.name].resize(ent.size);
@@ -750,12 +891,28 @@ bool Module::broadcastObject(const mpi::communicator &comm, Object::const_ptr &o
                 objects[ent.name].resize(ent.size);
                 ent.data = objects[ent.name].data();
             }
-            bigmpi::broadcast(comm, ent.data, ent.size, root);
+            payload.emplace_back(ent.data, ent.size);
+        }
+        RawArrayAllocator rawAlloc;
+        for (auto &ent: rawdir) {
+            ent.data = rawAlloc.allocate(ent);
+            if (!ent.data && ent.bytes > 0) {
+                auto &discard = discarded[ent.name];
+                discard.resize(ent.bytes);
+                ent.data = discard.data();
+            }
+            payload.emplace_back(ent.data, ent.bytes);
         }
+        bigmpi::broadcast_pipelined(comm, payload, root);
+        double received = Clock::time();
+        size_t bytes = objbuf.size();
+        for (const auto &seg: payload)
+            bytes += seg.second;
 
         vecistreambuf<buffer> objstr(objbuf);
         vistle::iarchive objar(objstr);
         auto fetcher = std::make_shared<DeepArchiveFetcher>(objects, arrays, comp, rawsizes);
+        fetcher->prefetchArrays();
         objar.setFetcher(fetcher);
         //std::cerr << "DeepArchiveFetcher: " << *fetcher << std::endl;
         obj.reset(Object::loadObject(objar));
@@ -763,6 +920,7 @@ bool Module::broadcastObject(const mpi::communicator &comm, Object::const_ptr &o
         //std::cerr << "broadcastObject recv " << obj->getName() << ": refcount=" << obj->refcount() << std::endl;
         assert(obj->check(std::cerr));
         //obj->unref();
+        recordTransfer("broadcastObject", bytes, received - start, Clock::time() - received);
     }
 
     return true;
@@ -895,6 +1053,97 @@ void Module::updateCacheMode()
     setCacheMode(ObjectCache::CacheMode(value), false);
 }
 
+void Module::publishFinishedTasks()
+{
+    while (!m_tasks.empty()) {
+        auto &task = m_tasks.front();
+        if (task->m_future.valid() &&
+            task->m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            break;
+        task->wait();
+        m_tasks.pop_front();
+    }
+}
+
+bool Module::reuseBlockResult(const std::shared_ptr<BlockTask> &task)
+{
+    auto it = m_blockResults.find(task->m_fingerprint);
+    if (it == m_blockResults.end()) {
+        auto prev = m_previousBlockResults.find(task->m_fingerprint);
+        if (prev == m_previousBlockResults.end())
+            return false;
+        // keep available for the next execution
+        it = m_blockResults.emplace(prev->first, std::move(prev->second)).first;
+        m_previousBlockResults.erase(prev);
+    }
+    it->second.lastUse = ++m_blockResultUses;
+
+    // objects of differing generations would make downstream caches discard objects
+    for (const auto &po: it->second.objects) {
+        auto obj = po.second->clone();
+        obj->setGeneration(m_generation + m_cache.generation());
+        task->addObject(po.first, obj);
+    }
+    ++m_numReusedBlocks;
+    return true;
+}
+
+void Module::storeBlockResult(BlockTask &task)
+{
+    auto &result = m_blockResults[task.m_fingerprint];
+    if (result.tag.empty()) {
+        result.tag = std::to_string(rank()) + ":" + std::to_string(m_numBlockResults++);
+    }
+    result.objects.clear();
+    m_blockResultBytes -= result.bytes;
+    result.bytes = 0;
+    result.lastUse = ++m_blockResultUses;
+
+    size_t idx = 0;
+    for (auto &port_queue: task.m_objects) {
+        for (auto &obj: port_queue.second) {
+            // objects passed through keep the identity given by their creator
+            if (obj->getCreator() == id() && ResultCacheBase::identity(obj) == obj->getName()) {
+                // objects output repeatedly, e.g. from a result cache, might already be accessed by other modules
+                auto o = obj->clone();
+                ResultCacheBase::setIdentity(o, id(), result.tag + ":" + std::to_string(idx));
+                obj = o;
+            }
+            ++idx;
+            result.objects.emplace_back(port_queue.first, obj);
+            result.bytes += ResultCacheBase::objectSize(obj);
+        }
+    }
+    m_blockResultBytes += result.bytes;
+
+    evictBlockResults();
+}
+
+void Module::evictBlockResults()
+{
+    const size_t budget = m_blockResultBudget ? size_t(m_blockResultBudget->getValue()) << 20 : 0;
+    if (budget == 0)
+        return;
+
+    while (m_blockResultBytes > budget) {
+        std::map<std::string, BlockResult> *lru = nullptr;
+        std::map<std::string, BlockResult>::iterator oldest;
+        for (auto *results: {&m_previousBlockResults, &m_blockResults}) {
+            for (auto it = results->begin(); it != results->end(); ++it) {
+                if (!lru || it->second.lastUse < oldest->second.lastUse) {
+                    lru = results;
+                    oldest = it;
+                }
+            }
+        }
+        if (!lru)
+            break;
+        m_blockResultBytes -= oldest->second.bytes;
+        lru->erase(oldest);
+        ++m_numEvictedBlocks;
+    }
+}
+
 void Module::waitAllTasks()
 {
     while (!m_tasks.empty()) {
@@ -1029,6 +1278,11 @@ bool Module::addObject(Port *port, vistle::Object::const_ptr object)
         }
     }
     message::AddObject message(port->getName(), object);
+    if (const Port *dest = sendFused(port, object)) {
+        // manager still accounts for the object, triggers its computation and resends it to ports connected later
+        message.setDestPort(dest->getName());
+        message.setFused();
+    }
     sendMessage(message);
 
     std::string info;
@@ -1113,21 +1367,31 @@ void Module::addResultCache(ResultCacheBase &cache)
         m_useResultCache =
             addIntParameter("_use_result_cache", "whether to try to cache results for re-use in subsequent timesteps",
                             true, Parameter::Boolean);
+        m_resultCacheBudget =
+            addIntParameter("_result_cache_budget", "memory budget for each result cache (MB, 0: unlimited)", 1024);
+        setParameterMinimum(m_resultCacheBudget, Integer(0));
     }
     cache.enable(m_useResultCache->getValue());
+    cache.setBudget(size_t(m_resultCacheBudget->getValue()) << 20);
     m_resultCaches.emplace_back(&cache);
 }
 
 void Module::clearResultCaches()
 {
-    for (auto &c: m_resultCaches)
-        c->clear();
+    // keys of persistent caches capture everything their results depend on
+    for (auto &c: m_resultCaches) {
+        if (!c->persistent())
+            c->clear();
+    }
 }
 
 void Module::enableResultCaches(bool on)
 {
-    for (auto &c: m_resultCaches)
+    for (auto &c: m_resultCaches) {
         c->enable(on);
+        if (!on)
+            c->clear();
+    }
 }
 
 void Module::requestPortMapping(unsigned short forwardPort, unsigned short localPort)
@@ -1268,6 +1532,11 @@ bool Module::changeParameter(const Parameter *p)
             m_prioritizeVisible = getIntParameter("_prioritize_visible");
         } else if (name == "_use_result_cache") {
             enableResultCaches(getIntParameter(name));
+        } else if (name == "_result_cache_budget") {
+            for (auto &c: m_resultCaches)
+                c->setBudget(size_t(getIntParameter(name)) << 20);
+        } else if (name == "_block_result_budget") {
+            evictBlockResults();
         } else if (name == "_validate_objects") {
             m_validateObjects = getIntParameter(name);
         }
@@ -1295,6 +1564,7 @@ void Module::setSchedulingPolicy(int schedulingPolicy)
 
     m_schedulingPolicy = schedulingPolicy;
     sendMessage(SchedulingPolicy(SchedulingPolicy::Schedule(schedulingPolicy)));
+    updateFusion();
 }
 
 int Module::reducePolicy() const
@@ -1315,6 +1585,136 @@ void Module::setReducePolicy(int reducePolicy)
     sendMessage(message::ReducePolicy(message::ReducePolicy::Reduce(reducePolicy)));
 }
 
+void Module::setFusable(bool enable)
+{
+    m_fusable = enable;
+    updateFusion();
+}
+
+bool Module::isFusable() const
+{
+    return m_fusable;
+}
+
+void Module::setReuseBlockResults(bool enable)
+{
+    m_reuseBlockResults = enable;
+    if (enable && !m_blockResultBudget) {
+        setCurrentParameterGroup("System");
+        m_blockResultBudget = addIntParameter(
+            "_block_result_budget", "memory budget for results kept for reuse in later executions (MB, 0: unlimited)",
+            1024);
+        setParameterMinimum(m_blockResultBudget, Integer(0));
+        setCurrentParameterGroup("");
+    }
+    if (!enable) {
+        m_blockResults.clear();
+        m_previousBlockResults.clear();
+        m_blockResultBytes = 0;
+    }
+}
+
+bool Module::reuseBlockResults() const
+{
+    return m_reuseBlockResults;
+}
+
+void Module::updateFusion()
+{
+#ifdef MODULE_THREAD
+    // objects may only be passed directly if the manager would forward them to this rank and trigger a compute
+    // for every single one of them
+    std::string input;
+    if (m_fusable && objectReceivePolicy() == message::ObjectReceivePolicy::Local &&
+        schedulingPolicy() == message::SchedulingPolicy::Single) {
+        int numInputs = 0;
+        for (const auto &p: inputPorts) {
+            if (p.second.flags() & Port::NOCOMPUTE)
+                continue;
+            if (!isConnected(p.second))
+                continue;
+            ++numInputs;
+            if (p.second.connections().size() == 1)
+                input = p.first;
+        }
+        if (numInputs != 1)
+            input.clear();
+    }
+
+    std::lock_guard<std::mutex> guard(s_fusionMutex);
+    auto &target = s_fusionTargets[id()];
+    if (!target.queue) {
+        target.queue = std::make_shared<FusionQueue>();
+        target.queue->queue = receiveMessageQueue;
+    }
+    target.port = input;
+#endif
+}
+
+const Port *Module::sendFused(const Port *port, Object::const_ptr object)
+{
+#ifdef MODULE_THREAD
+    // additional consumers require publishing through the manager
+    if (!m_fusable || port->connections().size() != 1)
+        return nullptr;
+    const Port *dest = *port->connections().begin();
+
+    std::shared_ptr<FusionQueue> queue;
+    {
+        std::lock_guard<std::mutex> guard(s_fusionMutex);
+        auto it = s_fusionTargets.find(dest->getModuleID());
+        if (it == s_fusionTargets.end() || it->second.port != dest->getName())
+            return nullptr;
+        queue = it->second.queue;
+    }
+
+    message::AddObject add(port->getName(), object, dest->getName());
+    add.setSenderId(id());
+    add.setRank(rank());
+    add.setDestId(dest->getModuleID());
+    // fused modules share this process, and thus the rank
+    add.setDestRank(rank());
+    add.setFused();
+    std::lock_guard<std::mutex> guard(queue->mutex);
+    if (!queue->queue)
+        return nullptr;
+    queue->objects[object->getName()] = object;
+    if (!queue->queue->send(add)) {
+        queue->objects.erase(object->getName());
+        return nullptr;
+    }
+    return dest;
+#else
+    (void)port;
+    (void)object;
+    return nullptr;
+#endif
+}
+
+Object::const_ptr Module::takeFusedObject(const std::string &name)
+{
+#ifdef MODULE_THREAD
+    std::shared_ptr<FusionQueue> queue;
+    {
+        std::lock_guard<std::mutex> guard(s_fusionMutex);
+        auto it = s_fusionTargets.find(id());
+        if (it == s_fusionTargets.end())
+            return nullptr;
+        queue = it->second.queue;
+    }
+    std::lock_guard<std::mutex> guard(queue->mutex);
+    auto it = queue->objects.find(name);
+    if (it == queue->objects.end())
+        return nullptr;
+    auto obj = it->second;
+    queue->objects.erase(it);
+    return obj;
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
 bool Module::parameterAdded(const int senderId, const std::string &name, const message::AddParameter &msg,
                             const std::string &moduleName)
 {
@@ -1413,6 +1813,9 @@ bool Module::dispatch(bool block, bool *messageReceived, unsigned int minPrio)
             throw(except::parent_died());
 #endif
 
+        // pass on results of block tasks that finished while waiting for input
+        publishFinishedTasks();
+
         message::Buffer buf;
         if (!getNextMessage(buf, block, minPrio)) {
             if (messageReceived)
@@ -1700,6 +2103,7 @@ bool Module::handleMessage(const vistle::message::Message *message, const Messag
         }
         if (added) {
             updateLinkedPorts(port);
+            updateFusion();
         } else {
             delete other;
         }
@@ -1740,6 +2144,7 @@ bool Module::handleMessage(const vistle::message::Message *message, const Messag
             delete p;
 
             updateLinkedPorts(port);
+            updateFusion();
         }
         break;
     }
@@ -1752,7 +2157,8 @@ bool Module::handleMessage(const vistle::message::Message *message, const Messag
 
     case message::ADDOBJECT: {
         const message::AddObject *add = static_cast<const message::AddObject *>(message);
-        auto obj = add->takeObject();
+        // fused objects are handed over within this process instead of through shared memory
+        auto obj = add->isFused() ? takeFusedObject(add->objectName()) : add->takeObject();
         const Port *p = findInputPort(add->getDestPort());
         if (!p) {
             CERR << "unknown input port " << add->getDestPort() << " in AddObject" << std::endl;
@@ -2521,6 +2927,26 @@ Module::~Module()
     vistle::message::ModuleExit m(!m_readyForQuit);
     sendMessage(m);
 
+#ifdef MODULE_THREAD
+    {
+        std::shared_ptr<FusionQueue> queue;
+        {
+            std::lock_guard<std::mutex> guard(s_fusionMutex);
+            auto it = s_fusionTargets.find(id());
+            if (it != s_fusionTargets.end()) {
+                queue = it->second.queue;
+                s_fusionTargets.erase(it);
+            }
+        }
+        if (queue) {
+            // wait for upstream modules still sending to this module
+            std::lock_guard<std::mutex> guard(queue->mutex);
+            queue->queue = nullptr;
+            queue->objects.clear();
+        }
+    }
+#endif
+
     delete sendMessageQueue;
     sendMessageQueue = nullptr;
     delete receiveMessageQueue;
@@ -2645,6 +3071,7 @@ void Module::setObjectReceivePolicy(int pol)
 {
     m_receivePolicy = pol;
     sendMessage(message::ObjectReceivePolicy(message::ObjectReceivePolicy::Policy(pol)));
+    updateFusion();
 }
 
 int Module::objectReceivePolicy() const
@@ -2674,6 +3101,14 @@ bool Module::prepareWrapper(const message::Execute *exec)
 
     clearResultCaches();
 
+    // results neither computed nor reused during an execution are discarded
+    for (const auto &r: m_previousBlockResults)
+        m_blockResultBytes -= r.second.bytes;
+    std::swap(m_previousBlockResults, m_blockResults);
+    m_blockResults.clear();
+    m_numReusedBlocks = 0;
+    m_numEvictedBlocks = 0;
+
     m_withOutput.clear();
 
     bool collective =
@@ -2709,6 +3144,13 @@ bool Module::prepareWrapper(const message::Execute *exec)
     if (m_benchmark) {
         comm().barrier();
         m_benchmarkStart = Clock::time();
+#ifndef NO_SHMEM
+        ShmDirectory::resetStats();
+        ShmContentIndex::resetStats();
+#endif
+        TaskPool::the().resetStats();
+        for (auto &c: m_resultCaches)
+            c->resetStats();
     }
 
     //CERR << "prepareWrapper: prepared=" << m_prepared << std::endl;
@@ -2741,29 +3183,77 @@ bool Module::compute()
     }
     m_lastTask = task;
 
+    if (m_reuseBlockResults) {
+        task->m_fingerprint = blockFingerprint(task);
+        if (reuseBlockResult(task)) {
+            // output is added in order with that of preceding tasks
+            publishFinishedTasks();
+            m_tasks.push_back(task);
+            return true;
+        }
+    }
+
     int concurrency = m_concurrency->getValue();
     if (concurrency <= 0)
         concurrency = hardware_concurrency() / 2;
     if (concurrency <= 1)
         concurrency = 1;
 
-    while (m_tasks.size() >= unsigned(concurrency)) {
+    if (concurrency == 1) {
+        while (!m_tasks.empty()) {
+            m_tasks.front()->wait();
+            m_tasks.pop_front();
+        }
+        m_tasks.push_back(task);
+        // don't hand off to task pool
+        return compute(task);
+    }
+
+    publishFinishedTasks();
+    // output has to be added in order: limit the number of finished tasks held back by a slow one
+    while (m_tasks.size() >= MaxHeldBackTasksPerThread * unsigned(concurrency)) {
         m_tasks.front()->wait();
         m_tasks.pop_front();
     }
+    {
+        std::unique_lock<std::mutex> guard(m_taskMutex);
+        m_taskCond.wait(guard, [this, concurrency]() { return m_runningTasks < unsigned(concurrency); });
+        ++m_runningTasks;
+    }
+    publishFinishedTasks();
     m_tasks.push_back(task);
 
-    if (concurrency == 1) {
-        // don't spawn useless thread
-        return compute(task);
+    auto promise = std::make_shared<std::promise<bool>>();
+    {
+        std::unique_lock<std::mutex> guard(task->m_mutex);
+        task->m_future = promise->get_future().share();
     }
-
-    std::unique_lock<std::mutex> guard(task->m_mutex);
+    // concurrently running tasks share the workers of the pool for processing their blocks in parallel
+    int threads = openmpThreads();
+    if (threads <= 0)
+        threads = std::max(1, int(TaskPool::the().numThreads()) / concurrency);
     auto tname = std::to_string(id()) + "b" + std::to_string(m_tasks.size()) + ":" + name();
-    task->m_future = std::async(std::launch::async, [this, tname, task] {
+    TaskPool::the().submit([this, tname, task, promise, threads]() {
         setThreadName(tname);
-        PROF_FUNC();
-        return compute(task);
+        TaskPool::ThreadLimit threadLimit(threads);
+        bool result = false;
+        std::exception_ptr exception;
+        try {
+            PROF_FUNC();
+            result = compute(task);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> guard(m_taskMutex);
+            --m_runningTasks;
+            m_taskCond.notify_all();
+        }
+        // module may go away as soon as result is available
+        if (exception)
+            promise->set_exception(exception);
+        else
+            promise->set_value(result);
     });
     return true;
 }
@@ -2775,6 +3265,32 @@ bool Module::compute(const std::shared_ptr<BlockTask> &task) const
     return false;
 }
 
+std::string Module::parameterFingerprint(const std::shared_ptr<BlockTask> &task) const
+{
+    (void)task;
+    std::stringstream str;
+    for (const auto &name: getParameterNames()) {
+        if (name.empty() || name[0] == '_')
+            continue;
+        auto p = findParameter(name);
+        str << name << "=" << std::string(*p) << "\n";
+    }
+    return str.str();
+}
+
+std::string Module::blockFingerprint(const std::shared_ptr<BlockTask> &task) const
+{
+    std::stringstream str;
+    for (const auto &p: inputPorts) {
+        auto obj = task->peekObject(&p.second);
+        if (!obj)
+            continue;
+        str << p.first << ":" << ResultCacheBase::identity(obj) << "\n";
+    }
+    str << parameterFingerprint(task);
+    return str.str();
+}
+
 bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
 {
     //CERR << "reduceWrapper: prepared=" << m_prepared << ", generation = " << m_generation << std::endl;
@@ -2847,6 +3363,19 @@ bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
         m_cancelRequested = boost::mpi::all_reduce(comm(), m_cancelRequested, std::logical_or<bool>());
     }
 
+    const auto &spill = m_cache.spillStats();
+    if (spill.spilled > 0 || spill.reloaded > 0) {
+        std::stringstream ports;
+        for (const auto &p: m_cache.residentBytes()) {
+            ports << " " << p.first << ": " << p.second / 1048576. << " MB";
+        }
+        sendInfo("shm budget exceeded on rank %d: spilled %lu cached objects (%.1f MB), reloaded %lu (%.1f MB), "
+                 "resident in cache:%s",
+                 rank(), (unsigned long)spill.spilled, spill.spilledBytes / 1048576., (unsigned long)spill.reloaded,
+                 spill.reloadedBytes / 1048576., ports.str().c_str());
+        m_cache.resetSpillStats();
+    }
+
     if (m_benchmark) {
         comm().barrier();
         double duration = Clock::time() - m_benchmarkStart;
@@ -2859,9 +3388,53 @@ bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
             sendInfo("compute() took %fs (no OpenMP)", duration);
             printf("%s:%d: compute() took %fs (no OpenMP)", name().c_str(), id(), duration);
 #endif
+#ifndef NO_SHMEM
+            auto dirStats = ShmDirectory::stats();
+            if (dirStats.lookups > 0) {
+                sendInfo("shm name lookups: %lu, %.1f%% hits, %.2f probes and %.0fns per lookup",
+                         (unsigned long)dirStats.lookups, 100. * dirStats.hits / dirStats.lookups,
+                         double(dirStats.probes) / dirStats.lookups, dirStats.averageLookupTime() * 1e9);
+            }
+            auto dedupStats = ShmContentIndex::stats();
+            if (dedupStats.hashed > 0) {
+                sendInfo("shm deduplication: %lu of %lu arrays replaced, %.1f of %.1f MB saved",
+                         (unsigned long)dedupStats.deduplicated, (unsigned long)dedupStats.hashed,
+                         dedupStats.savedBytes / 1048576., dedupStats.hashedBytes / 1048576.);
+            }
+#endif
+            // task pool is shared by all modules within a process, numbers include tasks of other modules
+            auto &pool = TaskPool::the();
+            auto poolStats = pool.stats();
+            if (poolStats.executed > 0) {
+                sendInfo("task pool: %lu block tasks on %u threads, %lu stolen, max. queue depth %lu, %.3fs idle per "
+                         "thread",
+                         (unsigned long)poolStats.executed, pool.numThreads(), (unsigned long)poolStats.stolen,
+                         (unsigned long)poolStats.maxQueueDepth, poolStats.idleTime / pool.numThreads());
+            }
+            if (m_reuseBlockResults) {
+                sendInfo("reused results of %lu blocks on rank 0, evicted %lu, keeping %.1f MB",
+                         (unsigned long)m_numReusedBlocks, (unsigned long)m_numEvictedBlocks,
+                         m_blockResultBytes / 1048576.);
+            }
+            if (!m_resultCaches.empty()) {
+                ResultCacheBase::Stats total;
+                for (const auto &c: m_resultCaches) {
+                    auto st = c->stats();
+                    total.hits += st.hits;
+                    total.misses += st.misses;
+                    total.evicted += st.evicted;
+                    total.entries += st.entries;
+                    total.bytes += st.bytes;
+                }
+                sendInfo("result caches on rank 0: %lu hits, %lu misses, %lu evicted, %lu entries holding %.1f MB",
+                         (unsigned long)total.hits, (unsigned long)total.misses, (unsigned long)total.evicted,
+                         (unsigned long)total.entries, total.bytes / 1048576.);
+            }
         }
     }
 
+    publishTransferStatistics();
+
     message::ExecutionProgress fin(message::ExecutionProgress::Finish);
     fin.setReferrer(exec->uuid());
     fin.setDestId(Id::LocalManager);
@@ -3023,6 +3596,14 @@ bool BlockTask::hasObject(const Port *p)
     return it != m_input.end();
 }
 
+Object::const_ptr BlockTask::peekObject(const Port *p) const
+{
+    auto it = m_input.find(p);
+    if (it == m_input.end())
+        return Object::const_ptr();
+    return it->second;
+}
+
 Object::const_ptr BlockTask::takeObject(const Port *p)
 {
     auto it = m_input.find(p);
@@ -3058,6 +3639,9 @@ void BlockTask::addObject(const std::string &port, Object::const_ptr obj)
 
 void BlockTask::addAllObjects()
 {
+    if (!m_fingerprint.empty())
+        m_module->storeBlockResult(*this);
+
     for (auto &port_queue: m_objects) {
         auto &port = port_queue.first;
         auto &queue = port_queue.second;
@@ -3075,6 +3659,8 @@ bool BlockTask::wait()
     if (m_future.valid()) {
         result = m_future.get();
     }
+    if (!result)
+        m_fingerprint.clear();
     addAllObjects();
     return result;
 }
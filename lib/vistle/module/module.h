@@ -26,6 +26,7 @@
 #include <exception>
 #include <deque>
 #include <mutex>
+#include <condition_variable>
 #include <future>
 #include <memory>
 
@@ -86,6 +87,8 @@ public:
 
     bool hasObject(const Port *p);
     Object::const_ptr takeObject(const Port *p);
+    //! input object for port p without removing it from the task
+    Object::const_ptr peekObject(const Port *p) const;
     template<class Type>
     typename Type::const_ptr accept(const Port *port);
     template<class Type>
@@ -112,6 +115,7 @@ protected:
     std::map<std::string, Port *> m_portsByString;
     std::set<std::shared_ptr<BlockTask>> m_dependencies;
     std::map<Port *, std::deque<Object::const_ptr>> m_objects;
+    std::string m_fingerprint; // inputs and parameters the results depend on, empty if results are not retained
 
     std::mutex m_mutex;
     std::shared_future<bool> m_future;
@@ -265,6 +269,21 @@ public:
     int reducePolicy() const;
     void setReducePolicy(int reduceRequirement /*< really message::ReducePolicy::Reduce */);
 
+    //! allow passing objects directly from and to other modules opting in, if connected in a linear chain
+    /*! Only effective if modules run as threads of the same process (MODULE_THREAD), otherwise objects always go
+     *  through the cluster manager.
+     *  Objects are only passed directly, if the downstream module receives them locally, is scheduled for single
+     *  objects and has exactly one connected input port. The object is handed over within the process, without
+     *  passing a reference through shared memory. The manager is still notified, so that it triggers the compute
+     *  and resends the object to ports connected later. */
+    void setFusable(bool enable);
+    bool isFusable() const;
+
+    //! republish results from a previous execution instead of computing a block with the same inputs and parameters
+    /*! only valid if results of compute(task) depend on nothing but the inputs of the task and on parameters */
+    void setReuseBlockResults(bool enable);
+    bool reuseBlockResults() const;
+
     void virtual prepareQuit();
 
     const HubData &getHub() const;
@@ -362,6 +381,14 @@ private:
 
     virtual bool needsSync(const message::Message &m) const;
 
+    bool m_fusable = false;
+    //! announce whether objects for an input port may be passed directly from upstream
+    void updateFusion();
+    //! pass object directly to downstream module of a fused chain, returns its port or nullptr if not part of a chain
+    const Port *sendFused(const Port *port, Object::const_ptr object);
+    //! retrieve object handed over by upstream module of a fused chain
+    Object::const_ptr takeFusedObject(const std::string &name);
+
     //! notify that a module has added a parameter
     virtual bool parameterAdded(const int senderId, const std::string &name, const message::AddParameter &msg,
                                 const std::string &moduleName);
@@ -372,6 +399,9 @@ private:
 
     virtual bool compute(); //< do processing - called on each rank individually
     virtual bool compute(const std::shared_ptr<BlockTask> &task) const;
+    //! describe the parameters the results for the inputs of task depend on, for deciding whether results can be reused
+    /*! defaults to the values of all parameters not starting with '_' */
+    virtual std::string parameterFingerprint(const std::shared_ptr<BlockTask> &task) const;
 
     std::map<std::string, Port> outputPorts;
     std::map<std::string, Port> inputPorts;
@@ -385,6 +415,7 @@ private:
     bool m_syncMessageProcessing;
 
     IntParameter *m_useResultCache = nullptr;
+    IntParameter *m_resultCacheBudget = nullptr;
     std::vector<ResultCacheBase *> m_resultCaches;
 
     int m_traceMessages;
@@ -405,8 +436,42 @@ private:
     //maximum number of parallel threads per rank
     IntParameter *m_concurrency = nullptr;
     void waitAllTasks();
+    //! add output of finished tasks at the front of m_tasks without blocking
+    void publishFinishedTasks();
     std::shared_ptr<BlockTask> m_lastTask;
     std::deque<std::shared_ptr<BlockTask>> m_tasks;
+    std::mutex m_taskMutex;
+    std::condition_variable m_taskCond;
+    unsigned m_runningTasks = 0; // tasks submitted to task pool and not yet finished
+
+    bool m_reuseBlockResults = false;
+    IntParameter *m_blockResultBudget = nullptr;
+    struct BlockResult {
+        std::string tag; // stands in for the identity of the objects in fingerprints of downstream modules
+        std::vector<std::pair<Port *, Object::const_ptr>> objects;
+        size_t bytes = 0; // estimated memory held by objects
+        uint64_t lastUse = 0;
+    };
+    // results of current and previous execution by fingerprint
+    std::map<std::string, BlockResult> m_blockResults, m_previousBlockResults;
+    size_t m_numBlockResults = 0, m_numReusedBlocks = 0, m_numEvictedBlocks = 0;
+    size_t m_blockResultBytes = 0;
+    uint64_t m_blockResultUses = 0;
+    std::string blockFingerprint(const std::shared_ptr<BlockTask> &task) const;
+    //! queue republishing of stored results for task, returns false if there are none
+    bool reuseBlockResult(const std::shared_ptr<BlockTask> &task);
+    void storeBlockResult(BlockTask &task);
+    //! discard least recently used block results until their estimated size is within budget
+    void evictBlockResults();
+
+    // objects received by sendObject/broadcastObject, by operation
+    mutable std::mutex m_transferStatisticsMutex;
+    mutable std::map<std::string, message::TransferStatistics::Entry> m_transferStatistics;
+    mutable bool m_transferStatisticsChanged = false;
+    //! account an object received from another rank: bytes moved, seconds for moving and for restoring it
+    void recordTransfer(const std::string &op, size_t bytes, double transferTime, double loadTime) const;
+    //! report accumulated transfers to the master hub, if anything changed since the last report
+    void publishTransferStatistics();
 
     unsigned m_hardware_concurrency = 1;
 
@@ -1,9 +1,152 @@
 #include "objectcache.h"
 #include "module.h"
 #include <vistle/core/shm.h>
+#include <vistle/core/shm_arena.h>
+#include <vistle/core/archives.h>
+#include <vistle/core/archive_saver.h>
+#include <vistle/core/archive_loader.h>
+#include <vistle/util/vecstreambuf.h>
+#include <vistle/util/sysdep.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 
 namespace vistle {
 
+namespace {
+
+// start spilling when shm usage exceeds this fraction of the budget
+const double HighWater = 0.9;
+// spill until usage is expected to drop below this fraction
+const double LowWater = 0.8;
+
+const std::string &spillDirectory()
+{
+    static const std::string dir = []() {
+        std::filesystem::path path;
+        if (const char *env = getenv("VISTLE_SHM_SPILL_DIR")) {
+            path = env;
+        } else {
+            path = std::filesystem::temp_directory_path() / ("vistle_spill_" + std::to_string(getuid()));
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+        return path.string();
+    }();
+    return dir;
+}
+
+std::string spillPath(const std::string &objectName)
+{
+    std::string name = objectName;
+    std::replace(name.begin(), name.end(), '/', '_');
+    return spillDirectory() + "/" + std::to_string(getpid()) + "_" + name + ".vsld";
+}
+
+void writeChunk(std::ofstream &file, const char *data, uint64_t size)
+{
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(data, size);
+}
+
+bool readChunk(std::ifstream &file, buffer &buf)
+{
+    uint64_t size = 0;
+    if (!file.read(reinterpret_cast<char *>(&size), sizeof(size)))
+        return false;
+    buf.resize(size);
+    return bool(file.read(buf.data(), size));
+}
+
+// file layout: no. of sub-archives, their names, types and sizes, the serialized object, then all sub-archives
+bool spillObject(Object::const_ptr obj, const std::string &path)
+{
+    auto saver = std::make_shared<DeepArchiveSaver>();
+    vecostreambuf<buffer> memstr;
+    vistle::oarchive memar(memstr);
+    memar.setSaver(saver);
+    obj->saveObject(memar);
+    auto dir = saver->getDirectory();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    uint64_t num = dir.size();
+    file.write(reinterpret_cast<const char *>(&num), sizeof(num));
+    for (const auto &ent: dir) {
+        writeChunk(file, ent.name.data(), ent.name.size());
+        char isArray = ent.is_array;
+        file.write(&isArray, 1);
+        uint64_t size = ent.size;
+        file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    }
+    const buffer &mem = memstr.get_vector();
+    writeChunk(file, mem.data(), mem.size());
+    for (const auto &ent: dir) {
+        file.write(ent.data, ent.size);
+    }
+    file.close();
+    if (!file) {
+        std::cerr << "ObjectCache: failed to spill " << obj->getName() << " to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Object::const_ptr restoreObject(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    uint64_t num = 0;
+    if (!file.read(reinterpret_cast<char *>(&num), sizeof(num)))
+        return nullptr;
+    SubArchiveDirectory dir(num);
+    for (auto &ent: dir) {
+        buffer name;
+        char isArray = 0;
+        uint64_t size = 0;
+        if (!readChunk(file, name) || !file.read(&isArray, 1) || !file.read(reinterpret_cast<char *>(&size), sizeof(size)))
+            return nullptr;
+        ent.name = std::string(name.data(), name.size());
+        ent.is_array = isArray;
+        ent.size = size;
+    }
+    buffer mem;
+    if (!readChunk(file, mem))
+        return nullptr;
+    std::map<std::string, buffer> objects, arrays;
+    std::map<std::string, message::CompressionMode> comp;
+    std::map<std::string, size_t> rawsizes;
+    for (auto &ent: dir) {
+        auto &buf = ent.is_array ? arrays[ent.name] : objects[ent.name];
+        buf.resize(ent.size);
+        if (!file.read(buf.data(), ent.size))
+            return nullptr;
+    }
+
+    try {
+        vecistreambuf<buffer> membuf(mem);
+        vistle::iarchive memar(membuf);
+        auto fetcher = std::make_shared<DeepArchiveFetcher>(objects, arrays, comp, rawsizes);
+        fetcher->prefetchArrays();
+        memar.setFetcher(fetcher);
+        Object::ptr obj(Object::loadObject(memar));
+        return obj;
+    } catch (std::exception &ex) {
+        std::cerr << "ObjectCache: failed to restore object from " << path << ": " << ex.what() << std::endl;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+ObjectCache::SpillFile::SpillFile(const std::string &path): path(path)
+{}
+
+ObjectCache::SpillFile::~SpillFile()
+{
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
 ObjectCache::ObjectCache(): m_cacheMode(ObjectCache::CacheByName)
 {}
 
@@ -107,6 +250,8 @@ void ObjectCache::addObject(const std::string &portname, Object::const_ptr objec
                 auto olditer = entry.iteration;
                 if (iter >= olditer) {
                     entry = Entry(object, m_cacheMode == CacheByName);
+                    entry.lastUse = ++m_useCount;
+                    relievePressure();
                 } else {
                     std::cerr << "ObjectCache: ignoring object with iteration " << iter << " for port " << portname
                               << " (old: " << olditer << "): " << *object << std::endl;
@@ -117,10 +262,13 @@ void ObjectCache::addObject(const std::string &portname, Object::const_ptr objec
     }
 
     cache.emplace_back(object, m_cacheMode == CacheByName);
+    cache.back().lastUse = ++m_useCount;
+    relievePressure();
 }
 
-std::pair<std::map<std::string, ObjectList>, bool> ObjectCache::getObjects() const
+std::pair<std::map<std::string, ObjectList>, bool> ObjectCache::getObjects()
 {
+    const uint64_t use = ++m_useCount;
     std::map<std::string, ObjectList> objLists;
     for (const auto &portname: m_connectedPorts) {
         auto it = m_cache.find(portname);
@@ -129,11 +277,28 @@ std::pair<std::map<std::string, ObjectList>, bool> ObjectCache::getObjects() con
             return std::make_pair(objLists, false);
         }
 
-        const auto &cache = it->second;
+        auto &cache = it->second;
         ObjectList objs;
-        for (const auto &e: cache) {
+        for (auto &e: cache) {
+            e.lastUse = use;
             if (e.object) {
                 objs.push_back(e.object);
+            } else if (e.spilled) {
+                // object might still be held by another module
+                auto o = Shm::the().getObjectFromName(e.name);
+                if (!o) {
+                    o = restoreObject(e.spilled->path);
+                    if (o) {
+                        ++m_spillStats.reloaded;
+                        m_spillStats.reloadedBytes += e.bytes;
+                    }
+                }
+                if (!o) {
+                    objLists.clear();
+                    return std::make_pair(objLists, false);
+                }
+                e.object = o;
+                objs.push_back(o);
             } else if (auto o = Shm::the().getObjectFromName(e.name)) {
                 objs.push_back(o);
             } else {
@@ -146,4 +311,86 @@ std::pair<std::map<std::string, ObjectList>, bool> ObjectCache::getObjects() con
 
     return std::make_pair(objLists, true);
 }
+
+std::map<std::string, size_t> ObjectCache::residentBytes() const
+{
+    std::map<std::string, size_t> bytes;
+    for (const auto *cache: {&m_cache, &m_oldCache}) {
+        for (const auto &port: *cache) {
+            auto &b = bytes[port.first];
+            for (const auto &e: port.second) {
+                if (e.object)
+                    b += ArrayMemoryCounter::count(e.object);
+            }
+        }
+    }
+    return bytes;
+}
+
+size_t ObjectCache::relievePressure()
+{
+    const size_t budget = Shm::budget();
+    if (budget == 0 || !Shm::isAttached())
+        return 0;
+    size_t used = Shm::the().usedMemory();
+    if (used <= budget * HighWater)
+        return 0;
+    const size_t lowWater = size_t(budget * LowWater);
+
+    std::vector<Entry *> candidates;
+    for (auto *cache: {&m_cache, &m_oldCache}) {
+        for (auto &port: *cache) {
+            for (auto &e: port.second) {
+                // the object added most recently is about to be processed
+                if (!e.object || e.lastUse >= m_useCount)
+                    continue;
+                // dropping objects that are also referenced elsewhere would not free any memory
+                if (e.object.use_count() == 1 && e.object->refcount() == 1)
+                    candidates.push_back(&e);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Entry *a, const Entry *b) { return a->lastUse < b->lastUse; });
+
+    size_t spilled = 0;
+    for (auto *e: candidates) {
+        if (used <= lowWater)
+            break;
+        if (!e->spilled) {
+            // objects reloaded before are still on disk
+            auto path = spillPath(e->name);
+            if (!spillObject(e->object, path)) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                continue;
+            }
+            e->spilled = std::make_shared<SpillFile>(path);
+        }
+        e->object.reset();
+#ifndef NO_SHMEM
+        // blocks freed by this thread would otherwise stay allocated in its arena cache
+        ShmArena::release();
+#endif
+        // arrays might still be shared with other objects: account for what has actually been freed
+        const size_t now = Shm::the().usedMemory();
+        e->bytes = used > now ? used - now : 0;
+        used = now;
+        spilled += e->bytes;
+        ++m_spillStats.spilled;
+        m_spillStats.spilledBytes += e->bytes;
+    }
+    return spilled;
+}
+
+const ObjectCache::SpillStats &ObjectCache::spillStats() const
+{
+    return m_spillStats;
+}
+
+void ObjectCache::resetSpillStats()
+{
+    m_spillStats = SpillStats();
+}
+
 } // namespace vistle
@@ -1,9 +1,11 @@
 #ifndef VISTLE_MODULE_OBJECTCACHE_H
 #define VISTLE_MODULE_OBJECTCACHE_H
 
+#include <cstdint>
 #include <string>
 #include <map>
 #include <deque>
+#include <memory>
 
 #include <vistle/util/enum.h>
 #include <vistle/core/object.h>
@@ -28,16 +30,36 @@ public:
     void setCacheMode(CacheMode mode);
 
     void addObject(const std::string &portname, Object::const_ptr object, bool isComputePort);
-    std::pair<std::map<std::string, ObjectList>, bool> getObjects() const;
+    // objects spilled to disk are reloaded
+    std::pair<std::map<std::string, ObjectList>, bool> getObjects();
     // keep track of connected ports
     void addPort(const std::string &portname);
     void removePort(const std::string &portname);
 
+    // bytes held resident by arrays of cached objects per port, computed on demand
+    std::map<std::string, size_t> residentBytes() const;
+    // if shm usage exceeds the budget, spill least recently used objects to disk, returns no. of bytes spilled
+    size_t relievePressure();
+
+    struct SpillStats {
+        size_t spilled = 0, spilledBytes = 0;
+        size_t reloaded = 0, reloadedBytes = 0;
+    };
+    const SpillStats &spillStats() const;
+    void resetSpillStats();
+
 private:
     CacheMode m_cacheMode;
 
     int m_generation = 0;
 
+    // removes the file holding a spilled object when the last entry referring to it goes away
+    struct SpillFile {
+        SpillFile(const std::string &path);
+        ~SpillFile();
+        std::string path;
+    };
+
     struct Entry {
         Entry(Object::const_ptr object, bool cacheByNameOnly);
         std::string name;
@@ -45,9 +67,14 @@ private:
         int block;
         int timestep;
         int iteration;
+        size_t bytes = 0; // shm freed when object was spilled
+        uint64_t lastUse = 0;
+        std::shared_ptr<SpillFile> spilled;
     };
     typedef std::vector<Entry> EntryList;
     std::map<std::string, EntryList> m_cache, m_oldCache;
+    uint64_t m_useCount = 0;
+    SpillStats m_spillStats;
 
     std::map<std::string, Meta> m_meta;
     std::set<std::string> m_connectedPorts;
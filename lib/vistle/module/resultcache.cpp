@@ -1,12 +1,81 @@
 #include "resultcache.h"
 #include "resultcache_impl.h"
 
+#include <vistle/core/archive_saver.h>
+
 namespace vistle {
 
+namespace {
+
+// attribute identifying contents of an object, instead of its name
+const char IdentityAttribute[] = "_fingerprint";
+
+} // namespace
+
 ResultCacheBase::~ResultCacheBase() = default;
 
 void ResultCacheBase::enable(bool on)
 {
     m_enabled = on;
 }
+
+void ResultCacheBase::setPersistent(bool persistent)
+{
+    m_persistent = persistent;
+}
+
+bool ResultCacheBase::persistent() const
+{
+    return m_persistent;
+}
+
+void ResultCacheBase::setBudget(size_t bytes)
+{
+    m_budget = bytes;
+}
+
+size_t ResultCacheBase::budget() const
+{
+    return m_budget;
+}
+
+ResultCacheBase::Stats ResultCacheBase::stats() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_stats;
+}
+
+void ResultCacheBase::resetStats()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.evicted = 0;
+}
+
+std::string ResultCacheBase::identity(Object::const_ptr obj)
+{
+    // attributes are copied to derived objects: only trust tags applied by the creator of an object
+    if (obj->hasAttribute(IdentityAttribute)) {
+        auto tag = obj->getAttribute(IdentityAttribute);
+        auto creator = std::to_string(obj->getCreator());
+        if (tag.compare(0, creator.size() + 1, creator + ":") == 0)
+            return tag;
+    }
+    return obj->getName();
+}
+
+bool ResultCacheBase::setIdentity(Object::ptr obj, int creator, const std::string &tag)
+{
+    if (obj->getCreator() != creator)
+        return false;
+    obj->setAttributeList(IdentityAttribute, {std::to_string(creator) + ":" + tag});
+    return true;
+}
+
+size_t ResultCacheBase::objectSize(Object::const_ptr obj)
+{
+    return ArrayMemoryCounter::count(obj);
+}
+
 } // namespace vistle
@@ -3,24 +3,71 @@
 
 #include "export.h"
 
+#include <vistle/core/object.h>
+
+#include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <deque>
+#include <type_traits>
 
 namespace vistle {
 
 class V_MODULEEXPORT ResultCacheBase {
 public:
+    struct Stats {
+        size_t hits = 0, misses = 0;
+        size_t evicted = 0; //!< number of results discarded for staying within budget
+        size_t entries = 0, bytes = 0; //!< currently stored results and their estimated size
+    };
+
     virtual ~ResultCacheBase();
     virtual void clear() = 0;
     virtual void enable(bool on);
 
+    //! keep results across executions, keys have to capture everything a result depends on
+    void setPersistent(bool persistent);
+    bool persistent() const;
+    //! evict least recently used results if their estimated size exceeds bytes, 0: unlimited
+    void setBudget(size_t bytes);
+    size_t budget() const;
+
+    Stats stats() const;
+    void resetStats();
+
+    //! identifies contents of obj in keys, stable across executions for objects republished from cache
+    /*! otherwise, this is the name of obj, which is never reused for other contents, so keys cannot become stale */
+    static std::string identity(Object::const_ptr obj);
+    //! mark obj as a result of module creator which can be reproduced from inputs and parameters described by tag
+    /*! obj must not have been published yet, returns false and leaves obj untouched if it was not created by creator */
+    static bool setIdentity(Object::ptr obj, int creator, const std::string &tag);
+
+    //! estimated memory held by arrays of obj and of the objects referenced by it
+    static size_t objectSize(Object::const_ptr obj);
+
 protected:
     bool m_enabled = true;
+    bool m_persistent = false;
+    size_t m_budget = 0;
+
+    mutable std::mutex m_mutex;
+    Stats m_stats;
 };
 
-//! data structure for retaining data that can be reused between timesteps
+//! estimated memory occupied by result, override for types holding large data
+template<class Result>
+size_t resultSize(const Result &result)
+{
+    if constexpr (std::is_convertible_v<Result, Object::const_ptr>) {
+        return sizeof(Result) + ResultCacheBase::objectSize(result);
+    } else {
+        return sizeof(Result);
+    }
+}
+
+//! data structure for retaining data that can be reused between timesteps and, if persistent, between executions
 template<class Result>
 class ResultCache: public ResultCacheBase {
 public:
@@ -31,25 +78,30 @@ public:
         std::mutex mutex;
         size_t generation = 0;
         Result data;
+        bool valid = false;
+        size_t bytes = 0;
+        uint64_t lastUse = 0;
+        unsigned users = 0; // entry may not be evicted while in use
     };
 
     //! if available, retrieve value for key, store to result, and return nullptr;
     //! otherwise the entry corresponding to key is locked and has to be updated with storeAndUnlock via the returned Entry
     Entry *getOrLock(const std::string &key, Result &result);
-    //! update value stored for entry with data and unlock it
-    bool storeAndUnlock(Entry *entry, const Result &data);
+    //! update value stored for entry with data and unlock it, bytes = 0: estimate size with resultSize(data)
+    bool storeAndUnlock(Entry *entry, const Result &data, size_t bytes = 0);
     //! discard all currently stored values
     void clear() override;
 
 protected:
-    std::mutex m_mutex;
     size_t m_generation = 0, m_purgedGenerations = 0;
+    uint64_t m_useCount = 0;
     Entry m_empty;
     std::deque<std::map<std::string, Entry>> m_cache;
     std::deque<size_t> m_borrowCount;
 
     void modifyBorrowCount(size_t generation, int delta); // assumes that m_mutex is already locked
     void purgeOldGenerations(); // assumes that m_mutex is already locked
+    void evict(); // assumes that m_mutex is already locked
 };
 
 } // namespace vistle
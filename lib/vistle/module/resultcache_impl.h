@@ -3,7 +3,9 @@
 
 #include "resultcache.h"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace vistle {
 
@@ -35,14 +37,21 @@ typename ResultCache<Result>::Entry *ResultCache<Result>::getOrLock(const std::s
     if (it == cache.end()) {
         auto &ent = cache[key];
         ent.generation = m_generation;
+        ent.lastUse = ++m_useCount;
+        ent.users = 1;
         ent.mutex.lock();
         modifyBorrowCount(m_generation, 1);
+        ++m_stats.misses;
+        ++m_stats.entries;
         return &ent;
     }
 
     auto &ent = it->second;
     auto generation = ent.generation;
+    ent.lastUse = ++m_useCount;
+    ++ent.users;
     modifyBorrowCount(generation, 1);
+    ++m_stats.hits;
     guard.unlock();
 
     std::unique_lock<std::mutex> member_guard(ent.mutex);
@@ -50,23 +59,32 @@ typename ResultCache<Result>::Entry *ResultCache<Result>::getOrLock(const std::s
     member_guard.unlock();
 
     guard.lock();
+    --ent.users;
     modifyBorrowCount(generation, -1);
 
     return nullptr;
 }
 
 template<class Result>
-bool ResultCache<Result>::storeAndUnlock(ResultCache<Result>::Entry *entry, const Result &data)
+bool ResultCache<Result>::storeAndUnlock(ResultCache<Result>::Entry *entry, const Result &data, size_t bytes)
 {
     if (!entry)
         return false;
     if (entry == &m_empty)
         return false;
+    if (bytes == 0)
+        bytes = resultSize(data);
     entry->data = data;
     auto generation = entry->generation;
     entry->mutex.unlock();
 
     std::unique_lock<std::mutex> guard(m_mutex);
+    m_stats.bytes += bytes;
+    m_stats.bytes -= entry->bytes;
+    entry->bytes = bytes;
+    entry->valid = true;
+    --entry->users;
+    evict();
     modifyBorrowCount(generation, -1);
 
     return true;
@@ -90,12 +108,44 @@ void ResultCache<Result>::purgeOldGenerations()
     while (m_borrowCount.size() > 1) {
         if (m_borrowCount.front() > 0)
             break;
+        for (const auto &ent: m_cache.front()) {
+            m_stats.bytes -= ent.second.bytes;
+            --m_stats.entries;
+        }
         ++m_purgedGenerations;
         m_borrowCount.pop_front();
         m_cache.pop_front();
     }
 }
 
+template<class Result>
+void ResultCache<Result>::evict()
+{
+    if (m_budget == 0 || m_stats.bytes <= m_budget)
+        return;
+
+    typedef typename std::map<std::string, Entry>::iterator Iterator;
+    std::vector<std::pair<std::map<std::string, Entry> *, Iterator>> candidates;
+    for (auto &cache: m_cache) {
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (it->second.valid && it->second.users == 0)
+                candidates.emplace_back(&cache, it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+        return a.second->second.lastUse < b.second->second.lastUse;
+    });
+
+    for (auto &c: candidates) {
+        if (m_stats.bytes <= m_budget)
+            break;
+        m_stats.bytes -= c.second->second.bytes;
+        --m_stats.entries;
+        ++m_stats.evicted;
+        c.first->erase(c.second);
+    }
+}
+
 } // namespace vistle
 
 #endif
@@ -466,6 +466,58 @@ static std::vector<int> getAllHubs()
     return state().getSlaveHubs();
 }
 
+static StateTracker::TransferStatisticsMap transferStatistics()
+{
+    py::gil_scoped_release release;
+    std::unique_lock<PythonStateAccessor> guard(access());
+    return state().getTransferStatistics();
+}
+
+static py::list getTransferStatistics()
+{
+    py::list result;
+    for (const auto &rank: transferStatistics()) {
+        for (const auto &ent: rank.second) {
+            py::dict d;
+            d["hub"] = rank.first.first;
+            d["rank"] = rank.first.second;
+            d["module"] = ent.module;
+            d["port"] = ent.port;
+            d["compression"] = message::toString(message::CompressionMode(ent.compression));
+            d["transfers"] = ent.transfers;
+            d["raw_bytes"] = ent.rawBytes;
+            d["compressed_bytes"] = ent.compressedBytes;
+            d["compress_time"] = ent.compressTime;
+            d["decompress_time"] = ent.decompressTime;
+            d["wait_time"] = ent.waitTime;
+            d["wire_time"] = ent.wireTime;
+            result.append(d);
+        }
+    }
+    return result;
+}
+
+static bool dumpTransferStatistics(const std::string &filename)
+{
+    auto stats = transferStatistics();
+    py::gil_scoped_release release;
+    std::ofstream csv(filename);
+    if (!csv)
+        return false;
+    csv << "hub,rank,module,port,compression,transfers,raw_bytes,compressed_bytes,compress_time,decompress_time,"
+           "wait_time,wire_time"
+        << std::endl;
+    for (const auto &rank: stats) {
+        for (const auto &ent: rank.second) {
+            csv << rank.first.first << "," << rank.first.second << "," << ent.module << "," << ent.port << ","
+                << message::toString(message::CompressionMode(ent.compression)) << "," << ent.transfers << ","
+                << ent.rawBytes << "," << ent.compressedBytes << "," << ent.compressTime << "," << ent.decompressTime
+                << "," << ent.waitTime << "," << ent.wireTime << std::endl;
+        }
+    }
+    return bool(csv);
+}
+
 static std::vector<int> getRunning()
 {
     py::gil_scoped_release release;
@@ -1703,6 +1755,11 @@ PY_MODULE(_vistle, m)
     m.def("getVistleSession", getVistleSession, "get ID for Vistle session");
     m.def("getWorkflowConfig", getWorkflowConfig, "get ID for workflow configuration");
     m.def("getAllHubs", getAllHubs, "get ID of all known hubs");
+    m.def("getTransferStatistics", getTransferStatistics,
+          "get accumulated statistics of object transfers between hubs per receiving rank, source port and codec, "
+          "and of transfers between ranks by modules (hub is the module ID, port is the operation)");
+    m.def("dumpTransferStatistics", dumpTransferStatistics,
+          "write statistics of object transfers between hubs to CSV file `filename`", "filename"_a);
     m.def("getHub", getHub, "get ID of hub for module with ID `arg1`");
     m.def("getConnections", getConnections, "get connections to/from port `arg2` of module with ID `arg1`");
     m.def("getParameters", getParameters, "get list of parameters for module with ID `arg1`");
@@ -456,6 +456,8 @@ getWorkflowConfig = _vistle.getWorkflowConfig
 getSessionUrl = _vistle.getSessionUrl
 getAllHubs = _vistle.getAllHubs
 getHub = _vistle.getHub
+getTransferStatistics = _vistle.getTransferStatistics
+dumpTransferStatistics = _vistle.dumpTransferStatistics
 getPortDescription = _vistle.getPortDescription
 getInputPorts = _vistle.getInputPorts
 getOutputPorts = _vistle.getOutputPorts
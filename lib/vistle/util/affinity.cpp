@@ -4,6 +4,7 @@
 #include <cstring>
 #include <cerrno>
 #include <iostream>
+#include <algorithm>
 
 #if defined(HAVE_HWLOC)
 #include <hwloc.h>
@@ -15,6 +16,13 @@
 #endif
 #include <sched.h>
 #include <sys/sysinfo.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <vector>
 #define SHOW_AFFINITY
 #endif
 
@@ -87,6 +95,24 @@ int get_num_cpus()
 {
     return get_nprocs_conf();
 }
+
+// from linux/mempolicy.h
+const int MpolBind = 2;
+
+// NUMA node of cpu from sysfs, -1 if unknown
+int numa_node_of_cpu(int cpu)
+{
+    std::error_code ec;
+    std::filesystem::path dir("/sys/devices/system/cpu/cpu" + std::to_string(cpu));
+    for (const auto &entry: std::filesystem::directory_iterator(dir, ec)) {
+        auto name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return atoi(name.c_str() + 4);
+        }
+    }
+    return -1;
+}
 #endif
 } // namespace
 
@@ -301,4 +327,141 @@ bool apply_affinity_from_environment(int nodeRank, int ranksOnThisNode)
     return false;
 }
 
+int numa_node_of_affinity()
+{
+#if defined(HAVE_HWLOC)
+    hwloc_topology_t topology;
+    if (hwloc_topology_init(&topology) == -1) {
+        return -1;
+    }
+    hwloc_topology_load(topology);
+    hwloc_cpuset_t set = hwloc_bitmap_alloc();
+    hwloc_nodeset_t nodeset = hwloc_bitmap_alloc();
+    int node = -1;
+    if (set && nodeset && hwloc_get_cpubind(topology, set, HWLOC_CPUBIND_PROCESS) != -1) {
+        hwloc_cpuset_to_nodeset(topology, set, nodeset);
+        if (hwloc_bitmap_weight(nodeset) == 1)
+            node = hwloc_bitmap_first(nodeset);
+    }
+    if (set)
+        hwloc_bitmap_free(set);
+    if (nodeset)
+        hwloc_bitmap_free(nodeset);
+    hwloc_topology_destroy(topology);
+    return node;
+#elif defined(SHOW_AFFINITY)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0 /* this process */, sizeof(set), &set) == -1)
+        return -1;
+    int node = -1;
+    int nprocs = get_num_cpus();
+    for (int cpu = 0; cpu < nprocs; ++cpu) {
+        if (!CPU_ISSET(cpu, &set))
+            continue;
+        int n = numa_node_of_cpu(cpu);
+        if (n < 0 || (node >= 0 && n != node))
+            return -1;
+        node = n;
+    }
+    return node;
+#else
+    return -1;
+#endif
+}
+
+bool bind_memory_to_numa_node(void *addr, size_t len, int node)
+{
+#ifdef SHOW_AFFINITY
+    if (node < 0)
+        return false;
+    const size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1);
+    mask[node / bits] |= 1ul << (node % bits);
+    if (syscall(SYS_mbind, addr, len, MpolBind, mask.data(), mask.size() * bits + 1, 0) == -1) {
+        std::cerr << "failed to bind memory to NUMA node " << node << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)addr;
+    (void)len;
+    (void)node;
+    return false;
+#endif
+}
+
+bool advise_huge_pages(void *addr, size_t len)
+{
+#if defined(SHOW_AFFINITY) && defined(MADV_HUGEPAGE)
+    if (madvise(addr, len, MADV_HUGEPAGE) == -1) {
+        std::cerr << "failed to request transparent huge pages: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)addr;
+    (void)len;
+    return false;
+#endif
+}
+
+std::string shmem_huge_pages_mode()
+{
+#ifdef SHOW_AFFINITY
+    std::ifstream f("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+    std::string word;
+    while (f >> word) {
+        // active setting is enclosed in brackets
+        if (word.size() > 2 && word.front() == '[' && word.back() == ']')
+            return word.substr(1, word.size() - 2);
+    }
+#endif
+    return std::string("n/a");
+}
+
+std::string memory_placement(const void *addr, size_t len)
+{
+#ifdef SHOW_AFFINITY
+    const size_t MaxSamples = 4096;
+    const size_t pagesize = sysconf(_SC_PAGESIZE);
+    const size_t npages = len / pagesize;
+    if (npages == 0)
+        return std::string("empty");
+    const size_t nsamples = std::min(npages, MaxSamples);
+    std::vector<void *> pages(nsamples);
+    std::vector<int> status(nsamples);
+    const char *base = static_cast<const char *>(addr);
+    for (size_t i = 0; i < nsamples; ++i) {
+        pages[i] = const_cast<char *>(base + (i * npages / nsamples) * pagesize);
+    }
+    if (syscall(SYS_move_pages, 0, nsamples, pages.data(), nullptr, status.data(), 0) == -1) {
+        return std::string("ERROR: ") + strerror(errno);
+    }
+    std::map<int, size_t> pagesPerNode;
+    size_t absent = 0, failed = 0;
+    for (auto st: status) {
+        if (st >= 0)
+            ++pagesPerNode[st];
+        else if (st == -ENOENT)
+            ++absent;
+        else
+            ++failed;
+    }
+    std::stringstream str;
+    for (const auto &n: pagesPerNode) {
+        str << "node " << n.first << ": " << n.second << ", ";
+    }
+    str << "not present: " << absent;
+    if (failed > 0)
+        str << ", unknown: " << failed;
+    str << " of " << nsamples << " sampled pages";
+    return str.str();
+#else
+    (void)addr;
+    (void)len;
+    return std::string("n/a");
+#endif
+}
+
 } // namespace vistle
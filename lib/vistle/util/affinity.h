@@ -3,6 +3,7 @@
 
 #include "export.h"
 
+#include <cstddef>
 #include <string>
 
 namespace vistle {
@@ -12,5 +13,16 @@ V_UTILEXPORT std::string thread_affinity_map();
 V_UTILEXPORT std::string hwloc_affinity_map(int flags = -1);
 V_UTILEXPORT bool apply_affinity_from_environment(int nodeRank, int ranksOnThisNode);
 
+// NUMA node containing all CPUs the calling process is bound to, -1 if not bound to a single node
+V_UTILEXPORT int numa_node_of_affinity();
+// set memory policy of [addr, addr+len) so that pages are allocated from NUMA node
+V_UTILEXPORT bool bind_memory_to_numa_node(void *addr, size_t len, int node);
+// request transparent huge pages for backing [addr, addr+len)
+V_UTILEXPORT bool advise_huge_pages(void *addr, size_t len);
+// setting of transparent huge pages for shared memory, as configured in the kernel
+V_UTILEXPORT std::string shmem_huge_pages_mode();
+// summary of NUMA nodes on which a sample of the pages in [addr, addr+len) are resident
+V_UTILEXPORT std::string memory_placement(const void *addr, size_t len);
+
 } // namespace vistle
 #endif
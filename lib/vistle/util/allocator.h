@@ -1,10 +1,49 @@
 #ifndef VISTLE_UTIL_ALLOCATOR_H
 #define VISTLE_UTIL_ALLOCATOR_H
 
+#include <cstddef>
 #include <memory>
+#include <new>
 
 namespace vistle {
 
+// Allocator returning storage aligned to Alignment bytes
+template<typename T, size_t Alignment>
+class aligned_allocator {
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept
+    {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignment())));
+    }
+    void deallocate(T *p, size_t) noexcept { ::operator delete(p, std::align_val_t(alignment())); }
+
+    template<typename U>
+    bool operator==(const aligned_allocator<U, Alignment> &) const noexcept
+    {
+        return true;
+    }
+    template<typename U>
+    bool operator!=(const aligned_allocator<U, Alignment> &) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static constexpr size_t alignment() { return Alignment > alignof(T) ? Alignment : alignof(T); }
+};
+
 // Allocator adaptor that interposes construct() calls to
 // convert value initialization into default initialization.
 // from http://stackoverflow.com/a/21028912/273767
@@ -2,7 +2,12 @@
 
 #include <cstdlib>
 #include <boost/asio/ip/host_name.hpp>
+#include <fstream>
 #include <iostream>
+#ifdef __linux__
+#include <unistd.h>
+#include <limits.h>
+#endif
 
 namespace vistle {
 
@@ -40,4 +45,26 @@ std::string hostname()
     return hname;
 }
 
+std::string shmnamespace()
+{
+    static const std::string ns = []() {
+        std::string ns;
+#ifdef __linux__
+        // POSIX shared memory lives in /dev/shm, which depends on the mount namespace
+        std::ifstream boot("/proc/sys/kernel/random/boot_id");
+        std::getline(boot, ns);
+        for (const char *link: {"/proc/self/ns/mnt", "/proc/self/ns/ipc"}) {
+            char buf[PATH_MAX];
+            ssize_t len = readlink(link, buf, sizeof(buf) - 1);
+            if (len > 0) {
+                ns += ":" + std::string(buf, len);
+            }
+        }
+#endif
+        return ns;
+    }();
+
+    return ns;
+}
+
 } // namespace vistle
@@ -9,6 +9,9 @@ namespace vistle {
 
 V_UTILEXPORT std::string clustername();
 V_UTILEXPORT std::string hostname();
+// identifies the running kernel and the namespaces of this process,
+// processes on the same host can only share POSIX shared memory objects if these match
+V_UTILEXPORT std::string shmnamespace();
 
 } // namespace vistle
 #endif
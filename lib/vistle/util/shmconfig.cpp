@@ -17,4 +17,37 @@ bool shmPerRank()
 #endif
 }
 
+namespace {
+
+bool agreeOnFlag(const char *envName, bool defaultValue)
+{
+    bool flag = defaultValue;
+    if (const char *env = getenv(envName))
+        flag = atoi(env) != 0;
+    boost::mpi::broadcast(boost::mpi::communicator(), flag, 0);
+    return flag;
+}
+
+} // namespace
+
+bool shmHugePages(bool defaultValue)
+{
+#ifndef NO_SHMEM
+    return agreeOnFlag("VISTLE_SHM_HUGEPAGES", defaultValue);
+#else
+    (void)defaultValue;
+    return false;
+#endif
+}
+
+bool shmBindNuma(bool defaultValue)
+{
+#ifndef NO_SHMEM
+    return agreeOnFlag("VISTLE_SHM_NUMA", defaultValue);
+#else
+    (void)defaultValue;
+    return false;
+#endif
+}
+
 } // namespace vistle
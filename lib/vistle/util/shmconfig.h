@@ -8,5 +8,12 @@ namespace vistle {
 bool V_UTILMPIEXPORT
 shmPerRank(); // do MPI communication in order to agree whether shmem should be used by all ranks on a node
 
+// do MPI communication in order to agree whether shmem should be backed by transparent huge pages,
+// VISTLE_SHM_HUGEPAGES overrides defaultValue
+bool V_UTILMPIEXPORT shmHugePages(bool defaultValue = false);
+// do MPI communication in order to agree whether per-rank shmem should be bound to the NUMA node of its rank,
+// VISTLE_SHM_NUMA overrides defaultValue
+bool V_UTILMPIEXPORT shmBindNuma(bool defaultValue = false);
+
 }
 #endif
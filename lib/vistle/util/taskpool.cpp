@@ -0,0 +1,261 @@
+#include "taskpool.h"
+#include "stopwatch.h"
+#include "threadname.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace vistle {
+
+namespace {
+
+// identifies the worker executing on the current thread, used for queueing nested submissions locally
+thread_local const TaskPool *s_pool = nullptr;
+thread_local unsigned s_workerIndex = 0;
+// per thread, so that modules and tasks sharing the process do not override each other's limits
+thread_local int t_threadLimit = 0;
+
+} // namespace
+
+TaskPool::TaskPool(unsigned numThreads, const std::string &name): m_name(name)
+{
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+        numThreads = 1;
+
+    m_statsStart = Clock::time();
+    m_idleSince.resize(numThreads, -1.);
+    for (unsigned i = 0; i < numThreads; ++i)
+        m_workers.emplace_back(new Worker);
+    for (unsigned i = 0; i < numThreads; ++i)
+        m_threads.emplace_back([this, i]() { run(i); });
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_quit = true;
+    }
+    m_cond.notify_all();
+    for (auto &t: m_threads)
+        t.join();
+}
+
+TaskPool &TaskPool::the()
+{
+    static TaskPool pool(0, "vistle_pool");
+    return pool;
+}
+
+unsigned TaskPool::numThreads() const
+{
+    return unsigned(m_workers.size());
+}
+
+size_t TaskPool::queueDepth() const
+{
+    return m_queued;
+}
+
+void TaskPool::submit(Task task)
+{
+    unsigned idx = 0;
+    if (s_pool == this)
+        idx = s_workerIndex;
+    else
+        idx = m_next++ % m_workers.size();
+
+    auto &w = *m_workers[idx];
+    {
+        std::lock_guard<std::mutex> guard(w.mutex);
+        w.queue.emplace_back(std::move(task));
+    }
+
+    {
+        // increment while holding m_mutex, so that no worker can miss the update before going to sleep
+        std::lock_guard<std::mutex> guard(m_mutex);
+        size_t queued = ++m_queued;
+        m_maxQueued = std::max(m_maxQueued, queued);
+    }
+    m_cond.notify_one();
+}
+
+void TaskPool::setThreadLimit(int nthreads)
+{
+    t_threadLimit = nthreads > 0 ? nthreads : 0;
+}
+
+int TaskPool::threadLimit()
+{
+    return t_threadLimit;
+}
+
+unsigned TaskPool::concurrency() const
+{
+    if (t_threadLimit > 0)
+        return t_threadLimit;
+    // calling thread participates, so this leaves one worker available for other tasks
+    return numThreads();
+}
+
+TaskPool::ThreadLimit::ThreadLimit(int nthreads): m_previous(t_threadLimit)
+{
+    setThreadLimit(nthreads);
+}
+
+TaskPool::ThreadLimit::~ThreadLimit()
+{
+    t_threadLimit = m_previous;
+}
+
+void TaskPool::forChunks(size_t nchunks, const std::function<void(size_t)> &func)
+{
+    const unsigned nthreads = concurrency();
+    if (nchunks <= 1 || nthreads <= 1) {
+        for (size_t c = 0; c < nchunks; ++c)
+            func(c);
+        return;
+    }
+
+    // helpers starting only after all chunks have been processed return without accessing func
+    struct State {
+        const std::function<void(size_t)> *func = nullptr;
+        size_t nchunks = 0;
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable cond;
+        size_t done = 0;
+        std::exception_ptr exception;
+    };
+    auto state = std::make_shared<State>();
+    state->func = &func;
+    state->nchunks = nchunks;
+
+    auto work = [nthreads](State &s) {
+        // nested calls from helpers are subject to the limit of the caller
+        ThreadLimit limit(nthreads);
+        for (;;) {
+            const size_t c = s.next++;
+            if (c >= s.nchunks)
+                break;
+            std::exception_ptr exception;
+            try {
+                (*s.func)(c);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            std::lock_guard<std::mutex> guard(s.mutex);
+            if (exception && !s.exception)
+                s.exception = exception;
+            ++s.done;
+            if (s.done == s.nchunks)
+                s.cond.notify_all();
+        }
+    };
+
+    const size_t helpers = std::min(size_t(nthreads - 1), nchunks - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        submit([state, work]() { work(*state); });
+    }
+    work(*state);
+
+    std::unique_lock<std::mutex> guard(state->mutex);
+    state->cond.wait(guard, [&state]() { return state->done == state->nchunks; });
+    if (state->exception)
+        std::rethrow_exception(state->exception);
+}
+
+bool TaskPool::pop(unsigned idx, Task &task)
+{
+    auto &w = *m_workers[idx];
+    std::lock_guard<std::mutex> guard(w.mutex);
+    if (w.queue.empty())
+        return false;
+    task = std::move(w.queue.front());
+    w.queue.pop_front();
+    --m_queued;
+    return true;
+}
+
+bool TaskPool::steal(unsigned idx, Task &task)
+{
+    const unsigned n = numThreads();
+    for (unsigned i = 1; i < n; ++i) {
+        auto &w = *m_workers[(idx + i) % n];
+        std::lock_guard<std::mutex> guard(w.mutex);
+        if (w.queue.empty())
+            continue;
+        task = std::move(w.queue.front());
+        w.queue.pop_front();
+        --m_queued;
+        ++m_stolen;
+        return true;
+    }
+    return false;
+}
+
+void TaskPool::run(unsigned idx)
+{
+    s_pool = this;
+    s_workerIndex = idx;
+    setThreadName(m_name + ":" + std::to_string(idx));
+
+    for (;;) {
+        Task task;
+        if (pop(idx, task) || steal(idx, task)) {
+            try {
+                task();
+            } catch (std::exception &ex) {
+                std::cerr << m_name << ": task threw exception: " << ex.what() << std::endl;
+            } catch (...) {
+                std::cerr << m_name << ": task threw unknown exception" << std::endl;
+            }
+            ++m_executed;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(m_mutex);
+        if (m_quit)
+            break;
+        if (m_queued > 0)
+            continue;
+        m_idleSince[idx] = Clock::time();
+        m_cond.wait(guard, [this]() { return m_quit || m_queued > 0; });
+        m_idleTime += Clock::time() - std::max(m_idleSince[idx], m_statsStart);
+        m_idleSince[idx] = -1.;
+    }
+
+    s_pool = nullptr;
+}
+
+TaskPool::Stats TaskPool::stats() const
+{
+    Stats s;
+    s.executed = m_executed;
+    s.stolen = m_stolen;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    s.maxQueueDepth = m_maxQueued;
+    s.idleTime = m_idleTime;
+    double now = Clock::time();
+    for (auto since: m_idleSince) {
+        if (since >= 0.)
+            s.idleTime += now - std::max(since, m_statsStart);
+    }
+    return s;
+}
+
+void TaskPool::resetStats()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_executed = 0;
+    m_stolen = 0;
+    m_maxQueued = m_queued;
+    m_idleTime = 0.;
+    m_statsStart = Clock::time();
+}
+
+} // namespace vistle
@@ -0,0 +1,106 @@
+#ifndef VISTLE_UTIL_TASKPOOL_H
+#define VISTLE_UTIL_TASKPOOL_H
+
+#include "export.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vistle {
+
+//! persistent pool of worker threads executing tasks from per-thread queues
+/*! Each worker takes tasks from its own queue and steals from the queues of the other workers when it runs dry.
+ *  Tasks submitted from outside the pool are distributed round-robin, tasks submitted from within a task are queued
+ *  with the submitting worker. Tasks are taken in submission order from every queue, so that tasks submitted early
+ *  tend to finish early.
+ */
+class V_UTILEXPORT TaskPool {
+public:
+    typedef std::function<void()> Task;
+
+    struct Stats {
+        size_t executed = 0; //!< number of tasks run to completion
+        size_t stolen = 0; //!< number of tasks taken from the queue of another worker
+        size_t maxQueueDepth = 0; //!< maximum number of tasks waiting for execution
+        double idleTime = 0.; //!< accumulated time workers have been waiting for work, in s
+    };
+
+    //! create a pool with numThreads workers, or as many as there are hardware threads if 0
+    explicit TaskPool(unsigned numThreads = 0, const std::string &name = "pool");
+    ~TaskPool();
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    //! pool shared by all users within this process
+    static TaskPool &the();
+
+    //! queue task for execution, exceptions escaping from task are reported and discarded
+    void submit(Task task);
+
+    //! call func(c) for all chunks c in [0, nchunks), rethrows first exception thrown by func
+    /*! Chunks are processed by the calling thread and by up to concurrency()-1 helpers queued with this pool.
+     *  Helpers that do not get to run because all workers are busy leave their chunks to the calling thread,
+     *  so that no additional threads are started while the pool is busy with other tasks.
+     */
+    void forChunks(size_t nchunks, const std::function<void(size_t)> &func);
+
+    //! limit the number of threads for forChunks() called from the calling thread, <= 0: no limit
+    static void setThreadLimit(int nthreads);
+    static int threadLimit();
+    //! number of threads used by forChunks() called from the calling thread
+    unsigned concurrency() const;
+
+    //! limit the number of threads for forChunks() called from the calling thread while in scope
+    class V_UTILEXPORT ThreadLimit {
+    public:
+        explicit ThreadLimit(int nthreads);
+        ~ThreadLimit();
+        ThreadLimit(const ThreadLimit &) = delete;
+        ThreadLimit &operator=(const ThreadLimit &) = delete;
+
+    private:
+        int m_previous;
+    };
+
+    unsigned numThreads() const;
+    //! number of tasks waiting for execution
+    size_t queueDepth() const;
+
+    Stats stats() const;
+    void resetStats();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queue;
+    };
+
+    void run(unsigned idx);
+    bool pop(unsigned idx, Task &task);
+    bool steal(unsigned idx, Task &task);
+
+    std::string m_name;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_next{0};
+
+    mutable std::mutex m_mutex; // for waking up idle workers and collecting statistics
+    std::condition_variable m_cond;
+    bool m_quit = false;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<size_t> m_executed{0}, m_stolen{0};
+    size_t m_maxQueued = 0;
+    double m_statsStart = 0.;
+    double m_idleTime = 0.;
+    std::vector<double> m_idleSince; // < 0 if worker is busy
+};
+
+} // namespace vistle
+#endif
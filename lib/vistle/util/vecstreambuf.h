@@ -51,24 +51,29 @@ private:
 template<typename Vector, typename TraitsT = std::char_traits<typename Vector::value_type>>
 class vecistreambuf: public std::basic_streambuf<typename Vector::value_type, TraitsT> {
 public:
-    vecistreambuf(const Vector &ve): vec(ve)
+    typedef typename Vector::value_type value_type;
+
+    vecistreambuf(const Vector &ve): vecistreambuf(ve.data(), ve.size()) {}
+
+    //! read from memory not owned by a Vector, e.g. a mapped shared memory region, which has to outlive the streambuf
+    vecistreambuf(const value_type *data, size_t size): m_data(data), m_size(size)
     {
-        auto &v = const_cast<Vector &>(vec);
-        this->setg(v.data(), v.data(), v.data() + v.size());
+        auto d = const_cast<value_type *>(m_data);
+        this->setg(d, d, d + m_size);
     }
 
     std::size_t read(void *ptr, std::size_t size)
     {
-        if (cur + size > vec.size())
-            size = vec.size() - cur;
-        memcpy(ptr, vec.data() + cur, size);
+        if (cur + size > m_size)
+            size = m_size - cur;
+        memcpy(ptr, m_data + cur, size);
         cur += size;
         return size;
     }
 
     bool empty() const { return cur == 0; }
-    typename Vector::value_type peekch() const { return vec[cur]; }
-    typename Vector::value_type getch() { return vec[cur++]; }
+    value_type peekch() const { return m_data[cur]; }
+    value_type getch() { return m_data[cur++]; }
     void ungetch(char)
     {
         if (cur > 0)
@@ -76,7 +81,8 @@ public:
     }
 
 private:
-    const Vector &vec;
+    const value_type *m_data = nullptr;
+    size_t m_size = 0;
     size_t cur = 0;
 };
 
@@ -32,6 +32,9 @@ CellToVert::CellToVert(const std::string &name, int moduleID, mpi::communicator
             setPortOptional(m_data_in[i], true);
         }
     }
+
+    setFusable(true);
+    setReuseBlockResults(true);
 }
 
 bool CellToVert::compute(const std::shared_ptr<BlockTask> &task) const
@@ -16,6 +16,7 @@
 #include <vistle/core/structuredgridbase.h>
 #include <vistle/core/triangles.h>
 #include <vistle/core/quads.h>
+#include <vistle/alg/parallel.h>
 
 
 namespace vistle {
@@ -51,9 +52,7 @@ bool coCellToVert::interpolate(bool unstructured, Index num_elem, Index num_conn
         for (Index c = 0; c < numComp; ++c) {
             const S *in = in_data[c];
             S *out = out_data[c];
-            for (Index i = 0; i < num_point; i++) {
-                out[i] = in[i];
-            }
+            parallel_for(num_point, [in, out](Index i) { out[i] = in[i]; });
         }
         return true;
     }
@@ -141,7 +140,7 @@ bool coCellToVert::simpleAlgo(Index num_elem, Index num_conn, Index num_point, c
     }
 
     // divide value sum by 'weight' (# adjacent cells)
-    for (Index vertex = 0; vertex < num_point; vertex++) {
+    parallel_for(num_point, [weight_num, numComp, &tmp_out, out_data](Index vertex) {
         if (weight_num[vertex] >= 1) {
             for (Index c = 0; c < numComp; ++c) {
                 tmp_out[c][vertex] /= weight_num[vertex];
@@ -150,7 +149,7 @@ bool coCellToVert::simpleAlgo(Index num_elem, Index num_conn, Index num_point, c
         for (Index c = 0; c < numComp; ++c) {
             out_data[c][vertex] = tmp_out[c][vertex];
         }
-    }
+    });
 
     return true;
 }
@@ -233,13 +232,13 @@ bool coCellToVert::simpleAlgo<Scalar>(Index num_elem, Index num_conn, Index num_
     }
 
     // divide value sum by 'weight' (# adjacent cells)
-    for (Index vertex = 0; vertex < num_point; vertex++) {
+    parallel_for(num_point, [weight_num, numComp, out_data](Index vertex) {
         if (weight_num[vertex] >= 1) {
             for (Index c = 0; c < numComp; ++c) {
                 out_data[c][vertex] /= (double)weight_num[vertex];
             }
         }
-    }
+    });
 
     return true;
 }
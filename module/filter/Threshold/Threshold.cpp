@@ -11,6 +11,7 @@
 #include <vistle/util/enum.h>
 #include <vistle/alg/objalg.h>
 #include <vistle/alg/fields.h>
+#include <vistle/alg/parallel.h>
 #include <vistle/core/geometry.h>
 #include <vistle/core/structuredgridbase.h>
 
@@ -30,7 +31,7 @@ public:
         }
     }
 
-    bool operator()(Index element) { return m_restraint(m_marker ? m_marker[element] : element); }
+    bool operator()(Index element) const { return m_restraint(m_marker ? m_marker[element] : element); }
 
 private:
     coRestraint m_restraint;
@@ -61,7 +62,7 @@ public:
         }
     }
 
-    bool operator()(Index element)
+    bool operator()(Index element) const
     {
         if (m_mapping != DataBase::Vertex && m_mapping != DataBase::Element)
             return false;
@@ -146,6 +147,22 @@ private:
     const Byte *m_byte = nullptr;
     const Scalar *m_scalar = nullptr;
 };
+
+// only use bounds that are already known, scanning all values would cost as much as computing the result
+template<typename T>
+bool getBounds(DataBase::const_ptr data, Float &min, Float &max)
+{
+    auto vec = Vec<T>::as(data);
+    if (!vec)
+        return false;
+    const auto &x = vec->d()->x[0];
+    if (!x || !x->bounds_valid())
+        return false;
+    auto mm = vec->getMinMax();
+    min = mm.first[0];
+    max = mm.second[0];
+    return true;
+}
 #endif
 } // namespace
 
@@ -179,6 +196,8 @@ Threshold::Threshold(const std::string &name, int moduleID, mpi::communicator co
 #endif
 
     addResultCache(m_gridCache);
+    setFusable(true);
+    setReuseBlockResults(true);
 }
 
 bool Threshold::changeParameter(const vistle::Parameter *p)
@@ -202,6 +221,36 @@ bool Threshold::prepare()
     return true;
 }
 
+std::string Threshold::parameterFingerprint(const std::shared_ptr<BlockTask> &task) const
+{
+#ifndef CELLSELECT
+    // result does not depend on the exact threshold, as long as it stays above or below all values of a block
+    auto obj = task->peekObject(p_in[0]);
+    DataBase::const_ptr data;
+    if (obj)
+        data = splitContainerObject(obj).mapped;
+    Float min = 0, max = 0;
+    if (data && (getBounds<Scalar>(data, min, max) || getBounds<Index>(data, min, max) ||
+                 getBounds<Byte>(data, min, max))) {
+        Float threshold = p_threshold->getValue();
+        std::string range;
+        if (max < threshold)
+            range = "below";
+        else if (min > threshold)
+            range = "above";
+        if (!range.empty()) {
+            std::stringstream str;
+            const Parameter *params[] = {p_reuse, p_invert, p_operation};
+            for (const auto *p: params)
+                str << p->getName() << "=" << std::string(*p) << "\n";
+            str << "values " << range << " threshold\n";
+            return str.str();
+        }
+    }
+#endif
+    return Module::parameterFingerprint(task);
+}
+
 bool Threshold::compute(const std::shared_ptr<BlockTask> &task) const
 {
     auto obj = task->expect<Object>(p_in[0]);
@@ -257,15 +306,11 @@ bool Threshold::compute(const std::shared_ptr<BlockTask> &task) const
         Quads::ptr outquads;
         VerticesMapping &vm = cachedResult.vm;
         ElementsMapping &em = cachedResult.em;
-        const Index *icl = nullptr;
-        const Index *iel = nullptr;
         const Byte *itl = nullptr;
         if (indexed) {
             outgrid = indexed->cloneType();
             outgeo = outgrid;
 
-            icl = indexed->cl().data();
-            iel = indexed->el().data();
             if (ugrid) {
                 itl = ugrid->tl().data();
             }
@@ -282,39 +327,34 @@ bool Threshold::compute(const std::shared_ptr<BlockTask> &task) const
         }
 
         Index nelem = grid_in->getNumElements();
-        Index ncorn = 0;
-        for (Index e = 0; e < nelem; ++e) {
-            if (m_invert ^ select(e)) {
-                em.push_back(e);
-                if (iel) {
-                    const Index begin = iel[e], end = iel[e + 1];
-                    ncorn += end - begin;
-                } else if (outquads) {
-                    ncorn += 4;
-                } else {
-                    ncorn += grid_in->cellNumVertices(e);
-                }
-            }
-        }
+        const bool invert = m_invert;
+        parallel_compact(nelem, [&select, invert](Index e) { return invert ^ select(e); }, em);
+        const Index nsel = em.size();
 
-        if (outgrid) {
-            outgrid->el().resize(em.size() + 1);
-            outgrid->cl().resize(ncorn);
+        // iel and icl are the element and connectivity lists of indexed input as they are stored, or nullptr
+        auto selectCells = [&](const auto *iel, const auto *icl) {
+            outgrid->el().resize(nsel + 1);
             auto *el = outgrid->el().data();
+            Index ncorn = parallel_exclusive_scan(
+                nsel,
+                [&em, iel, grid_in](Index k) -> Index {
+                    const Index e = em[k];
+                    return iel ? iel[e + 1] - iel[e] : grid_in->cellNumVertices(e);
+                },
+                el, true);
+            outgrid->cl().resize(ncorn);
             auto *cl = outgrid->cl().data();
             Byte *tl = nullptr;
             auto outugrid = UnstructuredGrid::as(outgrid);
-            if (outugrid && !em.empty()) {
+            if (outugrid && nsel > 0) {
                 auto otl = &outugrid->tl();
-                otl->resize(em.size());
-                tl = &otl->at(0);
+                otl->resize(nsel);
+                tl = otl->data();
             }
 
-            Index cidx = 0;
-            for (const auto &e: em) {
-                *el = cidx;
-                ++el;
-
+            parallel_for(nsel, [&em, iel, icl, itl, el, cl, tl, grid_in](Index k) {
+                const Index e = em[k];
+                Index cidx = el[k];
                 if (iel) {
                     const Index begin = iel[e], end = iel[e + 1];
                     for (Index i = begin; i < end; ++i) {
@@ -323,10 +363,9 @@ bool Threshold::compute(const std::shared_ptr<BlockTask> &task) const
                     }
                     if (tl) {
                         if (itl)
-                            *tl = itl[e];
+                            tl[k] = itl[e];
                         else
-                            *tl = UnstructuredGrid::HEXAHEDRON;
-                        ++tl;
+                            tl[k] = UnstructuredGrid::HEXAHEDRON;
                     }
                 } else {
                     const auto vert = grid_in->cellVertices(e);
@@ -335,26 +374,27 @@ bool Threshold::compute(const std::shared_ptr<BlockTask> &task) const
                         ++cidx;
                     }
                     if (tl) {
-                        *tl = UnstructuredGrid::HEXAHEDRON;
-                        ++tl;
+                        tl[k] = UnstructuredGrid::HEXAHEDRON;
                     }
                 }
+            });
+        };
 
-                *el = cidx;
-            }
-
+        if (outgrid) {
+            if (indexed)
+                indexed->withIndices(selectCells);
+            else
+                selectCells(static_cast<const Index *>(nullptr), static_cast<const Index *>(nullptr));
         } else if (outquads) {
-            outquads->cl().resize(em.size() * 4);
+            outquads->cl().resize(nsel * 4);
             auto *cl = outquads->cl().data();
 
-            Index cidx = 0;
-            for (const auto &e: em) {
-                const auto vert = grid_in->cellVertices(e);
+            parallel_for(nsel, [&em, cl, grid_in](Index k) {
+                const auto vert = grid_in->cellVertices(em[k]);
                 for (int i = 0; i < 4; ++i) {
-                    cl[cidx] = vert[i];
-                    ++cidx;
+                    cl[4 * k + i] = vert[i];
                 }
-            }
+            });
         }
         if (outquads) {
             renumberVertices<Quads>(sgrid, outquads, vm);
@@ -435,12 +475,12 @@ void Threshold::renumberVertices(Coords::const_ptr coords, Indexed::ptr poly, Ve
             }
         }
 
-        auto &px = poly->x();
-        auto &py = poly->y();
-        auto &pz = poly->z();
-        px.resize(c);
-        py.resize(c);
-        pz.resize(c);
+        poly->x().resize(c);
+        poly->y().resize(c);
+        poly->z().resize(c);
+        auto px = poly->x().pin();
+        auto py = poly->y().pin();
+        auto pz = poly->z().pin();
 
         const Scalar *xcoord = coords->x().data();
         const Scalar *ycoord = coords->y().data();
@@ -470,12 +510,12 @@ void Threshold::renumberVertices(StructuredGridBase::const_ptr sgrid, typename G
         }
     }
 
-    auto &px = geo->x();
-    auto &py = geo->y();
-    auto &pz = geo->z();
-    px.resize(c);
-    py.resize(c);
-    pz.resize(c);
+    geo->x().resize(c);
+    geo->y().resize(c);
+    geo->z().resize(c);
+    auto px = geo->x().pin();
+    auto py = geo->y().pin();
+    auto pz = geo->z().pin();
 
     for (const auto &v: vm) {
         Index f = v.first;
@@ -41,6 +41,7 @@ private:
     IntParameter *p_stop = nullptr;
 
     IntParameter *m_compressionMode = nullptr;
+    IntParameter *m_integerCompressionMode = nullptr;
     FloatParameter *m_zfpRate = nullptr;
     IntParameter *m_zfpPrecision = nullptr;
     FloatParameter *m_zfpAccuracy = nullptr;
@@ -86,6 +87,10 @@ Cache::Cache(const std::string &name, int moduleID, mpi::communicator comm): Mod
     m_compressionMode =
         addIntParameter("field_compression", "compression mode for data fields", Predict, Parameter::Choice);
     V_ENUM_SET_CHOICES(m_compressionMode, FieldCompressionMode);
+    m_integerCompressionMode =
+        addIntParameter("integer_compression", "compression mode for integer arrays (e.g. connectivity)", DeltaPack,
+                        Parameter::Choice);
+    V_ENUM_SET_CHOICES(m_integerCompressionMode, FieldCompressionMode);
     m_zfpRate = addFloatParameter("zfp_rate", "ZFP fixed compression rate", 8.);
     setParameterRange(m_zfpRate, Float(1), Float(64));
     m_zfpPrecision = addIntParameter("zfp_precision", "ZFP fixed precision", 16);
@@ -187,6 +192,7 @@ bool Cache::compute()
 bool Cache::prepare()
 {
     m_compressionSettings.mode = (FieldCompressionMode)m_compressionMode->getValue();
+    m_compressionSettings.integerMode = (FieldCompressionMode)m_integerCompressionMode->getValue();
     m_compressionSettings.zfpRate = m_zfpRate->getValue();
     m_compressionSettings.zfpAccuracy = m_zfpAccuracy->getValue();
     m_compressionSettings.zfpPrecision = m_zfpPrecision->getValue();
@@ -295,8 +301,8 @@ bool Cache::prepare()
         }
     };
 
-    auto restoreObject = [this, &renumberObject, &compression, &size, &objects, &fetcher](const std::string &name0,
-                                                                                          int port) {
+    auto restoreObject = [this, &renumberObject, &compression, &size, &objects, &fetcher,
+                          reorder](const std::string &name0, int port) {
         //std::cerr << "output to port " << port << ", " << num << " objects/arrays read" << std::endl;
         //std::cerr << "output to port " << port << ", initial " << name0 << " of size " << objects[name0].size() << std::endl;
 
@@ -316,6 +322,9 @@ bool Cache::prepare()
         vecistreambuf<buffer> membuf(buf);
         vistle::iarchive memar(membuf);
         try {
+            // when reordering, all arrays of the file are available at once and would be kept in memory
+            if (!reorder)
+                fetcher->prefetchArrays();
             memar.setFetcher(fetcher);
             //std::cerr << "output to port " << port << ", trying to load " << name0 << std::endl;
             Object::ptr obj(Object::loadObject(memar));
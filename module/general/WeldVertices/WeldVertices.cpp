@@ -128,8 +128,8 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
     std::map<Point, Index> indexMap;
     if (auto tri = Triangles::as(grid)) {
         Index num = tri->getNumCorners();
-        const Index *cl = num > 0 ? tri->cl().data() : nullptr;
-        if (!cl)
+        const bool haveCl = num > 0;
+        if (!haveCl)
             num = tri->getNumCoords();
         remap.reserve(num);
         const Scalar *x = tri->x(), *y = tri->y(), *z = tri->z();
@@ -137,20 +137,22 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
         Triangles::ptr ntri(new Triangles(num, 0));
         Index *ncl = ntri->cl().data();
 
-        if (cl) {
-            Index count = 0;
-            Index num = tri->getNumCorners();
-            for (Index i = 0; i < num; ++i) {
-                Index v = cl[i];
-                Point p(x[v], y[v], z[v], v, floats);
-                auto &idx = indexMap[p];
-                if (idx == 0) {
-                    remap.push_back(v);
-                    idx = ++count;
+        if (haveCl) {
+            tri->withIndices([&](const auto *cl) {
+                Index count = 0;
+                Index num = tri->getNumCorners();
+                for (Index i = 0; i < num; ++i) {
+                    Index v = cl[i];
+                    Point p(x[v], y[v], z[v], v, floats);
+                    auto &idx = indexMap[p];
+                    if (idx == 0) {
+                        remap.push_back(v);
+                        idx = ++count;
+                    }
+                    ncl[i] = idx - 1;
                 }
-                ncl[i] = idx - 1;
-            }
-            //sendInfo("found %d unique vertices among %d", count-1, num);
+                //sendInfo("found %d unique vertices among %d", count-1, num);
+            });
         } else {
             Index count = 0;
             Index num = tri->getNumCoords();
@@ -169,8 +171,8 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
         ogrid = ntri;
     } else if (auto quad = Quads::as(grid)) {
         Index num = quad->getNumCorners();
-        const Index *cl = num > 0 ? quad->cl().data() : nullptr;
-        if (!cl)
+        const bool haveCl = num > 0;
+        if (!haveCl)
             num = quad->getNumCoords();
         remap.reserve(num);
         const Scalar *x = quad->x(), *y = quad->y(), *z = quad->z();
@@ -178,20 +180,22 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
         Quads::ptr nquad(new Quads(num, 0));
         Index *ncl = nquad->cl().data();
 
-        if (cl) {
-            Index count = 0;
-            Index num = quad->getNumCorners();
-            for (Index i = 0; i < num; ++i) {
-                Index v = cl[i];
-                Point p(x[v], y[v], z[v], v, floats);
-                auto &idx = indexMap[p];
-                if (idx == 0) {
-                    remap.push_back(v);
-                    idx = ++count;
+        if (haveCl) {
+            quad->withIndices([&](const auto *cl) {
+                Index count = 0;
+                Index num = quad->getNumCorners();
+                for (Index i = 0; i < num; ++i) {
+                    Index v = cl[i];
+                    Point p(x[v], y[v], z[v], v, floats);
+                    auto &idx = indexMap[p];
+                    if (idx == 0) {
+                        remap.push_back(v);
+                        idx = ++count;
+                    }
+                    ncl[i] = idx - 1;
                 }
-                ncl[i] = idx - 1;
-            }
-            //sendInfo("found %d unique vertices among %d", count-1, num);
+                //sendInfo("found %d unique vertices among %d", count-1, num);
+            });
         } else {
             Index count = 0;
             Index num = quad->getNumCoords();
@@ -210,8 +214,8 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
         ogrid = nquad;
     } else if (auto idx = Indexed::as(grid)) {
         Index num = idx->getNumCorners();
-        const Index *cl = num > 0 ? idx->cl().data() : nullptr;
-        if (!cl)
+        const bool haveCl = num > 0;
+        if (!haveCl)
             num = idx->getNumCoords();
         const Scalar *x = idx->x(), *y = idx->y(), *z = idx->z();
         remap.reserve(num);
@@ -223,20 +227,22 @@ bool WeldVertices::compute(const std::shared_ptr<BlockTask> &task) const
 
         Index *ncl = nidx->cl().data();
 
-        if (cl) {
-            Index count = 0;
-            Index num = idx->getNumCorners();
-            for (Index i = 0; i < num; ++i) {
-                Index v = cl[i];
-                Point p(x[v], y[v], z[v], v, floats);
-                auto &idx = indexMap[p];
-                if (idx == 0) {
-                    remap.push_back(v);
-                    idx = ++count;
+        if (haveCl) {
+            idx->withIndices([&](const auto *el, const auto *cl) {
+                Index count = 0;
+                Index num = idx->getNumCorners();
+                for (Index i = 0; i < num; ++i) {
+                    Index v = cl[i];
+                    Point p(x[v], y[v], z[v], v, floats);
+                    auto &idx = indexMap[p];
+                    if (idx == 0) {
+                        remap.push_back(v);
+                        idx = ++count;
+                    }
+                    ncl[i] = idx - 1;
                 }
-                ncl[i] = idx - 1;
-            }
-            //sendInfo("found %d unique vertices among %d", count-1, num);
+                //sendInfo("found %d unique vertices among %d", count-1, num);
+            });
         } else {
             Index count = 0;
             Index num = idx->getNumCoords();
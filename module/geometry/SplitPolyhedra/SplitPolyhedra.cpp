@@ -32,6 +32,10 @@ SplitPolyhedra::SplitPolyhedra(const std::string &name, int moduleID, mpi::commu
     }
     m_mode = addIntParameter("mode", "how to handle polyhedral and simple cells", SplitToTetrahedra, Parameter::Choice);
     V_ENUM_SET_CHOICES(m_mode, Mode);
+
+    // cached inputs are fed again when only parameters change, keys capture input identity and mode
+    m_grids.setPersistent(true);
+    addResultCache(m_grids);
 }
 
 template<typename T>
@@ -111,7 +115,8 @@ bool SplitPolyhedra::compute()
     Result result;
     auto &simple = result.simple;
     auto &elementMapping = result.elementMapping;
-    if (auto entry = m_grids.getOrLock(grid->getName(), result)) {
+    std::string key = ResultCacheBase::identity(grid) + ":" + toString(Mode(mode)) + (perElement ? ":element" : "");
+    if (auto entry = m_grids.getOrLock(key, result)) {
         const Index *iel = grid->el().data();
         const Index *icl = grid->cl().data();
         const Byte *itl = grid->tl().data();
@@ -468,7 +473,13 @@ bool SplitPolyhedra::compute()
             updateMeta(simple);
         }
 
-        m_grids.storeAndUnlock(entry, result);
+        m_grids.storeAndUnlock(entry, result,
+                               ResultCacheBase::objectSize(simple) + elementMapping.size() * sizeof(Index));
+    } else if (simple) {
+        // result might stem from a previous execution
+        simple = simple->clone();
+        simple->copyAttributes(grid);
+        updateMeta(simple);
     }
 
 
@@ -14,6 +14,7 @@
 #include <vistle/core/points.h>
 #include <vistle/core/lines.h>
 #include <vistle/alg/objalg.h>
+#include <vistle/alg/parallel.h>
 
 #include "ToTriangles.h"
 
@@ -35,6 +36,8 @@ ToTriangles::ToTriangles(const std::string &name, int moduleID, mpi::communicato
     setParameterRange(p_tessellationQuality, Integer(0), Integer(10));
 
     addResultCache(m_resultCache);
+    setFusable(true);
+    setReuseBlockResults(true);
 }
 
 template<int Dim>
@@ -188,7 +191,7 @@ struct SphereGenerator {
     {}
 
     void addSphere(Scalar cx, Scalar cy, Scalar cz, Scalar r, Index idx, Index *ti, Scalar *tx, Scalar *ty, Scalar *tz,
-                   Scalar *nx, Scalar *ny, Scalar *nz)
+                   Scalar *nx, Scalar *ny, Scalar *nz) const
     {
         const float psi = M_PI / (NumLat - 1);
         const float phi = M_PI * 2 / NumLong;
@@ -270,9 +273,9 @@ struct SphereGenerator {
 };
 } // namespace
 
-bool ToTriangles::compute()
+bool ToTriangles::compute(const std::shared_ptr<BlockTask> &task) const
 {
-    auto container = expect<Object>("grid_in");
+    auto container = task->expect<Object>("grid_in");
     auto split = splitContainerObject(container);
     auto data = split.mapped;
     auto obj = split.geometry;
@@ -325,7 +328,7 @@ bool ToTriangles::compute()
             Index ntri = nvert - 2 * nelem;
 
             if (perElement) {
-                mult.reserve(ntri);
+                mult.resize(nelem);
                 useMultiplicity = true;
             }
 
@@ -333,22 +336,23 @@ bool ToTriangles::compute()
             for (int i = 0; i < 3; ++i)
                 tri->d()->x[i] = poly->d()->x[i];
 
-            Index i = 0;
-            auto el = poly->el().data();
-            auto cl = poly->cl().data();
             auto tcl = tri->cl().data();
-            for (Index e = 0; e < nelem; ++e) {
-                const Index begin = el[e], end = el[e + 1];
-                const Index N = end - begin;
-                for (Index v = 0; v < N - 2; ++v) {
-                    tcl[i++] = cl[begin];
-                    tcl[i++] = cl[begin + v + 1];
-                    tcl[i++] = cl[begin + v + 2];
-                }
-                if (perElement)
-                    mult.push_back(N - 2);
-            }
-            assert(i == 3 * ntri);
+            auto m = perElement ? mult.data() : nullptr;
+            poly->withIndices([nelem, tcl, m](const auto *el, const auto *cl) {
+                // a polygon with N corners is split into N-2 triangles, so triangles of element e start at el[e]-2*e
+                parallel_for(nelem, [el, cl, tcl, m](Index e) {
+                    const Index begin = el[e], end = el[e + 1];
+                    const Index N = end - begin;
+                    Index i = 3 * (begin - 2 * e);
+                    for (Index v = 0; v < N - 2; ++v) {
+                        tcl[i++] = cl[begin];
+                        tcl[i++] = cl[begin + v + 1];
+                        tcl[i++] = cl[begin + v + 2];
+                    }
+                    if (m)
+                        m[e] = N - 2;
+                });
+            });
         } else if (auto quads = Quads::as(obj)) {
             Index nelem = quads->getNumElements();
             Index nvert = quads->getNumCorners();
@@ -360,18 +364,18 @@ bool ToTriangles::compute()
                 tri->d()->x[i] = quads->d()->x[i];
 
             const Index N = 4;
-            Index i = 0;
-            auto cl = quads->cl().data();
             auto tcl = tri->cl().data();
-            for (Index e = 0; e < nelem; ++e) {
-                const Index begin = e * N;
-                for (Index v = 0; v < N - 2; ++v) {
-                    tcl[i++] = cl[begin];
-                    tcl[i++] = cl[begin + v + 1];
-                    tcl[i++] = cl[begin + v + 2];
-                }
-            }
-            assert(i == 3 * ntri);
+            quads->withIndices([nelem, tcl](const auto *cl) {
+                parallel_for(nelem, [cl, tcl](Index e) {
+                    const Index begin = e * N;
+                    Index i = 3 * (N - 2) * e;
+                    for (Index v = 0; v < N - 2; ++v) {
+                        tcl[i++] = cl[begin];
+                        tcl[i++] = cl[begin + v + 1];
+                        tcl[i++] = cl[begin + v + 2];
+                    }
+                });
+            });
 
             if (data && data->guessMapping() == DataBase::Element) {
                 ndata = replicateData(data, 2);
@@ -394,16 +398,20 @@ bool ToTriangles::compute()
             auto ny = norm->y().data();
             auto nz = norm->z().data();
 
-            for (Index i = 0; i < n; ++i) {
-                gen.addSphere(x[i], y[i], z[i], r[i], i * gen.CoordPerSphere, &ti[i * 3 * gen.TriPerSphere],
-                              &tx[i * gen.CoordPerSphere], &ty[i * gen.CoordPerSphere], &tz[i * gen.CoordPerSphere],
-                              &nx[i * gen.CoordPerSphere], &ny[i * gen.CoordPerSphere], &nz[i * gen.CoordPerSphere]);
-
-                for (Index j = 0; j < 3 * gen.TriPerSphere; ++j) {
-                    assert(ti[i * 3 * gen.TriPerSphere + j] >= i * gen.CoordPerSphere);
-                    assert(ti[i * 3 * gen.TriPerSphere + j] < (i + 1) * gen.CoordPerSphere);
-                }
-            }
+            parallel_for(
+                n,
+                [&gen, x, y, z, r, tx, ty, tz, ti, nx, ny, nz](Index i) {
+                    gen.addSphere(x[i], y[i], z[i], r[i], i * gen.CoordPerSphere, &ti[i * 3 * gen.TriPerSphere],
+                                  &tx[i * gen.CoordPerSphere], &ty[i * gen.CoordPerSphere],
+                                  &tz[i * gen.CoordPerSphere], &nx[i * gen.CoordPerSphere],
+                                  &ny[i * gen.CoordPerSphere], &nz[i * gen.CoordPerSphere]);
+
+                    for (Index j = 0; j < 3 * gen.TriPerSphere; ++j) {
+                        assert(ti[i * 3 * gen.TriPerSphere + j] >= i * gen.CoordPerSphere);
+                        assert(ti[i * 3 * gen.TriPerSphere + j] < (i + 1) * gen.CoordPerSphere);
+                    }
+                },
+                256);
             norm->setMeta(obj->meta());
             updateMeta(norm);
             tri->setNormals(norm);
@@ -740,53 +748,53 @@ bool ToTriangles::compute()
             }
         } else if (auto unstr = UnstructuredGrid::as(obj)) {
             Index nelem = unstr->getNumElements();
-            auto el = unstr->el().data();
-            auto cl = unstr->cl().data();
             auto tl = unstr->tl().data();
 
             if (perElement) {
                 mult.reserve(nelem);
                 useMultiplicity = true;
             }
-            Index ntri = 0;
-            for (Index e = 0; e < nelem; ++e) {
-                const Index begin = el[e], end = el[e + 1];
-                const Index N = end - begin;
-                if (tl[e] != UnstructuredGrid::TRIANGLE && tl[e] != UnstructuredGrid::QUAD &&
-                    tl[e] != UnstructuredGrid::POLYGON) {
-                    if (perElement)
-                        mult.push_back(0);
-                } else {
-                    ntri += N - 2;
-                    if (perElement)
-                        mult.push_back(N - 2);
+            unstr->withIndices([&](const auto *el, const auto *cl) {
+                Index ntri = 0;
+                for (Index e = 0; e < nelem; ++e) {
+                    const Index begin = el[e], end = el[e + 1];
+                    const Index N = end - begin;
+                    if (tl[e] != UnstructuredGrid::TRIANGLE && tl[e] != UnstructuredGrid::QUAD &&
+                        tl[e] != UnstructuredGrid::POLYGON) {
+                        if (perElement)
+                            mult.push_back(0);
+                    } else {
+                        ntri += N - 2;
+                        if (perElement)
+                            mult.push_back(N - 2);
+                    }
                 }
-            }
-
-            tri.reset(new Triangles(3 * ntri, 0));
-            for (int i = 0; i < 3; ++i)
-                tri->d()->x[i] = unstr->d()->x[i];
 
-            Index i = 0;
-            auto tcl = tri->cl().data();
-            for (Index e = 0; e < nelem; ++e) {
-                const Index begin = el[e], end = el[e + 1];
-                const Index N = end - begin;
-                if (tl[e] == UnstructuredGrid::TRIANGLE) {
-                    assert(end - begin == 3);
-                } else if (tl[e] == UnstructuredGrid::QUAD) {
-                    assert(end - begin == 4);
-                } else if (tl[e] == UnstructuredGrid::POLYGON) {
-                } else {
-                    continue;
-                }
-                for (Index v = 0; v < N - 2; ++v) {
-                    tcl[i++] = cl[begin];
-                    tcl[i++] = cl[begin + v + 1];
-                    tcl[i++] = cl[begin + v + 2];
+                tri.reset(new Triangles(3 * ntri, 0));
+                for (int i = 0; i < 3; ++i)
+                    tri->d()->x[i] = unstr->d()->x[i];
+
+                Index i = 0;
+                auto tcl = tri->cl().data();
+                for (Index e = 0; e < nelem; ++e) {
+                    const Index begin = el[e], end = el[e + 1];
+                    const Index N = end - begin;
+                    if (tl[e] == UnstructuredGrid::TRIANGLE) {
+                        assert(end - begin == 3);
+                    } else if (tl[e] == UnstructuredGrid::QUAD) {
+                        assert(end - begin == 4);
+                    } else if (tl[e] == UnstructuredGrid::POLYGON) {
+                    } else {
+                        continue;
+                    }
+                    for (Index v = 0; v < N - 2; ++v) {
+                        tcl[i++] = cl[begin];
+                        tcl[i++] = cl[begin + v + 1];
+                        tcl[i++] = cl[begin + v + 2];
+                    }
                 }
-            }
-            assert(i == 3 * ntri);
+                assert(i == 3 * ntri);
+            });
         }
 
         if (tri) {
@@ -828,7 +836,7 @@ bool ToTriangles::compute()
         m_resultCache.storeAndUnlock(entry, result);
     }
 
-    addObject("grid_out", result);
+    task->addObject("grid_out", result);
 
     return true;
 }
@@ -9,12 +9,12 @@ public:
     ToTriangles(const std::string &name, int moduleID, mpi::communicator comm);
 
 private:
-    bool compute() override;
+    bool compute(const std::shared_ptr<vistle::BlockTask> &task) const override;
 
     vistle::IntParameter *p_transformSpheres = nullptr;
     vistle::IntParameter *p_transformTubes = nullptr;
     vistle::IntParameter *p_tessellationQuality = nullptr;
-    vistle::ResultCache<vistle::Object::ptr> m_resultCache;
+    mutable vistle::ResultCache<vistle::Object::ptr> m_resultCache;
 };
 
 #endif
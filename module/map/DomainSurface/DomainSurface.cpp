@@ -66,12 +66,12 @@ void createVertices(StructuredGridBase::const_ptr grid, typename Connected::ptr
     }
     mapped.clear();
 
-    auto &px = conn->x();
-    auto &py = conn->y();
-    auto &pz = conn->z();
-    px.resize(vm.size());
-    py.resize(vm.size());
-    pz.resize(vm.size());
+    conn->x().resize(vm.size());
+    conn->y().resize(vm.size());
+    conn->z().resize(vm.size());
+    auto px = conn->x().pin();
+    auto py = conn->y().pin();
+    auto pz = conn->z().pin();
 
     for (Index i = 0; i < vm.size(); ++i) {
         Vector3 p = grid->getVertex(vm[i]);
@@ -404,12 +404,12 @@ void DomainSurface::renumberVertices(Coords::const_ptr coords, Indexed::ptr poly
         const Scalar *xcoord = coords->x().data();
         const Scalar *ycoord = coords->y().data();
         const Scalar *zcoord = coords->z().data();
-        auto &px = poly->x();
-        auto &py = poly->y();
-        auto &pz = poly->z();
-        px.resize(vm.size());
-        py.resize(vm.size());
-        pz.resize(vm.size());
+        poly->x().resize(vm.size());
+        poly->y().resize(vm.size());
+        poly->z().resize(vm.size());
+        auto px = poly->x().pin();
+        auto py = poly->y().pin();
+        auto pz = poly->z().pin();
 
         for (Index i = 0; i < vm.size(); ++i) {
             px[i] = xcoord[vm[i]];
@@ -445,12 +445,12 @@ void DomainSurface::renumberVertices(Coords::const_ptr coords, Quads::ptr quad,
         const Scalar *xcoord = coords->x().data();
         const Scalar *ycoord = coords->y().data();
         const Scalar *zcoord = coords->z().data();
-        auto &px = quad->x();
-        auto &py = quad->y();
-        auto &pz = quad->z();
-        px.resize(vm.size());
-        py.resize(vm.size());
-        pz.resize(vm.size());
+        quad->x().resize(vm.size());
+        quad->y().resize(vm.size());
+        quad->z().resize(vm.size());
+        auto px = quad->x().pin();
+        auto py = quad->y().pin();
+        auto pz = quad->z().pin();
 
         for (Index i = 0; i < vm.size(); ++i) {
             px[i] = xcoord[vm[i]];
@@ -33,6 +33,8 @@ IndexManifolds::IndexManifolds(const std::string &name, int moduleID, mpi::commu
     p_direction = addIntParameter("direction", "normal on surface and direction of line", Z, Parameter::Choice);
     V_ENUM_SET_CHOICES(p_direction, Direction);
 
+    // cached inputs are fed again when only parameters change, keys capture input identity and surface position
+    m_surfaceCache.setPersistent(true);
     addResultCache(m_surfaceCache);
 }
 
@@ -104,10 +106,16 @@ bool IndexManifolds::compute(const std::shared_ptr<BlockTask> &task) const
         Index nquad = (nvert1 - 1) * (nvert2 - 1);
 
         Quads::ptr surface;
-        auto cacheEntry = m_surfaceCache.getOrLock(ingrid->getName(), surface);
+        std::stringstream key;
+        key << ResultCacheBase::identity(ingrid) << ":" << toString(dir) << "=" << coord[dir];
+        auto cacheEntry = m_surfaceCache.getOrLock(key.str(), surface);
         if (!cacheEntry) {
-            if (!data)
+            if (!data) {
+                // surface might stem from a previous execution
                 surface = surface->clone();
+                surface->copyAttributes(ingrid);
+                updateMeta(surface);
+            }
         } else {
             surface.reset(new Quads(nquad * 4, nvert));
             surface->copyAttributes(ingrid);
@@ -1171,12 +1171,15 @@ bool Leveller::process()
             m_lines->d()->x[1] = HD.m_outVertData[idx++];
             m_lines->d()->x[2] = HD.m_outVertData[idx++];
             std::cerr << "lines with " << totalNumVertices << " vertices" << std::endl;
-            auto &cl = m_lines->cl();
-            auto &el = m_lines->el();
+            Index ncl = m_lines->cl().size(), nel = m_lines->el().size();
+            m_lines->cl().resize(ncl + totalNumVertices);
+            m_lines->el().resize(nel + (ncl + totalNumVertices) / 2 - ncl / 2);
+            auto cl = m_lines->cl().pin();
+            auto el = m_lines->el().pin();
             for (Index i = 0; i < totalNumVertices; ++i) {
-                cl.emplace_back(i);
-                if (cl.size() % 2 == 0)
-                    el.emplace_back(cl.size());
+                cl[ncl + i] = i;
+                if ((ncl + i + 1) % 2 == 0)
+                    el[nel++] = ncl + i + 1;
             }
         }
 
@@ -106,6 +106,8 @@ bool ShowGrid::compute()
                 auto iy = unstr->y().data();
                 auto iz = unstr->z().data();
                 const Index *icl = unstr->cl().data();
+                const auto itl = unstr->tl().pin();
+                const auto iel = unstr->el().pin();
 
                 Index begin = 0, end = unstr->getNumElements();
                 if (cellnrmin >= 0) {
@@ -119,7 +121,7 @@ bool ShowGrid::compute()
                     if (!showCell(index))
                         continue;
 
-                    auto type = unstr->tl()[index];
+                    auto type = itl[index];
                     const bool ghost = unstr->isGhost(index);
 
                     const bool show = ((showgho && ghost) || (shownor && !ghost));
@@ -145,7 +147,7 @@ bool ShowGrid::compute()
                         oz.push_back(p[2]);
                     }
 
-                    const Index begin = unstr->el()[index], end = unstr->el()[index + 1];
+                    const Index begin = iel[index], end = iel[index + 1];
                     switch (type) {
                     case UnstructuredGrid::QUAD:
                     case UnstructuredGrid::TRIANGLE:
@@ -315,6 +317,7 @@ bool ShowGrid::compute()
             } else if (auto poly = Polygons::as(grid)) {
                 if (showTypes[UnstructuredGrid::QUAD]) {
                     const Index *icl = poly->cl().data();
+                    const auto iel = poly->el().pin();
                     auto ix = poly->x().data();
                     auto iy = poly->y().data();
                     auto iz = poly->z().data();
@@ -333,7 +336,7 @@ bool ShowGrid::compute()
                         if (!show)
                             continue;
 
-                        const Index begin = poly->el()[index], end = poly->el()[index + 1];
+                        const Index begin = iel[index], end = iel[index + 1];
 
                         std::vector<Index> verts;
                         for (Index i = begin; i < end; ++i) {
@@ -503,6 +506,8 @@ bool ShowGrid::compute()
         } else {
             if (auto unstr = UnstructuredGrid::as(grid)) {
                 const Index *icl = unstr->cl().data();
+                const auto itl = unstr->tl().pin();
+                const auto iel = unstr->el().pin();
 
                 Index begin = 0, end = unstr->getNumElements();
                 if (cellnrmin >= 0) {
@@ -516,7 +521,7 @@ bool ShowGrid::compute()
                     if (!showCell(index))
                         continue;
 
-                    auto type = unstr->tl()[index];
+                    auto type = itl[index];
                     const bool ghost = unstr->isGhost(index);
 
                     const bool show = ((showgho && ghost) || (shownor && !ghost));
@@ -525,7 +530,7 @@ bool ShowGrid::compute()
                     if (!showTypes[type])
                         continue;
 
-                    const Index begin = unstr->el()[index], end = unstr->el()[index + 1];
+                    const Index begin = iel[index], end = iel[index + 1];
                     switch (type) {
                     case UnstructuredGrid::QUAD:
                     case UnstructuredGrid::TRIANGLE:
@@ -700,6 +705,7 @@ bool ShowGrid::compute()
             } else if (auto poly = Polygons::as(grid)) {
                 if (showTypes[UnstructuredGrid::QUAD]) {
                     const Index *icl = poly->cl().data();
+                    const auto iel = poly->el().pin();
 
                     Index begin = 0, end = poly->getNumElements();
                     if (cellnrmin >= 0)
@@ -715,7 +721,7 @@ bool ShowGrid::compute()
                         if (!show)
                             continue;
 
-                        const Index begin = poly->el()[index], end = poly->el()[index + 1];
+                        const Index begin = iel[index], end = iel[index + 1];
                         if (bars) {
                             for (Index i = begin; i < end; ++i) {
                                 ocl.push_back(icl[i]);
@@ -176,6 +176,10 @@ Tracer::Tracer(const std::string &name, int moduleID, mpi::communicator comm): M
     m_simplificationError =
         addFloatParameter("simplification_error", "tolerable relative error for result simplification", 3e-3);
 
+    // celltrees are keyed by grid contents and remain valid across executions
+    m_celltreeCache.setPersistent(true);
+    addResultCache(m_celltreeCache);
+
     updateInfo();
 }
 
@@ -248,6 +252,103 @@ void collectAttributes(std::map<std::string, std::string> &attrs, Meta &meta, vi
     meta.setRealTime(obj->getRealTime());
 }
 
+namespace {
+
+template<class Grid>
+std::string celltreeKey(typename Grid::const_ptr grid)
+{
+#ifndef NO_SHMEM
+    std::stringstream str;
+    str << grid->getType();
+    for (int c = 0; c < 3; ++c)
+        str << ":" << grid->d()->x[c]->computeContentHash();
+    return str.str();
+#else
+    return ResultCacheBase::identity(grid);
+#endif
+}
+
+// whether the celltree of cached can be used for grid, content hashes in keys might collide
+bool sameCelltreeInput(Object::const_ptr cached, Object::const_ptr grid)
+{
+    if (!cached)
+        return false;
+    if (cached == grid)
+        return true;
+#ifndef NO_SHMEM
+    auto sameCoords = [](const Coords *a, const Coords *b) {
+        for (int c = 0; c < 3; ++c) {
+            if (!a->d()->x[c]->sameContents(*b->d()->x[c]))
+                return false;
+        }
+        return true;
+    };
+    if (auto unstr = UnstructuredGrid::as(grid)) {
+        auto cunstr = UnstructuredGrid::as(cached);
+        return cunstr && sameCoords(unstr.get(), cunstr.get()) && unstr->d()->el->sameContents(*cunstr->d()->el) &&
+               unstr->d()->cl->sameContents(*cunstr->d()->cl);
+    }
+    if (auto str = StructuredGrid::as(grid)) {
+        auto cstr = StructuredGrid::as(cached);
+        if (!cstr)
+            return false;
+        for (int c = 0; c < 3; ++c) {
+            if (str->getNumDivisions(c) != cstr->getNumDivisions(c))
+                return false;
+        }
+        return sameCoords(str.get(), cstr.get());
+    }
+    return false;
+#else
+    // keys are object names
+    return true;
+#endif
+}
+
+} // namespace
+
+Celltree3::const_ptr Tracer::getCelltree(Object::const_ptr grid)
+{
+    std::string key;
+    const CelltreeInterface<3> *ctgrid = nullptr;
+    if (auto unstr = UnstructuredGrid::as(grid)) {
+        if (unstr->hasCelltree())
+            return unstr->getCelltree();
+        key = celltreeKey<UnstructuredGrid>(unstr);
+#ifndef NO_SHMEM
+        key += ":" + std::to_string(unstr->d()->el->computeContentHash());
+        key += ":" + std::to_string(unstr->d()->cl->computeContentHash());
+#endif
+        ctgrid = unstr.get();
+    } else if (auto str = StructuredGrid::as(grid)) {
+        if (str->hasCelltree())
+            return str->getCelltree();
+        key = celltreeKey<StructuredGrid>(str);
+        for (int c = 0; c < 3; ++c)
+            key += ":" + std::to_string(str->getNumDivisions(c));
+        ctgrid = str.get();
+    } else {
+        return nullptr;
+    }
+
+    // grids with identical contents - e.g. re-read or re-created with other parameters - share their celltree
+    CachedCelltree cached;
+    auto entry = m_celltreeCache.getOrLock(key, cached);
+    if (!entry) {
+        // identical identity, e.g. an input fed again, needs no comparison of contents,
+        // otherwise the grid is only compared if it is still around
+        if (cached.celltree &&
+            (cached.identity == ResultCacheBase::identity(grid) || sameCelltreeInput(cached.grid.lock(), grid)))
+            grid->addAttachment("celltree", cached.celltree);
+        return ctgrid->getCelltree();
+    }
+    cached.identity = ResultCacheBase::identity(grid);
+    cached.grid = grid;
+    cached.celltree = ctgrid->getCelltree();
+    m_celltreeCache.storeAndUnlock(entry, cached, ResultCacheBase::objectSize(cached.celltree));
+    return cached.celltree;
+}
+
 
 bool Tracer::compute()
 {
@@ -308,15 +409,10 @@ bool Tracer::compute()
 
     if (useCelltree) {
         std::string tname = std::to_string(id()) + "ct:" + name();
-        if (unstr) {
-            celltree[t + 1].emplace_back(std::async(std::launch::async, [tname, unstr]() -> Celltree3::const_ptr {
-                setThreadName(tname);
-                return unstr->getCelltree();
-            }));
-        } else if (auto str = StructuredGrid::as(grid)) {
-            celltree[t + 1].emplace_back(std::async(std::launch::async, [tname, str]() -> Celltree3::const_ptr {
+        if (unstr || StructuredGrid::as(grid)) {
+            celltree[t + 1].emplace_back(std::async(std::launch::async, [this, tname, grid]() -> Celltree3::const_ptr {
                 setThreadName(tname);
-                return str->getCelltree();
+                return getCelltree(grid);
             }));
         } else if (auto lg = LayerGrid::as(grid)) {
             celltree[t + 1].emplace_back(std::async(std::launch::async, [tname, lg]() -> Celltree3::const_ptr {
@@ -12,6 +12,7 @@
 #include <vistle/core/points.h>
 #include <vistle/core/celltree.h>
 #include <vistle/module/module.h>
+#include <vistle/module/resultcache.h>
 #include "Integrator.h"
 
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(TraceType,
@@ -40,9 +41,17 @@ private:
     bool reduce(int timestep) override;
     bool changeParameter(const vistle::Parameter *param) override;
     void updateInfo();
+    vistle::Celltree3::const_ptr getCelltree(vistle::Object::const_ptr grid);
 
     std::vector<std::vector<vistle::Object::const_ptr>> grid_in;
     std::vector<std::vector<std::future<vistle::Celltree3::const_ptr>>> celltree;
+    struct CachedCelltree {
+        // grid the celltree was built for, for verifying that grids with equal keys match, without keeping it alive
+        std::string identity;
+        std::weak_ptr<const vistle::Object> grid;
+        vistle::Celltree3::const_ptr celltree;
+    };
+    vistle::ResultCache<CachedCelltree> m_celltreeCache;
     std::vector<std::vector<vistle::Vec<vistle::Scalar, 3>::const_ptr>> data_in0;
     std::vector<std::vector<vistle::DataBase::const_ptr>> data_in[NumPorts];
     int data_dim[NumPorts];
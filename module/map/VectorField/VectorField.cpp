@@ -113,28 +113,27 @@ bool VectorField::compute()
     Index numPoints = numCoords;
     std::vector<Index> verts;
     if (!perElement) {
-        Index nconn = 0;
-        const Index *cl = nullptr;
-        if (auto tri = Triangles::as(split.geometry)) {
-            cl = tri->cl().data();
-            nconn = tri->cl().size();
-        } else if (auto quads = Quads::as(split.geometry)) {
-            cl = quads->cl().data();
-            nconn = quads->cl().size();
-        } else if (auto indexed = Indexed::as(split.geometry)) {
-            cl = indexed->cl().data();
-            nconn = indexed->cl().size();
-        }
-
-        if (cl && nconn > 0) {
-            indexed = true;
+        // collect unique vertices from connectivity list, with indices of the type they are stored with
+        auto collect = [&verts](const auto *cl, Index nconn) {
+            if (!cl || nconn == 0)
+                return false;
             verts.reserve(nconn);
             std::copy(cl, cl + nconn, std::back_inserter(verts));
             std::sort(verts.begin(), verts.end());
             auto end = std::unique(verts.begin(), verts.end());
             verts.resize(end - verts.begin());
-            numPoints = verts.size();
+            return true;
+        };
+        if (auto tri = Triangles::as(split.geometry)) {
+            indexed = tri->withIndices([&](const auto *cl) { return collect(cl, tri->getNumCorners()); });
+        } else if (auto quads = Quads::as(split.geometry)) {
+            indexed = quads->withIndices([&](const auto *cl) { return collect(cl, quads->getNumCorners()); });
+        } else if (auto idx = Indexed::as(split.geometry)) {
+            indexed = idx->withIndices(
+                [&](const auto *el, const auto *cl) { return collect(cl, idx->getNumCorners()); });
         }
+        if (indexed)
+            numPoints = verts.size();
     }
 
     Scalar minLen = m_range->getValue()[0];
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <vistle/util/buffer.h>
+#include <vistle/core/archives_compress.h>
+#include <vistle/core/archives.h>
+#include <vistle/core/archives_impl.h>
+
+using namespace vistle;
+
+namespace {
+
+const int Repetitions = 10;
+
+// connectivity of hexahedra in a structured grid of n^3 cells, as generated by Gendat
+std::vector<Index> hexConnectivity(Index n)
+{
+    const Index np = n + 1;
+    std::vector<Index> cl;
+    cl.reserve(size_t(n) * n * n * 8);
+    for (Index k = 0; k < n; ++k) {
+        for (Index j = 0; j < n; ++j) {
+            for (Index i = 0; i < n; ++i) {
+                const Index v = i + np * (j + np * k);
+                const Index off[8] = {0, 1, np + 1, np, np * np, np * np + 1, np * np + np + 1, np * np + np};
+                for (auto o: off)
+                    cl.push_back(v + o);
+            }
+        }
+    }
+    return cl;
+}
+
+// element list with a constant number of vertices per element
+std::vector<Index> elementList(Index numElem, Index verticesPerElement)
+{
+    std::vector<Index> el(numElem + 1);
+    for (Index e = 0; e <= numElem; ++e)
+        el[e] = e * verticesPerElement;
+    return el;
+}
+
+// face-based connectivity of polyhedral cells, vertices of faces are numbered in
+// the order of owner cells and shuffled locally as for OpenFOAM meshes read by ReadFOAM
+std::vector<Index> polyhedralConnectivity(Index numFaces, std::mt19937 &rng)
+{
+    std::vector<Index> cl;
+    std::uniform_int_distribution<int> jitter(-50, 50);
+    Index base = 0;
+    for (Index f = 0; f < numFaces; ++f) {
+        for (int v = 0; v < 4; ++v) {
+            int64_t idx = int64_t(base) + jitter(rng);
+            cl.push_back(Index(idx < 0 ? 0 : idx));
+        }
+        base += 1 + f % 3;
+    }
+    return cl;
+}
+
+template<typename T>
+std::vector<T> randomData(size_t n, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<uint64_t> dist;
+    std::vector<T> v(n);
+    for (auto &x: v)
+        x = T(dist(rng));
+    return v;
+}
+
+template<typename T>
+void roundTrip(const std::vector<T> &data, const std::string &name, bool mayFail = false)
+{
+    buffer compressed;
+    bool ok = detail::compressDeltaPack<T>(compressed, data.data(), data.size());
+    if (!ok) {
+        if (!mayFail) {
+            std::cerr << name << ": compression failed" << std::endl;
+            abort();
+        }
+        std::cerr << name << ": not compressible" << std::endl;
+        return;
+    }
+    std::vector<T> result(data.size());
+    if (!detail::decompressDeltaPack<T>(result.data(), result.size(), compressed) || result != data) {
+        std::cerr << name << ": round trip failed" << std::endl;
+        abort();
+    }
+}
+
+template<typename T>
+void archiveRoundTrip(const std::vector<T> &data, FieldCompressionMode integerMode, const std::string &name)
+{
+    CompressionSettings cs;
+    cs.integerMode = integerMode;
+
+    vecostreambuf<buffer> vb;
+    oarchive oar(vb);
+    oar.setCompressionSettings(cs);
+    std::vector<T> src(data);
+    oar &detail::wrap_array<oarchive>(src.data(), true, src.size());
+    const buffer &mem = vb.get_vector();
+
+    vecistreambuf<buffer> ib(mem);
+    iarchive iar(ib);
+    std::vector<T> result(data.size());
+    iar &detail::wrap_array<iarchive>(result.data(), true, result.size());
+    if (result != data) {
+        std::cerr << name << ": archive round trip with " << toString(integerMode) << " failed" << std::endl;
+        abort();
+    }
+    std::cerr << name << ": archived " << data.size() * sizeof(T) << " bytes with " << toString(integerMode)
+              << " in " << mem.size() << " bytes" << std::endl;
+}
+
+template<typename T>
+void benchmark(const std::vector<T> &data, const std::string &name)
+{
+    typedef std::chrono::steady_clock clock;
+    const double bytes = double(data.size() * sizeof(T)) * Repetitions;
+
+    buffer compressed;
+    auto start = clock::now();
+    for (int r = 0; r < Repetitions; ++r)
+        detail::compressDeltaPack<T>(compressed, data.data(), data.size());
+    double compTime = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::vector<T> result(data.size());
+    start = clock::now();
+    for (int r = 0; r < Repetitions; ++r)
+        detail::decompressDeltaPack<T>(result.data(), result.size(), compressed);
+    double decompTime = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::cerr << name << ": ratio " << double(data.size() * sizeof(T)) / compressed.size() << ", compression "
+              << bytes / compTime * 1e-6 << " MB/s, decompression " << bytes / decompTime * 1e-6 << " MB/s"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::mt19937 rng(4711);
+
+    // edge cases
+    roundTrip(std::vector<Index>(), "empty");
+    roundTrip(std::vector<Index>{42}, "single", true);
+    roundTrip(std::vector<Index>(1000, 7), "constant");
+    roundTrip(std::vector<int64_t>{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0, -1},
+              "extremes", true);
+    std::vector<int64_t> alternating;
+    for (int i = 0; i < 1000; ++i)
+        alternating.push_back(i % 2 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max());
+    roundTrip(alternating, "alternating extremes", true);
+
+    // all integer types of shm arrays
+    roundTrip(randomData<signed char>(1001, rng), "random signed char", true);
+    roundTrip(randomData<unsigned char>(1001, rng), "random unsigned char", true);
+    roundTrip(randomData<int32_t>(1001, rng), "random int32", true);
+    roundTrip(randomData<uint32_t>(1001, rng), "random uint32", true);
+    roundTrip(randomData<int64_t>(1001, rng), "random int64", true);
+    roundTrip(randomData<uint64_t>(1001, rng), "random uint64", true);
+    std::vector<char> ghost(100000);
+    for (size_t i = 0; i < ghost.size(); ++i)
+        ghost[i] = i % 1000 < 20;
+    roundTrip(ghost, "ghost flags");
+    std::vector<unsigned char> types(100000, 7);
+    roundTrip(types, "type list");
+
+    auto hex = hexConnectivity(64);
+    auto el = elementList(64 * 64 * 64, 8);
+    auto poly = polyhedralConnectivity(1000000, rng);
+    roundTrip(hex, "hexahedra connectivity");
+    roundTrip(el, "element list");
+    roundTrip(poly, "polyhedral connectivity");
+
+    archiveRoundTrip(hex, Uncompressed, "hexahedra connectivity");
+    archiveRoundTrip(hex, Predict, "hexahedra connectivity");
+    archiveRoundTrip(hex, DeltaPack, "hexahedra connectivity");
+    archiveRoundTrip(randomData<int32_t>(1001, rng), DeltaPack, "random int32");
+    std::cerr << "round trip tests succeeded" << std::endl;
+
+    benchmark(hex, "hexahedra connectivity");
+    benchmark(el, "element list");
+    benchmark(poly, "polyhedral connectivity");
+    benchmark(ghost, "ghost flags");
+
+    return 0;
+}
@@ -79,6 +79,7 @@ int main()
             M(FILEQUERY, FileQuery)
             M(FILEQUERYRESULT, FileQueryResult)
             M(COVER, Cover)
+            M(TRANSFERSTATISTICS, TransferStatistics)
             //M(INSITU, InSitu)
 
         default: {
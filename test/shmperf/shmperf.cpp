@@ -12,13 +12,17 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <thread>
+#include <chrono>
 
 #include <vistle/core/shm_array.h>
 #include <vistle/core/shm_array_impl.h>
 #include <vistle/core/shm.h>
+#include <vistle/core/shm_fill.h>
 #include <vistle/core/vec.h>
 
 #include <vistle/util/allocator.h>
+#include <vistle/util/taskpool.h>
 
 using namespace vistle;
 
@@ -85,6 +89,91 @@ void time_ptr(T *v, const std::string &tag, Index size)
     std::cerr << size << " " << tag << ": " << (double)elapsed / CLOCKS_PER_SEC << std::endl;
 }
 
+// allocate and free blocks of varying size from several threads concurrently, report allocations per second
+void time_alloc_threads(const std::string &tag, unsigned nthreads, Index count)
+{
+    const size_t live = 64;
+    auto work = [count, live]() {
+        vistle::shm<DataType>::allocator alloc(Shm::the().allocator());
+        std::vector<std::pair<vistle::shm<DataType>::allocator::pointer, size_t>> blocks(live);
+        for (Index i = 0; i < count; ++i) {
+            auto &b = blocks[i % live];
+            if (b.first)
+                alloc.deallocate(b.first, b.second);
+            b.second = 1 + (i * 37) % 2000;
+            b.first = alloc.allocate(b.second);
+            b.first[b.second - 1] = i;
+        }
+        for (auto &b: blocks) {
+            if (b.first)
+                alloc.deallocate(b.first, b.second);
+        }
+        ShmArena::release();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < nthreads; ++t)
+        threads.emplace_back(work);
+    for (auto &t: threads)
+        t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << nthreads << " threads " << tag << ": " << nthreads * count / elapsed.count() * 1e-6 << " M allocs/s"
+              << std::endl;
+}
+
+// create and destroy small arrays from several threads concurrently, their storage is allocated with alignment
+void time_array_threads(const std::string &tag, unsigned nthreads, Index count)
+{
+    auto work = [count]() {
+        vistle::shm<DataType>::allocator alloc(Shm::the().allocator());
+        for (Index i = 0; i < count; ++i) {
+            vistle::shm<DataType>::array a(1 + (i * 37) % 2000, alloc);
+            a[a.size() - 1] = i;
+        }
+        ShmArena::release();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < nthreads; ++t)
+        threads.emplace_back(work);
+    for (auto &t: threads)
+        t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << nthreads << " threads " << tag << ": " << nthreads * count / elapsed.count() * 1e-6 << " M arrays/s"
+              << std::endl;
+}
+
+// time parallel initialization of an array and a subsequent parallel pass over its elements,
+// on multi-socket machines the latter depends on whether pages have been first touched by the processing threads
+void time_fill(const std::string &tag, int nthreads, bool firstTouch, Index size)
+{
+    TaskPool::setThreadLimit(nthreads);
+    ShmFill::setFirstTouch(firstTouch);
+    auto v = Shm::the().shm().construct<vistle::shm<DataType>::array>("filltest")(0, Shm::the().allocator());
+
+    auto start = std::chrono::steady_clock::now();
+    if (firstTouch)
+        v->resize(size);
+    else
+        v->resize(size, DataType(1));
+    std::chrono::duration<double> init = std::chrono::steady_clock::now() - start;
+
+    DataType *p = v->data();
+    start = std::chrono::steady_clock::now();
+    ShmFill::forChunks(size, sizeof(DataType), [p](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            p[i] = DataType(i);
+    });
+    std::chrono::duration<double> process = std::chrono::steady_clock::now() - start;
+
+    std::cerr << size << " " << tag << " (" << TaskPool::the().concurrency() << " threads): init " << init.count()
+              << ", process " << process.count() << std::endl;
+    Shm::the().shm().destroy_ptr(v);
+    ShmFill::setFirstTouch(false);
+}
+
 template<typename T>
 static T min(T a, T b)
 {
@@ -212,6 +301,8 @@ int main(int argc, char *argv[])
         time_pb(v, "vistle explicit uninit reserved+push_back", size);
         time_arr(v, "vistle explicit uninit arr", size);
         time_ptr(&v[0], "vistle explicit uninit arr ptr", size);
+        auto pinned = v.pin();
+        time_arr(pinned, "vistle explicit uninit arr pinned", size);
 #ifdef TWICE
         time_arr(v, "vistle explicit uninit arr", size);
         time_ptr(&v[0], "vistle explicit arr ptr", size);
@@ -220,6 +311,44 @@ int main(int argc, char *argv[])
         vistle::Shm::remove(shmname, 1, 0, true);
     }
 
+    // fresh shared memory for each variant, so that no pages have been touched before
+    for (int variant = 0; variant < 3; ++variant) {
+        bi::shared_memory_object::remove(shmname.c_str());
+        vistle::Shm::create(shmname, 1, 0, true);
+        switch (variant) {
+        case 0:
+            time_fill("vistle fill serial", 1, false, size);
+            break;
+        case 1:
+            time_fill("vistle fill parallel", 0, false, size);
+            break;
+        case 2:
+            time_fill("vistle first touch parallel", 0, true, size);
+            break;
+        }
+        bi::shared_memory_object::remove(shmname.c_str());
+        vistle::Shm::remove(shmname, 1, 0, true);
+    }
+
+    {
+        bi::shared_memory_object::remove(shmname.c_str());
+        vistle::Shm::create(shmname, 1, 0, true);
+        const Index count = 1L << (shift - 4);
+        unsigned maxthreads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned nthreads = 1; nthreads <= maxthreads; nthreads *= 2) {
+            ShmArena::setEnabled(false);
+            time_alloc_threads("segment manager alloc", nthreads, count);
+            ShmArena::setEnabled(true);
+            time_alloc_threads("thread arena alloc", nthreads, count);
+            ShmArena::setEnabled(false);
+            time_array_threads("segment manager array", nthreads, count);
+            ShmArena::setEnabled(true);
+            time_array_threads("thread arena array", nthreads, count);
+        }
+        bi::shared_memory_object::remove(shmname.c_str());
+        vistle::Shm::remove(shmname, 1, 0, true);
+    }
+
 #if 0
    { 
       bi::shared_memory_object::remove(shmname.c_str());